@@ -19,6 +19,10 @@
 #include "gt-app.h"
 #include "gt-win.h"
 #include "gt-http-soup.h"
+#include "gt-http-replay.h"
+#include "gt-http-stats.h"
+#include "gt-cache-file.h"
+#include "gt-resource-downloader.h"
 #include "config.h"
 #include <glib/gi18n.h>
 #include <glib/gstdio.h>
@@ -32,6 +36,9 @@
 #define TAG "GtApp"
 #include "gnome-twitch/gt-log.h"
 
+/* NOTE: Decoded pixel bytes, a 320x180 preview is about 170KiB */
+#define IMAGE_CACHE_SIZE (64*1024*1024)
+
 struct _GtAppPrivate
 {
     GtWin* win;
@@ -51,6 +58,29 @@ struct _GtAppPrivate
 gint LOG_LEVEL = GT_LOG_LEVEL_MESSAGE;
 gboolean NO_FANCY_LOGGING = FALSE;
 gboolean VERSION = FALSE;
+gchar* HTTP_REPLAY_DIRECTORY = NULL;
+gint HTTP_REPLAY_LATENCY = 0;
+gint HTTP_REPLAY_BANDWIDTH = 0;
+gchar* HTTP_RECORD_DIRECTORY = NULL;
+gboolean DUMP_HTTP_STATS = FALSE;
+gboolean NO_PREWARM = FALSE;
+gboolean CACHE_STATS = FALSE;
+gboolean CACHE_COMPACT = FALSE;
+gboolean CACHE_COMPACT_DRY_RUN = FALSE;
+gboolean CACHE_VERIFY = FALSE;
+
+static gint64 start_time;
+
+/* NOTE: Hosts that are always needed soon after startup, opening a
+ * channel also needs the usher host */
+static const gchar* PREWARM_URIS[] =
+{
+    "https://api.twitch.tv",
+    "https://static-cdn.jtvnw.net",
+    "https://usher.ttvnw.net",
+    "http://usher.twitch.tv",
+    NULL
+};
 
 const gchar* TWITCH_AUTH_SCOPES[] =
 {
@@ -105,6 +135,16 @@ cli_options[] =
     {"log-level", 'l', G_OPTION_FLAG_NONE, G_OPTION_ARG_CALLBACK, set_log_level, "Set logging level", "level"},
     {"no-fancy-logging", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &NO_FANCY_LOGGING, "Don't print pretty log messages", NULL},
     {"version", 'v', G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &VERSION, "Display version", NULL},
+    {"http-replay", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &HTTP_REPLAY_DIRECTORY, "Serve HTTP requests from recorded responses in directory", "directory"},
+    {"http-replay-latency", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &HTTP_REPLAY_LATENCY, "Simulated latency when replaying", "milliseconds"},
+    {"http-replay-bandwidth", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &HTTP_REPLAY_BANDWIDTH, "Simulated bandwidth per request when replaying", "bytes per second"},
+    {"http-record", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &HTTP_RECORD_DIRECTORY, "Record HTTP responses to directory for replaying", "directory"},
+    {"dump-http-stats", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &DUMP_HTTP_STATS, "Print HTTP statistics on exit", NULL},
+    {"no-prewarm", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &NO_PREWARM, "Don't open connections before they are needed", NULL},
+    {"cache-stats", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &CACHE_STATS, "Print what the HTTP cache holds and exit", NULL},
+    {"cache-compact", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &CACHE_COMPACT, "Compact the HTTP cache index and exit", NULL},
+    {"cache-compact-dry-run", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &CACHE_COMPACT_DRY_RUN, "Print what compacting the HTTP cache index would do and exit", NULL},
+    {"cache-verify", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &CACHE_VERIFY, "Check the HTTP cache contents against its index and exit", NULL},
     {NULL}
 };
 
@@ -202,6 +242,75 @@ logged_in_cb(GObject* src,
     }
 }
 
+static void
+remove_directory(const gchar* path)
+{
+    g_autoptr(GDir) dir = g_dir_open(path, 0, NULL);
+    const gchar* name;
+
+    if (!dir)
+        return;
+
+    while ((name = g_dir_read_name(dir)) != NULL)
+    {
+        g_autofree gchar* child = g_build_filename(path, name, NULL);
+
+        if (g_file_test(child, G_FILE_TEST_IS_DIR) && !g_file_test(child, G_FILE_TEST_IS_SYMLINK))
+            remove_directory(child);
+        else if (g_remove(child) != 0)
+            WARNING("Unable to remove old cache file '%s' because: %s", child, g_strerror(errno));
+    }
+
+    if (g_rmdir(path) != 0)
+        WARNING("Unable to remove old cache directory '%s' because: %s", path, g_strerror(errno));
+}
+
+static void
+remove_legacy_cache_dirs_cb(GTask* task, gpointer source,
+    gpointer task_data, GCancellable* cancel)
+{
+    gchar** dirs = task_data;
+
+    for (gchar** dir = dirs; *dir != NULL; dir++)
+    {
+        remove_directory(*dir);
+
+        MESSAGE("Removed old cache directory '%s'", *dir);
+    }
+
+    g_task_return_boolean(task, TRUE);
+}
+
+/* NOTE: Emotes and badges used to be stored in directories of their
+ * own, they're in the shared cache now. Only there on the first start
+ * after upgrading, removed in a thread as they can be big. */
+static void
+remove_legacy_cache_dirs()
+{
+    const gchar* names[] = {"emotes", "badges"};
+    g_autoptr(GPtrArray) dirs = g_ptr_array_new();
+    g_autoptr(GTask) task = NULL;
+
+    for (guint i = 0; i < G_N_ELEMENTS(names); i++)
+    {
+        gchar* fp = g_build_filename(g_get_user_cache_dir(), "gnome-twitch", names[i], NULL);
+
+        if (g_file_test(fp, G_FILE_TEST_IS_DIR))
+            g_ptr_array_add(dirs, fp);
+        else
+            g_free(fp);
+    }
+
+    if (dirs->len == 0)
+        return;
+
+    g_ptr_array_add(dirs, NULL);
+
+    task = g_task_new(NULL, NULL, NULL, NULL);
+    g_task_set_task_data(task, g_ptr_array_free(g_steal_pointer(&dirs), FALSE), (GDestroyNotify) g_strfreev);
+    g_task_run_in_thread(task, remove_legacy_cache_dirs_cb);
+}
+
 /* FIXME: Move this into GtResourceDownloader */
 static inline void
 init_dirs()
@@ -227,17 +336,7 @@ init_dirs()
         WARNING("Error creating game cache directory");
     g_free(fp);
 
-    fp = g_build_filename(g_get_user_cache_dir(), "gnome-twitch", "emotes", NULL);
-    err = g_mkdir_with_parents(fp, 0777);
-    if (err != 0 && g_file_error_from_errno(errno) != G_FILE_ERROR_EXIST)
-        WARNING("Error creating game cache directory");
-    g_free(fp);
-
-    fp = g_build_filename(g_get_user_cache_dir(), "gnome-twitch", "badges", NULL);
-    err = g_mkdir_with_parents(fp, 0777);
-    if (err != 0 && g_file_error_from_errno(errno) != G_FILE_ERROR_EXIST)
-        WARNING("Error creating game cache directory");
-    g_free(fp);
+    remove_legacy_cache_dirs();
 }
 
 static void
@@ -312,6 +411,206 @@ quit_cb(GSimpleAction* action,
     g_application_quit(G_APPLICATION(self));
 }
 
+static void
+dump_http_stats(GtApp* self)
+{
+    g_autoptr(GVariant) stats = gt_http_get_stats(self->http);
+    g_autoptr(GVariant) downloader_stats = g_variant_ref_sink(gt_resource_downloader_get_stats());
+    g_autofree gchar* report = NULL;
+    g_autofree gchar* downloader_report = NULL;
+
+    if (!stats)
+    {
+        MESSAGE("HTTP backend doesn't keep any stats");
+        return;
+    }
+
+    g_variant_ref_sink(stats);
+
+    report = gt_http_stats_format_snapshot(stats);
+
+    MESSAGE("HTTP stats:\n%s", report);
+
+    downloader_report = gt_http_stats_format_snapshot(downloader_stats);
+
+    MESSAGE("Resource downloader stats:\n%s", downloader_report);
+
+    if (self->image_cache)
+    {
+        g_autoptr(GVariant) image_stats = g_variant_ref_sink(gt_image_cache_get_stats(self->image_cache));
+        g_autofree gchar* printed = g_variant_print(image_stats, FALSE);
+
+        MESSAGE("Image cache stats: %s", printed);
+    }
+}
+
+static void
+dump_http_stats_cb(GSimpleAction* action,
+    GVariant* par, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_APP(udata));
+
+    dump_http_stats(GT_APP(udata));
+}
+
+static void
+print_cache_groups(const gchar* title, GVariant* groups)
+{
+    GVariantIter iter;
+    const gchar* name;
+    guint64 count;
+    guint64 bytes;
+
+    g_print("%s:\n", title);
+
+    g_variant_iter_init(&iter, groups);
+    while (g_variant_iter_next(&iter, "{&s(tt)}", &name, &count, &bytes))
+    {
+        g_autofree gchar* size = g_format_size(bytes);
+
+        g_print("  %-40s %8" G_GUINT64_FORMAT " entries %12s\n", name, count, size);
+    }
+}
+
+static void
+print_cache_stats(GVariant* stats)
+{
+    g_autoptr(GVariant) categories = g_variant_lookup_value(stats, "categories", NULL);
+    g_autoptr(GVariant) hosts = g_variant_lookup_value(stats, "hosts", NULL);
+    g_autoptr(GVariant) ages = g_variant_lookup_value(stats, "ages", NULL);
+    g_autofree gchar* size = NULL;
+    g_autofree gchar* orphan_size = NULL;
+    GVariantIter iter;
+    const gchar* name;
+    guint64 entries = 0;
+    guint64 bytes = 0;
+    guint64 orphans = 0;
+    guint64 orphan_bytes = 0;
+    guint64 lookups;
+    guint64 hits;
+
+    g_variant_lookup(stats, "entries", "t", &entries);
+    g_variant_lookup(stats, "bytes", "t", &bytes);
+    g_variant_lookup(stats, "orphans", "t", &orphans);
+    g_variant_lookup(stats, "orphan-bytes", "t", &orphan_bytes);
+
+    size = g_format_size(bytes);
+    orphan_size = g_format_size(orphan_bytes);
+
+    g_print("Entries: %" G_GUINT64_FORMAT " (%s)\n", entries, size);
+    g_print("Orphaned files: %" G_GUINT64_FORMAT " (%s)\n", orphans, orphan_size);
+
+    if (g_variant_lookup(stats, "session-lookups", "t", &lookups) &&
+        g_variant_lookup(stats, "session-hits", "t", &hits) && lookups > 0)
+    {
+        g_print("Last session hit ratio: %.1f%% of %" G_GUINT64_FORMAT " lookups\n",
+            100.0 * hits / lookups, lookups);
+    }
+
+    print_cache_groups("Categories", categories);
+    print_cache_groups("Hosts", hosts);
+
+    g_print("Age:\n");
+
+    g_variant_iter_init(&iter, ages);
+    while (g_variant_iter_next(&iter, "(&stt)", &name, &entries, &bytes))
+    {
+        g_autofree gchar* age_size = g_format_size(bytes);
+
+        g_print("  %-40s %8" G_GUINT64_FORMAT " entries %12s\n", name, entries, age_size);
+    }
+}
+
+/* NOTE: Runs the cache maintenance options against the same
+ * GtCacheFile the app uses, without starting the app */
+static gint
+run_cache_tools()
+{
+    g_autoptr(GtCacheFile) cache = gt_cache_file_new();
+    gint ret = 0;
+
+    /* NOTE: A running instance keeps changes in memory and appends to
+     * the journal, rewriting the index under it would lose them */
+    if (gt_cache_file_is_read_only(cache))
+    {
+        if (CACHE_COMPACT)
+        {
+            g_printerr("The cache is in use by a running instance, not compacting it\n");
+            return 1;
+        }
+
+        g_printerr("Warning: The cache is in use by a running instance, the results may be out of date\n");
+    }
+
+    if (CACHE_STATS)
+    {
+        g_autoptr(GVariant) stats = g_variant_ref_sink(gt_cache_file_inspect(cache));
+
+        print_cache_stats(stats);
+    }
+
+    if (CACHE_VERIFY)
+    {
+        g_autoptr(GVariant) report = g_variant_ref_sink(gt_cache_file_verify(cache));
+        g_autoptr(GVariant) problems = g_variant_lookup_value(report, "problems", NULL);
+        guint64 checked = 0;
+        guint64 orphans = 0;
+        GVariantIter iter;
+        const gchar* key;
+        const gchar* reason;
+
+        g_variant_lookup(report, "checked", "t", &checked);
+        g_variant_lookup(report, "orphans", "t", &orphans);
+
+        g_variant_iter_init(&iter, problems);
+        while (g_variant_iter_next(&iter, "(&s&s)", &key, &reason))
+            g_print("%s: %s\n", reason, key);
+
+        g_print("Verified %" G_GUINT64_FORMAT " entries, %" G_GSIZE_FORMAT " problems, %" G_GUINT64_FORMAT " orphaned files\n",
+            checked, g_variant_n_children(problems), orphans);
+
+        if (g_variant_n_children(problems) > 0)
+            ret = 1;
+    }
+
+    if (CACHE_COMPACT || CACHE_COMPACT_DRY_RUN)
+    {
+        GVariant* report = gt_cache_file_compact(cache, !CACHE_COMPACT);
+        guint64 index_entries = 0;
+        guint64 index_bytes = 0;
+        guint64 journal_records = 0;
+        guint64 journal_bytes = 0;
+        guint64 live_entries = 0;
+        guint64 compacted_bytes = 0;
+
+        if (!report)
+        {
+            g_printerr("Unable to compact the cache index\n");
+            return 1;
+        }
+
+        g_variant_ref_sink(report);
+
+        g_variant_lookup(report, "index-entries", "t", &index_entries);
+        g_variant_lookup(report, "index-bytes", "t", &index_bytes);
+        g_variant_lookup(report, "journal-records", "t", &journal_records);
+        g_variant_lookup(report, "journal-bytes", "t", &journal_bytes);
+        g_variant_lookup(report, "live-entries", "t", &live_entries);
+
+        g_print("Index: %" G_GUINT64_FORMAT " entries, %" G_GUINT64_FORMAT " bytes\n", index_entries, index_bytes);
+        g_print("Journal: %" G_GUINT64_FORMAT " records, %" G_GUINT64_FORMAT " bytes\n", journal_records, journal_bytes);
+
+        if (g_variant_lookup(report, "compacted-index-bytes", "t", &compacted_bytes))
+            g_print("Compacted to %" G_GUINT64_FORMAT " entries, %" G_GUINT64_FORMAT " bytes\n", live_entries, compacted_bytes);
+        else
+            g_print("Compacting would leave %" G_GUINT64_FORMAT " entries\n", live_entries);
+
+        g_variant_unref(report);
+    }
+
+    return ret;
+}
+
 static gint
 handle_command_line_cb(GApplication* self,
     GVariantDict* options, gpointer udata)
@@ -322,15 +621,44 @@ handle_command_line_cb(GApplication* self,
         return 0;
     }
 
+    if (CACHE_STATS || CACHE_COMPACT || CACHE_COMPACT_DRY_RUN || CACHE_VERIFY)
+        return run_cache_tools();
+
     return -1;
 }
 
 static GActionEntry app_actions[] =
 {
     {"open-channel-from-id", open_channel_from_id_cb, "s", NULL, NULL},
+    {"dump-http-stats", dump_http_stats_cb, NULL, NULL, NULL},
     {"quit", quit_cb, NULL, NULL, NULL}
 };
 
+static gboolean
+first_draw_cb(GtkWidget* widget,
+    cairo_t* cr, gpointer udata)
+{
+    GtApp* self = GT_APP(udata);
+
+    MESSAGE("First paint after '%.2f' ms", (g_get_monotonic_time() - start_time) / 1000.0);
+
+    /* NOTE: The cache index loads in the background, this is how much
+     * of the above was spent waiting on it */
+    if (GT_IS_CACHE_FILE(self->cache))
+    {
+        g_autoptr(GVariant) stats = g_variant_ref_sink(gt_cache_file_get_stats(GT_CACHE_FILE(self->cache)));
+        gint64 wait_time = 0;
+
+        g_variant_lookup(stats, "load-main-wait-time", "x", &wait_time);
+
+        MESSAGE("Waited '%.2f' ms for the cache index before first paint", wait_time / 1000.0);
+    }
+
+    g_signal_handlers_disconnect_by_func(widget, first_draw_cb, udata);
+
+    return FALSE;
+}
+
 static void
 activate(GApplication* app)
 {
@@ -343,6 +671,8 @@ activate(GApplication* app)
 
     priv->win = gt_win_new(self);
 
+    g_signal_connect(priv->win, "draw", G_CALLBACK(first_draw_cb), self);
+
     gtk_window_present(GTK_WINDOW(priv->win));
 }
 
@@ -372,6 +702,65 @@ startup(GApplication* app)
 
     MESSAGE("Startup, running version '%s'", GT_VERSION);
 
+    /* NOTE: Shared by the HTTP client and the image downloaders so
+     * identical content is only stored once */
+    self->cache = GT_CACHE(gt_cache_file_new());
+
+    /* NOTE: Created here instead of in init so that the command line
+     * options have been parsed */
+    if (HTTP_REPLAY_DIRECTORY)
+    {
+        MESSAGE("Replaying HTTP responses from '%s'", HTTP_REPLAY_DIRECTORY);
+
+        self->http = GT_HTTP(gt_http_replay_new(HTTP_REPLAY_DIRECTORY));
+
+        g_object_set(self->http,
+            "latency", MAX(HTTP_REPLAY_LATENCY, 0),
+            "bandwidth", MAX(HTTP_REPLAY_BANDWIDTH, 0),
+            NULL);
+    }
+    else
+    {
+        self->http = g_object_new(GT_TYPE_HTTP_SOUP, "cache", self->cache, NULL);
+
+        /* NOTE: Previews come from a CDN where the odd connection
+         * stalls, hedge them so a grid doesn't wait on the slowest one */
+        gt_http_soup_set_category_policy(GT_HTTP_SOUP(self->http), "gt-channel", 10000, 2, TRUE);
+        gt_http_soup_set_category_policy(GT_HTTP_SOUP(self->http), "gt-game", 10000, 2, TRUE);
+        gt_http_soup_set_category_policy(GT_HTTP_SOUP(self->http), "gt-vod", 10000, 2, TRUE);
+
+        /* NOTE: Previews and follow polling can wait while a stream is
+         * playing, the periodic channel refresh can wait until it stops */
+        gt_http_soup_set_category_priority(GT_HTTP_SOUP(self->http), "gt-channel", GT_HTTP_SOUP_PRIORITY_LOW);
+        gt_http_soup_set_category_priority(GT_HTTP_SOUP(self->http), "gt-game", GT_HTTP_SOUP_PRIORITY_LOW);
+        gt_http_soup_set_category_priority(GT_HTTP_SOUP(self->http), "gt-vod", GT_HTTP_SOUP_PRIORITY_LOW);
+        gt_http_soup_set_category_priority(GT_HTTP_SOUP(self->http), "gt-follows-manager", GT_HTTP_SOUP_PRIORITY_LOW);
+        gt_http_soup_set_category_priority(GT_HTTP_SOUP(self->http), "gt-channel-auto-update", GT_HTTP_SOUP_PRIORITY_IDLE);
+
+        if (HTTP_RECORD_DIRECTORY)
+        {
+            MESSAGE("Recording HTTP responses to '%s'", HTTP_RECORD_DIRECTORY);
+
+            g_object_set(self->http, "record-directory", HTTP_RECORD_DIRECTORY, NULL);
+        }
+    }
+
+    /* NOTE: Done before anything else so the connections are being
+     * set up while the window is constructed */
+    if (!NO_PREWARM)
+    {
+        for (const gchar** uri = PREWARM_URIS; *uri != NULL; uri++)
+            gt_http_prewarm(self->http, *uri);
+    }
+
+    self->image_cache = gt_image_cache_new(IMAGE_CACHE_SIZE);
+
+    /* NOTE: Periodic refreshes go through this so they are spread out
+     * and stop while the window is hidden */
+    self->scheduler = gt_scheduler_new();
+
+    self->hydration_queue = gt_hydration_queue_new();
+
     self->fav_mgr = gt_follows_manager_new();
     self->twitch = gt_twitch_new();
 
@@ -417,6 +806,9 @@ shutdown(GApplication* app)
     if (!gt_app_is_logged_in(self))
         gt_follows_manager_save(self->fav_mgr);
 
+    if (DUMP_HTTP_STATS)
+        dump_http_stats(self);
+
     G_APPLICATION_CLASS(gt_app_parent_class)->shutdown(app);
 }
 
@@ -430,7 +822,11 @@ dispose(GObject* object)
 
     g_hash_table_unref(priv->soup_inflight_table);
     g_queue_free_full(priv->soup_message_queue, g_object_unref);
-    g_object_unref(self->http);
+    g_clear_object(&self->http);
+    g_clear_object(&self->cache);
+    g_clear_object(&self->image_cache);
+    g_clear_object(&self->scheduler);
+    g_clear_object(&self->hydration_queue);
 
     G_OBJECT_CLASS(gt_app_parent_class)->dispose(object);
 }
@@ -501,6 +897,8 @@ gt_app_init(GtApp* self)
 {
     GtAppPrivate* priv = gt_app_get_instance_private(self);
 
+    start_time = g_get_monotonic_time();
+
     priv->oauth_info = gt_oauth_info_new();
     priv->soup_inflight_table = g_hash_table_new(g_str_hash, g_str_equal);
     priv->soup_message_queue = g_queue_new();
@@ -511,7 +909,6 @@ gt_app_init(GtApp* self)
     self->players_engine = peas_engine_get_default();
     peas_engine_enable_loader(self->players_engine, "python3");
     self->soup = soup_session_new();
-    self->http = GT_HTTP(gt_http_soup_new());
 
     gchar* plugin_dir;
 
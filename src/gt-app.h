@@ -32,6 +32,10 @@ G_DECLARE_FINAL_TYPE(GtApp, gt_app, GT, APP, GtkApplication)
 #include "gt-follows-manager.h"
 #include "gt-irc.h"
 #include "gt-http.h"
+#include "gt-cache.h"
+#include "gt-image-cache.h"
+#include "gt-scheduler.h"
+#include "gt-hydration-queue.h"
 
 typedef struct
 {
@@ -85,6 +89,14 @@ struct _GtApp
     SoupSession* soup;
 
     GtHTTP* http;
+
+    GtCache* cache;
+
+    GtImageCache* image_cache;
+
+    GtScheduler* scheduler;
+
+    GtHydrationQueue* hydration_queue;
 };
 
 typedef struct
@@ -21,11 +21,20 @@
 #include "utils.h"
 #include <glib/gi18n.h>
 #include <json-glib/json-glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/file.h>
 
 #define TAG "GtCacheFile"
 #include "gnome-twitch/gt-log.h"
 
-#define DB_FILENAME "cache.json"
+#define LEGACY_DB_FILENAME "cache.json"
+#define INDEX_FILENAME "cache.idx"
+#define JOURNAL_FILENAME "cache.journal"
+#define SESSION_STATS_FILENAME "cache.stats"
 
 #define KEY_MEMBER_NAME "key"
 #define ID_MEMBER_NAME "id"
@@ -33,21 +42,178 @@
 #define EXPIRY_MEMBER_NAME "expiry"
 #define ETAG_MEMBER_NAME "etag"
 
+#define INDEX_MAGIC "GTCI"
+#define INDEX_VERSION 2
+#define INDEX_MIN_SLOTS 16
+#define NO_STRING G_MAXUINT32
+
+/* NOTE: The journal is folded into the index once it has this many
+ * records and is at least half the size of the index */
+#define COMPACT_MIN_RECORDS 512
+
+#define DEFAULT_MAX_SIZE (512*1024*1024)
+
+/* NOTE: The sweeper runs a while after startup and then periodically,
+ * or sooner when the cache grows past its budget. It runs on the
+ * writer thread and removes entries in small batches so it never
+ * holds the lock for long. */
+#define SWEEP_STARTUP_DELAY (60*1000)
+#define SWEEP_INTERVAL (10*60*1000)
+#define SWEEP_BATCH_SIZE 32
+#define SWEEP_RETRY_INTERVAL 200
+
+/* NOTE: Entries that have been hit since they were stored are
+ * protected, protected entries may take up this much of the budget
+ * before the least recently used ones are demoted back to probation */
+#define PROTECTED_RATIO 0.8
+
+/* NOTE: Sweep down to this much of the budget so we don't have to
+ * sweep again after every save */
+#define SWEEP_LOW_WATERMARK 0.9
+
+/* NOTE: Content is stored under the hex SHA256 of the data, sharded
+ * two levels deep on its first four digits. Entries from before that
+ * are named by a uuid and live directly in the cache directory. */
+#define CONTENT_HASH_LENGTH 64
+
+/* NOTE: Content waiting for the writer thread may take up this much
+ * memory, saves beyond that aren't cached */
+#define DEFAULT_MAX_PENDING_SIZE (16*1024*1024)
+
+/* NOTE: The index is loaded in a thread during startup, lookups wait
+ * this long for it before they're treated as misses */
+#define LOAD_WAIT_TIMEOUT (50*G_TIME_SPAN_MILLISECOND)
+
+/* NOTE: On disk the cache is an index file and a journal. The index
+ * is an open addressing hash table of fixed size records followed by
+ * a string table, it's mmap'd as is so startup doesn't depend on the
+ * number of entries. Every change is appended to the journal, which
+ * is replayed into the in memory overlay on startup and periodically
+ * compacted into a new index. Everything is little endian. */
+typedef struct
+{
+    gchar magic[4];
+    guint32 version;
+    guint32 n_entries;
+    guint32 n_slots;
+    guint64 strings_size;
+    guint64 reserved;
+} GtCacheFileIndexHeader;
+
+typedef struct
+{
+    guint32 hash;
+    guint32 key_offset; /* NOTE: NO_STRING marks an empty slot */
+    guint32 id_offset;
+    guint32 etag_offset;
+    gint64 created;
+    gint64 expiry;
+    gint64 accessed;
+    guint64 size;
+    guint32 hits;
+    guint32 reserved[3];
+} GtCacheFileIndexRecord;
+
+G_STATIC_ASSERT(sizeof(GtCacheFileIndexHeader) == 32);
+G_STATIC_ASSERT(sizeof(GtCacheFileIndexRecord) == 64);
+
+/* NOTE: A journal record is a 32 bit length followed by the op, the
+ * created, expiry and access times, the size, the hit count and the
+ * NUL terminated key, id and etag */
+typedef enum
+{
+    JOURNAL_OP_UPSERT = 1,
+    JOURNAL_OP_DELETE = 2,
+} GtCacheFileJournalOp;
+
+#define JOURNAL_RECORD_HEADER_SIZE (sizeof(guint8) + 4*sizeof(gint64) + sizeof(guint32))
+
 typedef struct
 {
     GCancellable* cancel;
-    GHashTable* db;
+    GHashTable* db; /* NOTE: Overlay on top of the index */
+
+    GMappedFile* index;
+    const GtCacheFileIndexRecord* index_slots;
+    const gchar* index_strings;
+    guint32 index_n_slots;
+    guint32 index_n_entries;
+    guint64 index_strings_size;
+
+    GOutputStream* journal;
+    guint journal_records;
+
+    /* NOTE: Compaction runs on the writer thread, the keys journaled
+     * while it's writing are put back in the new journal */
+    gboolean compact_requested;
+    gboolean compacting;
+    GHashTable* compact_dirty;
+
+    guint64 max_size;
+    guint64 size; /* NOTE: As of the last sweep plus what's been saved since */
+    guint64 num_entries; /* NOTE: As of the last sweep */
+    guint sweep_source_id;
+    gboolean sweep_requested; /* NOTE: The sweep runs on the writer thread */
+    gboolean sweeping;
+    gint64 sweep_time;
+    guint64 evicted_entries;
+    guint64 evicted_bytes;
+
+    /* NOTE: Number of entries referring to each content id, only
+     * known once a sweep has counted them */
+    GHashTable* content_refs;
+    gboolean content_refs_valid;
+    gboolean orphans_collected;
+
+    /* NOTE: Content not yet on disk, written in order by a single
+     * writer thread. Readers are served from here until it is. */
+    GHashTable* pending; /* NOTE: Content id to GBytes */
+    GQueue* pending_queue;
+    guint64 pending_size;
+    guint64 max_pending_size;
+    guint64 coalesced_writes;
+    guint64 dropped_writes;
+    GtCacheFileDurability durability;
+    GThread* writer;
+    GCond writer_cond;
+    gboolean writer_quit;
+
+    /* NOTE: Nothing but the loader touches the db until this is set */
+    gboolean loaded;
+    GCond loaded_cond;
+    gint64 load_time;
+    gint64 load_main_wait_time; /* NOTE: Time the main thread spent waiting on the load */
+    guint64 load_misses;
+
+    /* NOTE: Staleness checks this session, kept for --cache-stats */
+    guint64 session_lookups;
+    guint64 session_hits;
+
+    /* NOTE: Guards everything above, the resource downloaders use the
+     * cache from their worker threads */
+    GMutex mutex;
 
     gchar* cache_directory;
+
+    /* NOTE: An flock on the cache directory, the cache tools can run
+     * while the app has the cache open. Whoever doesn't get it only
+     * reads, they never write the journal, the index or content. */
+    gint lock_fd;
+    gboolean read_only;
 } GtCacheFilePrivate;
 
 typedef struct
 {
     gchar* id;
     gchar* key;
-    GDateTime* created;
-    GDateTime* expiry;
+    gint64 created;
+    gint64 expiry;
+    gint64 accessed;
+    guint64 size;
+    guint32 hits;
     gchar* etag;
+    gboolean deleted;
+    gboolean touched; /* NOTE: Accessed since it was last journaled */
 } GtCacheFileEntry;
 
 static void gt_cache_iface_init(GtCacheInterface* iface);
@@ -60,338 +226,2238 @@ enum
 {
     PROP_0,
     PROP_CACHE_DIRECTORY,
+    PROP_MAX_SIZE,
+    PROP_SIZE,
+    PROP_EVICTED_ENTRIES,
+    PROP_EVICTED_BYTES,
+    PROP_MAX_PENDING_SIZE,
+    PROP_DURABILITY,
     NUM_PROPS,
 };
 
 static GParamSpec* props[NUM_PROPS];
 
-static GtCacheFileEntry*
-gt_cache_file_entry_new()
-{
-    GtCacheFileEntry* entry = g_slice_new0(GtCacheFileEntry);
+static const GEnumValue gt_cache_file_durability_enum_values[] =
+{
+    {GT_CACHE_FILE_DURABILITY_NONE, "GT_CACHE_FILE_DURABILITY_NONE", "none"},
+    {GT_CACHE_FILE_DURABILITY_ATOMIC, "GT_CACHE_FILE_DURABILITY_ATOMIC", "atomic"},
+    {GT_CACHE_FILE_DURABILITY_SYNC, "GT_CACHE_FILE_DURABILITY_SYNC", "sync"},
+    {0, NULL, NULL},
+};
+
+GType
+gt_cache_file_durability_get_type()
+{
+    static GType type = 0;
+
+    if (!type)
+        type = g_enum_register_static("GtCacheFileDurability", gt_cache_file_durability_enum_values);
+
+    return type;
+}
+
+static GtCacheFileEntry*
+gt_cache_file_entry_new()
+{
+    return g_slice_new0(GtCacheFileEntry);
+}
+
+static GtCacheFileEntry*
+gt_cache_file_entry_new_with_params(const gchar* key, const gchar* id, gsize size, GDateTime* expiry, const gchar* etag)
+{
+    GtCacheFileEntry* entry = gt_cache_file_entry_new();
+
+    entry->id = g_strdup(id);
+    entry->key = g_strdup(key);
+    entry->created = g_get_real_time() / G_USEC_PER_SEC;
+    entry->expiry = expiry ? g_date_time_to_unix(expiry) : 0;
+    entry->accessed = entry->created;
+    entry->size = size;
+    entry->etag = g_strdup(etag);
+
+    return entry;
+}
+
+static void
+gt_cache_file_entry_update(GtCacheFileEntry* entry, const gchar* id, gsize size, GDateTime* expiry, const gchar* etag)
+{
+    RETURN_IF_FAIL(entry != NULL);
+
+    g_free(entry->id);
+    g_free(entry->etag);
+
+    entry->id = g_strdup(id);
+    entry->created = g_get_real_time() / G_USEC_PER_SEC;
+    entry->expiry = expiry ? g_date_time_to_unix(expiry) : 0;
+    entry->accessed = entry->created;
+    entry->size = size;
+    entry->etag = g_strdup(etag);
+}
+
+static void
+gt_cache_file_entry_free(GtCacheFileEntry* entry)
+{
+    if (!entry) return;
+
+    g_free(entry->id);
+    g_free(entry->key);
+    g_free(entry->etag);
+    g_slice_free(GtCacheFileEntry, entry);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtCacheFileEntry, gt_cache_file_entry_free)
+
+typedef struct
+{
+    const gchar* key;
+    gint64 accessed;
+    guint64 size;
+    gboolean protected;
+} GtCacheFileSweepCandidate;
+
+/* NOTE: FNV-1a, this ends up on disk so it can't be g_str_hash */
+static guint32
+hash_key(const gchar* key)
+{
+    guint32 hash = 2166136261u;
+
+    for (const guchar* p = (const guchar*) key; *p; p++)
+    {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static gchar*
+content_path(GtCacheFilePrivate* priv, const gchar* id)
+{
+    g_autofree gchar* first = NULL;
+    g_autofree gchar* second = NULL;
+
+    if (strlen(id) != CONTENT_HASH_LENGTH)
+        return g_build_filename(priv->cache_directory, id, NULL);
+
+    first = g_strndup(id, 2);
+    second = g_strndup(id + 2, 2);
+
+    return g_build_filename(priv->cache_directory, first, second, id, NULL);
+}
+
+static void
+ref_content(GtCacheFile* self, const gchar* id)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    guint count;
+
+    if (!priv->content_refs_valid)
+        return;
+
+    count = GPOINTER_TO_UINT(g_hash_table_lookup(priv->content_refs, id));
+
+    g_hash_table_insert(priv->content_refs, g_strdup(id), GUINT_TO_POINTER(count + 1));
+}
+
+/* NOTE: Deletes the content once no entry refers to it. Until a sweep
+ * has counted the references we can't tell, so the file is left for
+ * the orphan collection to pick up. If deferred is given the file is
+ * added to it instead, for the caller to delete without the lock. */
+static void
+unref_content(GtCacheFile* self, const gchar* id, GPtrArray* deferred)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autofree gchar* filename = NULL;
+    g_autoptr(GFile) file = NULL;
+    g_autoptr(GError) err = NULL;
+    guint count;
+
+    if (!priv->content_refs_valid)
+        return;
+
+    count = GPOINTER_TO_UINT(g_hash_table_lookup(priv->content_refs, id));
+
+    if (count > 1)
+    {
+        g_hash_table_insert(priv->content_refs, g_strdup(id), GUINT_TO_POINTER(count - 1));
+        return;
+    }
+
+    g_hash_table_remove(priv->content_refs, id);
+
+    /* NOTE: Never made it to disk, the writer skips it once it's gone */
+    if (g_hash_table_contains(priv->pending, id))
+    {
+        GBytes* bytes = g_hash_table_lookup(priv->pending, id);
+
+        priv->pending_size -= g_bytes_get_size(bytes);
+        g_hash_table_remove(priv->pending, id);
+
+        return;
+    }
+
+    filename = content_path(priv, id);
+
+    if (deferred)
+    {
+        g_ptr_array_add(deferred, g_steal_pointer(&filename));
+        return;
+    }
+
+    file = g_file_new_for_path(filename);
+
+    if (!g_file_delete(file, NULL, &err) && !g_error_matches(err, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+        WARNING("Unable to delete cache file '%s' because: %s", filename, err->message);
+}
+
+static const gchar*
+index_string(GtCacheFilePrivate* priv, guint32 offset)
+{
+    offset = GUINT32_FROM_LE(offset);
+
+    if (offset == NO_STRING || offset >= priv->index_strings_size)
+        return NULL;
+
+    return priv->index_strings + offset;
+}
+
+static const GtCacheFileIndexRecord*
+index_lookup(GtCacheFilePrivate* priv, const gchar* key)
+{
+    if (!priv->index)
+        return NULL;
+
+    guint32 hash = hash_key(key);
+    guint32 mask = priv->index_n_slots - 1;
+
+    for (guint32 i = hash & mask, probes = 0; probes < priv->index_n_slots; i = (i + 1) & mask, probes++)
+    {
+        const GtCacheFileIndexRecord* record = &priv->index_slots[i];
+
+        if (GUINT32_FROM_LE(record->key_offset) == NO_STRING)
+            return NULL;
+
+        if (GUINT32_FROM_LE(record->hash) == hash
+            && g_strcmp0(index_string(priv, record->key_offset), key) == 0)
+        {
+            return record;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+unmap_index(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_clear_pointer(&priv->index, g_mapped_file_unref);
+
+    priv->index_slots = NULL;
+    priv->index_strings = NULL;
+    priv->index_n_slots = 0;
+    priv->index_n_entries = 0;
+    priv->index_strings_size = 0;
+}
+
+static void
+map_index(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autofree gchar* filename = g_build_filename(priv->cache_directory, INDEX_FILENAME, NULL);
+    g_autoptr(GMappedFile) index = NULL;
+    g_autoptr(GError) err = NULL;
+    const GtCacheFileIndexHeader* header;
+    const gchar* contents;
+    gsize length;
+    guint32 n_slots;
+    guint64 strings_size;
+
+    unmap_index(self);
+
+    if (!g_file_test(filename, G_FILE_TEST_EXISTS))
+    {
+        INFO("No cache index file at '%s'", filename);
+        return;
+    }
+
+    index = g_mapped_file_new(filename, FALSE, &err);
+
+    if (err)
+    {
+        WARNING("Unable to map cache index at '%s' because: %s", filename, err->message);
+        return;
+    }
+
+    contents = g_mapped_file_get_contents(index);
+    length = g_mapped_file_get_length(index);
+    header = (const GtCacheFileIndexHeader*) contents;
+
+    if (length < sizeof(GtCacheFileIndexHeader)
+        || memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0
+        || GUINT32_FROM_LE(header->version) != INDEX_VERSION)
+    {
+        WARNING("Cache index at '%s' has an unknown format, ignoring it", filename);
+        return;
+    }
+
+    n_slots = GUINT32_FROM_LE(header->n_slots);
+    strings_size = GUINT64_FROM_LE(header->strings_size);
+
+    if (n_slots == 0 || (n_slots & (n_slots - 1)) != 0
+        || strings_size == 0 || strings_size > NO_STRING
+        || length != sizeof(GtCacheFileIndexHeader) + (guint64) n_slots*sizeof(GtCacheFileIndexRecord) + strings_size
+        || contents[length - 1] != '\0')
+    {
+        WARNING("Cache index at '%s' is corrupt, ignoring it", filename);
+        return;
+    }
+
+    priv->index = g_steal_pointer(&index);
+    priv->index_slots = (const GtCacheFileIndexRecord*) (contents + sizeof(GtCacheFileIndexHeader));
+    priv->index_strings = contents + sizeof(GtCacheFileIndexHeader) + n_slots*sizeof(GtCacheFileIndexRecord);
+    priv->index_n_slots = n_slots;
+    priv->index_n_entries = GUINT32_FROM_LE(header->n_entries);
+    priv->index_strings_size = strings_size;
+
+    MESSAGE("Mapped '%d' cache entries from index", priv->index_n_entries);
+}
+
+/* NOTE: Call with the lock held. Returns FALSE if the index still
+ * isn't loaded after a short wait. */
+static gboolean
+wait_loaded(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    gint64 start;
+    gint64 deadline;
+
+    if (priv->loaded)
+        return TRUE;
+
+    start = g_get_monotonic_time();
+    deadline = start + LOAD_WAIT_TIMEOUT;
+
+    while (!priv->loaded)
+    {
+        if (!g_cond_wait_until(&priv->loaded_cond, &priv->mutex, deadline))
+            break;
+    }
+
+    if (g_main_context_is_owner(g_main_context_default()))
+        priv->load_main_wait_time += g_get_monotonic_time() - start;
+
+    if (!priv->loaded)
+    {
+        DEBUG("Cache index not loaded yet, treating lookup as a miss");
+        priv->load_misses++;
+    }
+
+    return priv->loaded;
+}
+
+/* NOTE: Call with the lock held, for callers that can't do anything
+ * useful without the index */
+static void
+block_until_loaded(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    while (!priv->loaded)
+        g_cond_wait(&priv->loaded_cond, &priv->mutex);
+}
+
+/* NOTE: Looks in the overlay first and faults entries in from the
+ * index on demand. The returned entry is owned by the overlay. */
+static GtCacheFileEntry*
+lookup_entry(GtCacheFile* self, const gchar* key)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    GtCacheFileEntry* entry = g_hash_table_lookup(priv->db, key);
+    const GtCacheFileIndexRecord* record;
+    const gchar* id;
+
+    if (entry)
+        return entry->deleted ? NULL : entry;
+
+    if ((record = index_lookup(priv, key)) == NULL)
+        return NULL;
+
+    if ((id = index_string(priv, record->id_offset)) == NULL)
+        return NULL;
+
+    entry = gt_cache_file_entry_new();
+    entry->key = g_strdup(key);
+    entry->id = g_strdup(id);
+    entry->etag = g_strdup(index_string(priv, record->etag_offset));
+    entry->created = GINT64_FROM_LE(record->created);
+    entry->expiry = GINT64_FROM_LE(record->expiry);
+    entry->accessed = GINT64_FROM_LE(record->accessed);
+    entry->size = GUINT64_FROM_LE(record->size);
+    entry->hits = GUINT32_FROM_LE(record->hits);
+
+    g_hash_table_insert(priv->db, g_strdup(key), entry);
+
+    return entry;
+}
+
+static gboolean
+should_compact(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    return priv->journal_records >= COMPACT_MIN_RECORDS
+        && priv->journal_records >= priv->index_n_entries / 2;
+}
+
+static void
+open_journal(GtCacheFile* self, gboolean truncate)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autofree gchar* filename = g_build_filename(priv->cache_directory, JOURNAL_FILENAME, NULL);
+    g_autoptr(GFile) file = g_file_new_for_path(filename);
+    g_autoptr(GError) err = NULL;
+
+    g_clear_object(&priv->journal);
+
+    if (truncate)
+    {
+        priv->journal = G_OUTPUT_STREAM(g_file_replace(file, NULL, FALSE,
+                G_FILE_CREATE_NONE, NULL, &err));
+        priv->journal_records = 0;
+    }
+    else
+        priv->journal = G_OUTPUT_STREAM(g_file_append_to(file, G_FILE_CREATE_NONE, NULL, &err));
+
+    if (err)
+        WARNING("Unable to open cache journal at '%s' because: %s", filename, err->message);
+}
+
+/* NOTE: Replays the journal into the overlay, returns FALSE if it
+ * had a torn or corrupt record and needs to be rewritten */
+static gboolean
+replay_journal(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autofree gchar* filename = g_build_filename(priv->cache_directory, JOURNAL_FILENAME, NULL);
+    g_autofree gchar* contents = NULL;
+    g_autoptr(GError) err = NULL;
+    gsize length;
+    gsize pos = 0;
+
+    if (!g_file_test(filename, G_FILE_TEST_EXISTS))
+        return TRUE;
+
+    g_file_get_contents(filename, &contents, &length, &err);
+
+    if (err)
+    {
+        WARNING("Unable to read cache journal at '%s' because: %s", filename, err->message);
+        return FALSE;
+    }
+
+    while (pos < length)
+    {
+        g_autoptr(GtCacheFileEntry) entry = NULL;
+        guint32 record_length;
+        const gchar* record;
+        const gchar* end;
+        const gchar* id;
+        const gchar* etag;
+        const gchar* nul;
+        gint64 created;
+        gint64 expiry;
+        gint64 accessed;
+        guint64 size;
+        guint32 hits;
+
+        if (length - pos < sizeof(record_length))
+            break;
+
+        memcpy(&record_length, contents + pos, sizeof(record_length));
+        record_length = GUINT32_FROM_LE(record_length);
+        pos += sizeof(record_length);
+
+        if (record_length <= JOURNAL_RECORD_HEADER_SIZE || record_length > length - pos)
+            break;
+
+        record = contents + pos;
+        end = record + record_length;
+        pos += record_length;
+
+        memcpy(&created, record + 1, sizeof(created));
+        memcpy(&expiry, record + 1 + sizeof(gint64), sizeof(expiry));
+        memcpy(&accessed, record + 1 + 2*sizeof(gint64), sizeof(accessed));
+        memcpy(&size, record + 1 + 3*sizeof(gint64), sizeof(size));
+        memcpy(&hits, record + 1 + 4*sizeof(gint64), sizeof(hits));
+
+        /* NOTE: The key, id and etag all have to be terminated within the record */
+        if ((nul = memchr(record + JOURNAL_RECORD_HEADER_SIZE, '\0', end - record - JOURNAL_RECORD_HEADER_SIZE)) == NULL)
+            break;
+        id = nul + 1;
+        if (id >= end || (nul = memchr(id, '\0', end - id)) == NULL)
+            break;
+        etag = nul + 1;
+        if (etag >= end || memchr(etag, '\0', end - etag) == NULL)
+            break;
+
+        if (utils_str_empty(record + JOURNAL_RECORD_HEADER_SIZE))
+            break;
+
+        entry = gt_cache_file_entry_new();
+        entry->key = g_strdup(record + JOURNAL_RECORD_HEADER_SIZE);
+
+        if (record[0] == JOURNAL_OP_UPSERT)
+        {
+            if (utils_str_empty(id))
+                break;
+
+            entry->id = g_strdup(id);
+            entry->etag = utils_str_empty(etag) ? NULL : g_strdup(etag);
+            entry->created = GINT64_FROM_LE(created);
+            entry->expiry = GINT64_FROM_LE(expiry);
+            entry->accessed = GINT64_FROM_LE(accessed);
+            entry->size = GUINT64_FROM_LE(size);
+            entry->hits = GUINT32_FROM_LE(hits);
+        }
+        else if (record[0] == JOURNAL_OP_DELETE)
+            entry->deleted = TRUE;
+        else
+            break;
+
+        g_hash_table_replace(priv->db, g_strdup(entry->key), g_steal_pointer(&entry));
+
+        priv->journal_records++;
+    }
+
+    MESSAGE("Replayed '%d' cache journal records", priv->journal_records);
+
+    if (pos < length)
+    {
+        WARNING("Cache journal at '%s' has a torn or corrupt record at offset '%" G_GSIZE_FORMAT "'",
+            filename, pos);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void
+byte_array_append_string(GByteArray* array, const gchar* str)
+{
+    if (str)
+        g_byte_array_append(array, (const guint8*) str, strlen(str));
+
+    g_byte_array_append(array, (const guint8*) "", 1);
+}
+
+static gboolean sweep_cb(gpointer udata);
+static void request_compaction(GtCacheFile* self);
+
+static void
+append_journal(GtCacheFile* self, GtCacheFileJournalOp op, const GtCacheFileEntry* entry)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autoptr(GByteArray) record = g_byte_array_new();
+    g_autoptr(GError) err = NULL;
+    guint32 length = 0;
+    guint8 op_byte = op;
+    gint64 created = GINT64_TO_LE(entry->created);
+    gint64 expiry = GINT64_TO_LE(entry->expiry);
+    gint64 accessed = GINT64_TO_LE(entry->accessed);
+    guint64 size = GUINT64_TO_LE(entry->size);
+    guint32 hits = GUINT32_TO_LE(entry->hits);
+
+    if (!priv->journal)
+        return;
+
+    g_byte_array_append(record, (const guint8*) &length, sizeof(length));
+    g_byte_array_append(record, &op_byte, sizeof(op_byte));
+    g_byte_array_append(record, (const guint8*) &created, sizeof(created));
+    g_byte_array_append(record, (const guint8*) &expiry, sizeof(expiry));
+    g_byte_array_append(record, (const guint8*) &accessed, sizeof(accessed));
+    g_byte_array_append(record, (const guint8*) &size, sizeof(size));
+    g_byte_array_append(record, (const guint8*) &hits, sizeof(hits));
+    byte_array_append_string(record, entry->key);
+    byte_array_append_string(record, entry->id);
+    byte_array_append_string(record, entry->etag);
+
+    length = GUINT32_TO_LE(record->len - sizeof(length));
+    memcpy(record->data, &length, sizeof(length));
+
+    g_output_stream_write_all(priv->journal, record->data, record->len, NULL, NULL, &err);
+
+    if (err)
+    {
+        WARNING("Unable to append to cache journal because: %s", err->message);
+        return;
+    }
+
+    priv->journal_records++;
+
+    if (priv->compacting)
+        g_hash_table_add(priv->compact_dirty, g_strdup(entry->key));
+    else if (!priv->compact_requested && !priv->writer_quit && should_compact(self))
+        request_compaction(self);
+}
+
+/* NOTE: See unref_content for deferred */
+static void
+remove_entry(GtCacheFile* self, const gchar* key, GPtrArray* deferred)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    GtCacheFileEntry* entry = lookup_entry(self, key);
+    GtCacheFileEntry* tombstone = gt_cache_file_entry_new();
+    g_autofree gchar* id = entry ? g_strdup(entry->id) : NULL;
+
+    tombstone->key = g_strdup(key);
+    tombstone->deleted = TRUE;
+
+    append_journal(self, JOURNAL_OP_DELETE, tombstone);
+
+    g_hash_table_replace(priv->db, g_strdup(key), tombstone);
+
+    if (id)
+        unref_content(self, id, deferred);
+}
+
+static gboolean
+write_index(GtCacheFile* self, GArray* entries)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autofree gchar* filename = g_build_filename(priv->cache_directory, INDEX_FILENAME, NULL);
+    g_autofree GtCacheFileIndexRecord* slots = NULL;
+    g_autoptr(GByteArray) strings = g_byte_array_new();
+    g_autoptr(GByteArray) contents = NULL;
+    g_autoptr(GError) err = NULL;
+    GtCacheFileIndexHeader header = {{0}};
+    guint32 n_slots = 1 << g_bit_storage(MAX(entries->len*2, INDEX_MIN_SLOTS) - 1);
+    guint32 mask = n_slots - 1;
+
+    slots = g_new(GtCacheFileIndexRecord, n_slots);
+    memset(slots, 0xff, n_slots*sizeof(GtCacheFileIndexRecord));
+
+    for (guint i = 0; i < entries->len; i++)
+    {
+        const GtCacheFileEntry* entry = &g_array_index(entries, GtCacheFileEntry, i);
+        guint32 hash = hash_key(entry->key);
+        guint32 slot = hash & mask;
+
+        while (GUINT32_FROM_LE(slots[slot].key_offset) != NO_STRING)
+            slot = (slot + 1) & mask;
+
+        slots[slot].hash = GUINT32_TO_LE(hash);
+        slots[slot].created = GINT64_TO_LE(entry->created);
+        slots[slot].expiry = GINT64_TO_LE(entry->expiry);
+        slots[slot].accessed = GINT64_TO_LE(entry->accessed);
+        slots[slot].size = GUINT64_TO_LE(entry->size);
+        slots[slot].hits = GUINT32_TO_LE(entry->hits);
+        memset(slots[slot].reserved, 0, sizeof(slots[slot].reserved));
+
+        slots[slot].key_offset = GUINT32_TO_LE(strings->len);
+        byte_array_append_string(strings, entry->key);
+        slots[slot].id_offset = GUINT32_TO_LE(strings->len);
+        byte_array_append_string(strings, entry->id);
+
+        if (entry->etag)
+        {
+            slots[slot].etag_offset = GUINT32_TO_LE(strings->len);
+            byte_array_append_string(strings, entry->etag);
+        }
+        else
+            slots[slot].etag_offset = GUINT32_TO_LE(NO_STRING);
+
+        if (strings->len >= NO_STRING)
+        {
+            WARNING("Cache index string table too large, not compacting");
+            return FALSE;
+        }
+    }
+
+    /* NOTE: Keep the string table non-empty and NUL terminated */
+    if (strings->len == 0)
+        byte_array_append_string(strings, NULL);
+
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = GUINT32_TO_LE(INDEX_VERSION);
+    header.n_entries = GUINT32_TO_LE(entries->len);
+    header.n_slots = GUINT32_TO_LE(n_slots);
+    header.strings_size = GUINT64_TO_LE(strings->len);
+
+    contents = g_byte_array_sized_new(sizeof(header) + n_slots*sizeof(GtCacheFileIndexRecord) + strings->len);
+    g_byte_array_append(contents, (const guint8*) &header, sizeof(header));
+    g_byte_array_append(contents, (const guint8*) slots, n_slots*sizeof(GtCacheFileIndexRecord));
+    g_byte_array_append(contents, strings->data, strings->len);
+
+    /* NOTE: This writes to a temporary file and renames it over the
+     * old index, so the mapping we're reading from stays valid */
+    g_file_set_contents(filename, (const gchar*) contents->data, contents->len, &err);
+
+    if (err)
+    {
+        WARNING("Unable to write cache index to '%s' because: %s", filename, err->message);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* NOTE: Every live entry from the index and the overlay. These borrow
+ * their strings from the mapping and the overlay so the array is only
+ * valid until either changes. */
+static GArray*
+collect_entries(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    GArray* entries = g_array_new(FALSE, FALSE, sizeof(GtCacheFileEntry));
+    GHashTableIter iter;
+    gpointer value;
+
+    for (guint32 i = 0; i < priv->index_n_slots; i++)
+    {
+        const GtCacheFileIndexRecord* record = &priv->index_slots[i];
+        const gchar* key = index_string(priv, record->key_offset);
+        const gchar* id = index_string(priv, record->id_offset);
+        GtCacheFileEntry entry = {0};
+
+        if (!key || !id || g_hash_table_contains(priv->db, key))
+            continue;
+
+        entry.key = (gchar*) key;
+        entry.id = (gchar*) id;
+        entry.etag = (gchar*) index_string(priv, record->etag_offset);
+        entry.created = GINT64_FROM_LE(record->created);
+        entry.expiry = GINT64_FROM_LE(record->expiry);
+        entry.accessed = GINT64_FROM_LE(record->accessed);
+        entry.size = GUINT64_FROM_LE(record->size);
+        entry.hits = GUINT32_FROM_LE(record->hits);
+
+        g_array_append_val(entries, entry);
+    }
+
+    g_hash_table_iter_init(&iter, priv->db);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        const GtCacheFileEntry* entry = value;
+
+        if (!entry->deleted)
+            g_array_append_vals(entries, entry, 1);
+    }
+
+    return entries;
+}
+
+/* NOTE: Folds the overlay into a new index and truncates the journal */
+static gboolean
+compact(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autoptr(GArray) entries = NULL;
+    gint64 start_time = g_get_monotonic_time();
+
+    if (priv->read_only)
+    {
+        WARNING("Not compacting cache index at '%s' because: It is in use by another instance",
+            priv->cache_directory);
+        return FALSE;
+    }
+
+    entries = collect_entries(self);
+
+    if (!write_index(self, entries))
+        return FALSE;
+
+    g_hash_table_remove_all(priv->db);
+
+    map_index(self);
+    open_journal(self, TRUE);
+
+    MESSAGE("Compacted cache index with '%d' entries in '%" G_GINT64_FORMAT "' ms",
+        priv->index_n_entries, (g_get_monotonic_time() - start_time) / 1000);
+
+    return TRUE;
+}
+
+static void
+entry_clear(gpointer data)
+{
+    GtCacheFileEntry* entry = data;
+
+    g_free(entry->key);
+    g_free(entry->id);
+    g_free(entry->etag);
+}
+
+/* NOTE: Like collect_entries but the array owns its strings, so it
+ * stays valid after the lock is released */
+static GArray*
+snapshot_entries(GtCacheFile* self)
+{
+    GArray* entries = collect_entries(self);
+
+    g_array_set_clear_func(entries, entry_clear);
+
+    for (guint i = 0; i < entries->len; i++)
+    {
+        GtCacheFileEntry* entry = &g_array_index(entries, GtCacheFileEntry, i);
+
+        entry->key = g_strdup(entry->key);
+        entry->id = g_strdup(entry->id);
+        entry->etag = g_strdup(entry->etag);
+    }
+
+    return entries;
+}
+
+/* NOTE: Called on the writer thread with the lock held. The index is
+ * written from a snapshot without the lock, saves and lookups carry
+ * on meanwhile. Whatever was journaled since the snapshot stays in
+ * the overlay and is written to the new journal. */
+static void
+compact_in_background(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autoptr(GArray) entries = snapshot_entries(self);
+    gint64 start_time = g_get_monotonic_time();
+    GHashTableIter iter;
+    gpointer key;
+    gpointer value;
+    gboolean written;
+
+    priv->compact_requested = FALSE;
+    priv->compacting = TRUE;
+
+    g_mutex_unlock(&priv->mutex);
+
+    written = write_index(self, entries);
+
+    g_mutex_lock(&priv->mutex);
+
+    priv->compacting = FALSE;
+
+    if (written)
+    {
+        g_hash_table_iter_init(&iter, priv->db);
+        while (g_hash_table_iter_next(&iter, &key, &value))
+        {
+            GtCacheFileEntry* entry = value;
+
+            /* NOTE: Access times aren't journaled, keep them around */
+            if (!entry->touched && !g_hash_table_contains(priv->compact_dirty, key))
+                g_hash_table_iter_remove(&iter);
+        }
+
+        map_index(self);
+        open_journal(self, TRUE);
+
+        g_hash_table_iter_init(&iter, priv->compact_dirty);
+        while (g_hash_table_iter_next(&iter, &key, NULL))
+        {
+            GtCacheFileEntry* entry = g_hash_table_lookup(priv->db, key);
+
+            if (entry)
+                append_journal(self, entry->deleted ? JOURNAL_OP_DELETE : JOURNAL_OP_UPSERT, entry);
+        }
+
+        MESSAGE("Compacted cache index with '%d' entries in '%" G_GINT64_FORMAT "' ms",
+            priv->index_n_entries, (g_get_monotonic_time() - start_time) / 1000);
+    }
+
+    g_hash_table_remove_all(priv->compact_dirty);
+}
+
+/* NOTE: Reads the cache.json written by older versions into the
+ * overlay so it can be compacted into an index */
+static gboolean
+load_legacy_db(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autofree gchar* filename = g_build_filename(priv->cache_directory, LEGACY_DB_FILENAME, NULL);
+
+    if (!g_file_test(filename, G_FILE_TEST_EXISTS))
+        return FALSE;
+
+    g_autoptr(JsonParser) parser = json_parser_new();
+    g_autoptr(JsonReader) reader = NULL;
+    g_autoptr(GError) err = NULL;
+
+    json_parser_load_from_file(parser, filename, &err);
+
+    if (err)
+    {
+        WARNING("Unable to import legacy cache db at '%s' because: %s", filename, err->message);
+        return FALSE;
+    }
+
+    reader = json_reader_new(json_parser_get_root(parser));
+
+    for (gint i = 0; i < json_reader_count_members(reader); i++)
+    {
+        g_autoptr(GtCacheFileEntry) entry = gt_cache_file_entry_new();
+
+        json_reader_read_element(reader, i);
+
+        entry->key = g_strdup(json_reader_get_member_name(reader));
+
+        json_reader_read_member(reader, ID_MEMBER_NAME);
+        entry->id = g_strdup(json_reader_get_string_value(reader));
+        json_reader_end_member(reader);
+
+        json_reader_read_member(reader, CREATED_MEMBER_NAME);
+        entry->created = json_reader_get_int_value(reader);
+        entry->accessed = entry->created;
+        json_reader_end_member(reader);
+
+        json_reader_read_member(reader, EXPIRY_MEMBER_NAME);
+        entry->expiry = json_reader_get_int_value(reader);
+        json_reader_end_member(reader);
+
+        json_reader_read_member(reader, ETAG_MEMBER_NAME);
+        entry->etag = json_reader_get_null_value(reader) ?
+            NULL : g_strdup(json_reader_get_string_value(reader));
+        json_reader_end_member(reader);
+
+        json_reader_end_element(reader);
+
+        /* NOTE: Skip broken entries rather than throwing the whole cache away */
+        if (utils_str_empty(entry->key) || utils_str_empty(entry->id))
+        {
+            WARNING("Skipping invalid legacy cache entry '%d'", i);
+            continue;
+        }
+
+        g_hash_table_replace(priv->db, g_strdup(entry->key), g_steal_pointer(&entry));
+    }
+
+    MESSAGE("Imported '%d' cache entries from legacy db", g_hash_table_size(priv->db));
+
+    return TRUE;
+}
+
+static void
+schedule_sweep(GtCacheFile* self, guint interval)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    if (priv->sweep_source_id > 0)
+        g_source_remove(priv->sweep_source_id);
+
+    priv->sweep_source_id = g_timeout_add(interval, sweep_cb, self);
+}
+
+/* NOTE: Entries stored by older versions don't know their size, look
+ * it up once. Called with the lock held, the files are stat'ed without
+ * it. Entries whose file is gone are left with a size of 0. */
+static void
+fill_entry_sizes(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autoptr(GPtrArray) keys = g_ptr_array_new_with_free_func(g_free);
+    g_autoptr(GPtrArray) ids = g_ptr_array_new_with_free_func(g_free);
+    g_autoptr(GArray) sizes = NULL;
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_iter_init(&iter, priv->db);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        GtCacheFileEntry* entry = value;
+
+        if (entry->deleted || entry->size > 0)
+            continue;
+
+        g_ptr_array_add(keys, g_strdup(entry->key));
+        g_ptr_array_add(ids, g_strdup(entry->id));
+    }
+
+    for (guint32 i = 0; i < priv->index_n_slots; i++)
+    {
+        const GtCacheFileIndexRecord* record = &priv->index_slots[i];
+        const gchar* key = index_string(priv, record->key_offset);
+        const gchar* id = index_string(priv, record->id_offset);
+
+        if (!key || !id || GUINT64_FROM_LE(record->size) > 0 || g_hash_table_contains(priv->db, key))
+            continue;
+
+        g_ptr_array_add(keys, g_strdup(key));
+        g_ptr_array_add(ids, g_strdup(id));
+    }
+
+    if (keys->len == 0)
+        return;
+
+    sizes = g_array_sized_new(FALSE, TRUE, sizeof(guint64), keys->len);
+    g_array_set_size(sizes, keys->len);
+
+    g_mutex_unlock(&priv->mutex);
+
+    for (guint i = 0; i < ids->len; i++)
+    {
+        g_autofree gchar* filename = content_path(priv, g_ptr_array_index(ids, i));
+        GStatBuf buf;
+
+        if (g_stat(filename, &buf) == 0)
+            g_array_index(sizes, guint64, i) = buf.st_size;
+    }
+
+    g_mutex_lock(&priv->mutex);
+
+    for (guint i = 0; i < keys->len; i++)
+    {
+        guint64 size = g_array_index(sizes, guint64, i);
+        GtCacheFileEntry* entry;
+
+        if (size == 0)
+            continue;
+
+        entry = lookup_entry(self, g_ptr_array_index(keys, i));
+
+        /* NOTE: Leave entries that were replaced while we weren't looking */
+        if (!entry || entry->size > 0 || g_strcmp0(entry->id, g_ptr_array_index(ids, i)) != 0)
+            continue;
+
+        entry->size = size;
+        entry->touched = TRUE;
+    }
+}
+
+static void
+add_sweep_candidate(GArray* candidates, GPtrArray* plan, const gchar* key,
+    gint64 expiry, gint64 accessed, guint64 size, guint32 hits, gint64 now)
+{
+    GtCacheFileSweepCandidate candidate = {key, accessed, size, hits > 0};
+
+    /* NOTE: Expired entries can still be revalidated with a
+     * conditional request, so they only lose their protection */
+    if (expiry < now)
+        candidate.protected = FALSE;
+
+    if (size == 0)
+        g_ptr_array_add(plan, g_strdup(key));
+    else
+        g_array_append_val(candidates, candidate);
+}
+
+static gint
+sweep_candidate_compare(gconstpointer a, gconstpointer b)
+{
+    const GtCacheFileSweepCandidate* ca = a;
+    const GtCacheFileSweepCandidate* cb = b;
+
+    return (ca->accessed > cb->accessed) - (ca->accessed < cb->accessed);
+}
+
+/* NOTE: Returns the keys of the entries to evict. Empty entries come
+ * first, then entries in probation, which includes expired ones, and
+ * then protected entries, least recently used first, until we're
+ * under the low watermark. Call with the lock held, after
+ * fill_entry_sizes. */
+static GPtrArray*
+plan_sweep(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autoptr(GArray) candidates = g_array_new(FALSE, FALSE, sizeof(GtCacheFileSweepCandidate));
+    GPtrArray* plan = g_ptr_array_new_with_free_func(g_free);
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    guint64 total = 0;
+    guint64 protected_size = 0;
+    guint evicted = 0;
+    GHashTableIter iter;
+    gpointer value;
+
+    /* NOTE: Recount the content references while we're looking at every entry anyway */
+    g_hash_table_remove_all(priv->content_refs);
+    priv->content_refs_valid = TRUE;
+
+    g_hash_table_iter_init(&iter, priv->db);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        GtCacheFileEntry* entry = value;
+
+        if (entry->deleted)
+            continue;
+
+        ref_content(self, entry->id);
+
+        add_sweep_candidate(candidates, plan, entry->key, entry->expiry, entry->accessed,
+            entry->size, entry->hits, now);
+    }
+
+    for (guint32 i = 0; i < priv->index_n_slots; i++)
+    {
+        const GtCacheFileIndexRecord* record = &priv->index_slots[i];
+        const gchar* key = index_string(priv, record->key_offset);
+        const gchar* id = index_string(priv, record->id_offset);
+        GtCacheFileEntry* entry;
+
+        if (!key || !id || g_hash_table_contains(priv->db, key))
+            continue;
+
+        ref_content(self, id);
+
+        if (GUINT64_FROM_LE(record->size) > 0)
+        {
+            add_sweep_candidate(candidates, plan, key, GINT64_FROM_LE(record->expiry),
+                GINT64_FROM_LE(record->accessed), GUINT64_FROM_LE(record->size),
+                GUINT32_FROM_LE(record->hits), now);
+        }
+        else if ((entry = lookup_entry(self, key)) != NULL)
+        {
+            add_sweep_candidate(candidates, plan, entry->key, entry->expiry,
+                entry->accessed, entry->size, entry->hits, now);
+        }
+    }
+
+    g_array_sort(candidates, sweep_candidate_compare);
+
+    for (guint i = 0; i < candidates->len; i++)
+    {
+        const GtCacheFileSweepCandidate* candidate = &g_array_index(candidates, GtCacheFileSweepCandidate, i);
+
+        total += candidate->size;
+
+        if (candidate->protected)
+            protected_size += candidate->size;
+    }
+
+    if (priv->max_size > 0 && total > priv->max_size)
+    {
+        guint64 target = priv->max_size*SWEEP_LOW_WATERMARK;
+
+        for (guint i = 0; i < candidates->len && protected_size > priv->max_size*PROTECTED_RATIO; i++)
+        {
+            GtCacheFileSweepCandidate* candidate = &g_array_index(candidates, GtCacheFileSweepCandidate, i);
+
+            if (candidate->protected)
+            {
+                candidate->protected = FALSE;
+                protected_size -= candidate->size;
+            }
+        }
+
+        for (gint pass = 0; pass < 2 && total > target; pass++)
+        {
+            for (guint i = 0; i < candidates->len && total > target; i++)
+            {
+                const GtCacheFileSweepCandidate* candidate = &g_array_index(candidates, GtCacheFileSweepCandidate, i);
+
+                if (candidate->protected != (pass == 1))
+                    continue;
+
+                g_ptr_array_add(plan, g_strdup(candidate->key));
+                total -= candidate->size;
+                evicted++;
+            }
+        }
+    }
+
+    priv->size = total;
+    priv->num_entries = candidates->len - evicted;
+    priv->sweep_time = now;
+
+    DEBUG("Planned sweep of '%d' cache entries, '%" G_GUINT64_FORMAT "' bytes will be left",
+        plan->len, total);
+
+    return plan;
+}
+
+/* NOTE: Collects the paths of all content files, both sharded and
+ * the flat ones from before content addressing */
+static void
+list_content_files(const gchar* directory, GPtrArray* files)
+{
+    g_autoptr(GDir) dir = g_dir_open(directory, 0, NULL);
+    const gchar* name;
+
+    if (!dir)
+        return;
+
+    while ((name = g_dir_read_name(dir)) != NULL)
+    {
+        g_autofree gchar* path = g_build_filename(directory, name, NULL);
+
+        if (g_file_test(path, G_FILE_TEST_IS_DIR))
+        {
+            if (strlen(name) == 2 && g_ascii_isxdigit(name[0]) && g_ascii_isxdigit(name[1]))
+                list_content_files(path, files);
+        }
+        else if (!g_str_has_prefix(name, "cache."))
+            g_ptr_array_add(files, g_steal_pointer(&path));
+    }
+}
+
+/* NOTE: Runs in a thread after the first sweep has counted the
+ * content references and removes files no entry refers to. These
+ * are left behind by crashes and by content replaced before the
+ * references were known. */
+static void
+collect_orphans_cb(GTask* task, gpointer source,
+    gpointer task_data, GCancellable* cancel)
+{
+    RETURN_IF_FAIL(GT_IS_CACHE_FILE(source));
+
+    GtCacheFile* self = GT_CACHE_FILE(source);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autoptr(GPtrArray) files = g_ptr_array_new_with_free_func(g_free);
+    guint64 freed = 0;
+    guint removed = 0;
+    gint64 cutoff;
+
+    g_mutex_lock(&priv->mutex);
+    cutoff = priv->sweep_time;
+    g_mutex_unlock(&priv->mutex);
+
+    list_content_files(priv->cache_directory, files);
+
+    for (guint i = 0; i < files->len; i++)
+    {
+        const gchar* path = g_ptr_array_index(files, i);
+        g_autofree gchar* id = g_path_get_basename(path);
+        gboolean referenced;
+        GStatBuf buf;
+
+        g_mutex_lock(&priv->mutex);
+        referenced = g_hash_table_contains(priv->content_refs, id);
+        g_mutex_unlock(&priv->mutex);
+
+        /* NOTE: Anything newer than the count might be an entry being saved */
+        if (referenced || g_stat(path, &buf) != 0 || buf.st_mtime >= cutoff)
+            continue;
+
+        if (g_remove(path) == 0)
+        {
+            removed++;
+            freed += buf.st_size;
+        }
+    }
+
+    if (removed > 0)
+    {
+        MESSAGE("Removed '%d' orphaned cache files freeing '%" G_GUINT64_FORMAT "' bytes",
+            removed, freed);
+    }
+
+    g_task_return_boolean(task, TRUE);
+}
+
+/* NOTE: Called on the writer thread with the lock held. Only planning
+ * and removing entries hold the lock, sizes are looked up and files
+ * deleted without it. */
+static void
+sweep_in_background(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autoptr(GPtrArray) plan = NULL;
+    guint64 evicted_entries = 0;
+    guint64 evicted_bytes = 0;
+    guint pos = 0;
+
+    priv->sweep_requested = FALSE;
+    priv->sweeping = TRUE;
+
+    fill_entry_sizes(self);
+
+    plan = plan_sweep(self);
+
+    if (!priv->orphans_collected)
+    {
+        g_autoptr(GTask) task = g_task_new(self, NULL, NULL, NULL);
+
+        priv->orphans_collected = TRUE;
+
+        g_task_run_in_thread(task, collect_orphans_cb);
+    }
+
+    while (pos < plan->len && !priv->writer_quit)
+    {
+        g_autoptr(GPtrArray) deferred = g_ptr_array_new_with_free_func(g_free);
+
+        for (guint i = 0; i < SWEEP_BATCH_SIZE && pos < plan->len; i++)
+        {
+            const gchar* key = g_ptr_array_index(plan, pos++);
+            GtCacheFileEntry* entry = lookup_entry(self, key);
+            guint64 size;
+
+            /* NOTE: Leave entries that were used or replaced after the plan was made */
+            if (!entry || MAX(entry->created, entry->accessed) > priv->sweep_time)
+                continue;
+
+            size = entry->size;
+
+            remove_entry(self, key, deferred);
+
+            evicted_entries++;
+            evicted_bytes += size;
+            priv->evicted_entries++;
+            priv->evicted_bytes += size;
+        }
+
+        if (deferred->len == 0)
+            continue;
+
+        /* NOTE: Content saved again in the meantime may lose its file,
+         * the lookup then drops the entry and it's fetched again */
+        g_mutex_unlock(&priv->mutex);
+
+        for (guint i = 0; i < deferred->len; i++)
+        {
+            const gchar* filename = g_ptr_array_index(deferred, i);
+
+            if (g_remove(filename) != 0 && errno != ENOENT)
+                WARNING("Unable to delete cache file '%s' because: %s", filename, g_strerror(errno));
+        }
+
+        g_mutex_lock(&priv->mutex);
+    }
+
+    priv->sweeping = FALSE;
+
+    if (evicted_entries > 0)
+    {
+        MESSAGE("Evicted '%" G_GUINT64_FORMAT "' cache entries freeing '%" G_GUINT64_FORMAT "' bytes, "
+            "'%" G_GUINT64_FORMAT "' entries using '%" G_GUINT64_FORMAT "' bytes left",
+            evicted_entries, evicted_bytes, priv->num_entries, priv->size);
+    }
+}
+
+static gboolean
+write_all(gint fd, GBytes* bytes)
+{
+    gsize length;
+    const guint8* data = g_bytes_get_data(bytes, &length);
+
+    while (length > 0)
+    {
+        gssize written = write(fd, data, length);
+
+        if (written < 0 && errno == EINTR)
+            continue;
+
+        if (written < 0)
+            return FALSE;
+
+        data += written;
+        length -= written;
+    }
+
+    return TRUE;
+}
+
+/* NOTE: 'none' writes straight to the final name, 'atomic' writes a
+ * temporary file and renames it over and 'sync' also fsyncs it first.
+ * A torn file from 'none' is only a corrupt image that gets fetched
+ * again once it fails to decode. */
+static gboolean
+write_content(const gchar* filename, GBytes* bytes,
+    GtCacheFileDurability durability, GError** error)
+{
+    g_autofree gchar* tmp_filename = NULL;
+    const gchar* target = filename;
+    gboolean ret;
+    gint fd;
+
+    if (durability != GT_CACHE_FILE_DURABILITY_NONE)
+        target = tmp_filename = g_strconcat(filename, ".tmp", NULL);
+
+    if ((fd = g_open(target, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+    {
+        g_autofree gchar* dirname = g_path_get_dirname(filename);
+
+        /* NOTE: First file in this shard */
+        if (errno == ENOENT && g_mkdir_with_parents(dirname, 0755) == 0)
+            fd = g_open(target, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+
+    if (fd < 0)
+    {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno),
+            "Unable to open '%s': %s", target, g_strerror(errno));
+        return FALSE;
+    }
+
+    ret = write_all(fd, bytes);
+
+    if (ret && durability == GT_CACHE_FILE_DURABILITY_SYNC)
+        ret = fsync(fd) == 0;
+
+    if (!ret)
+    {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno),
+            "Unable to write '%s': %s", target, g_strerror(errno));
+    }
+
+    close(fd);
+
+    if (ret && tmp_filename && g_rename(tmp_filename, filename) != 0)
+    {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno),
+            "Unable to rename '%s': %s", tmp_filename, g_strerror(errno));
+        ret = FALSE;
+    }
+
+    if (!ret && tmp_filename)
+        g_remove(tmp_filename);
+
+    return ret;
+}
+
+/* NOTE: Writes queued content one file at a time so a grid of
+ * previews doesn't turn into as many concurrent replaces */
+static gpointer
+writer_thread(gpointer udata)
+{
+    GtCacheFile* self = GT_CACHE_FILE(udata);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_mutex_lock(&priv->mutex);
+
+    while (TRUE)
+    {
+        g_autofree gchar* id = NULL;
+        g_autofree gchar* filename = NULL;
+        g_autoptr(GBytes) bytes = NULL;
+        g_autoptr(GError) err = NULL;
+        GtCacheFileDurability durability;
+
+        while (g_queue_is_empty(priv->pending_queue) && !priv->compact_requested
+            && !priv->sweep_requested && !priv->writer_quit)
+        {
+            g_cond_wait(&priv->writer_cond, &priv->mutex);
+        }
+
+        if (priv->compact_requested)
+        {
+            compact_in_background(self);
+            continue;
+        }
+
+        if (priv->sweep_requested)
+        {
+            sweep_in_background(self);
+            continue;
+        }
+
+        /* NOTE: Drain the queue before quitting */
+        if (g_queue_is_empty(priv->pending_queue))
+            break;
+
+        id = g_queue_pop_head(priv->pending_queue);
+
+        /* NOTE: Dropped while it was waiting */
+        if (!g_hash_table_contains(priv->pending, id))
+            continue;
+
+        bytes = g_bytes_ref(g_hash_table_lookup(priv->pending, id));
+        filename = content_path(priv, id);
+        durability = priv->durability;
+
+        g_mutex_unlock(&priv->mutex);
+
+        if (!write_content(filename, bytes, durability, &err))
+            WARNING("Couldn't write cache file data because: %s, failing silently", err->message);
+
+        g_mutex_lock(&priv->mutex);
+
+        if (g_hash_table_lookup(priv->pending, id) == bytes)
+        {
+            priv->pending_size -= g_bytes_get_size(bytes);
+            g_hash_table_remove(priv->pending, id);
+        }
+        /* NOTE: Dropped while it was being written, nothing refers to
+         * it any more unless it was saved again in the meantime */
+        else if (!g_hash_table_contains(priv->pending, id) && priv->content_refs_valid
+            && !g_hash_table_contains(priv->content_refs, id))
+        {
+            if (g_remove(filename) != 0 && errno != ENOENT)
+                WARNING("Unable to delete cache file '%s' because: %s", filename, g_strerror(errno));
+        }
+    }
+
+    g_mutex_unlock(&priv->mutex);
+
+    return NULL;
+}
+
+static void
+wake_writer(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    if (!priv->writer)
+        priv->writer = g_thread_new("gt-cache-writer", writer_thread, self);
+
+    g_cond_signal(&priv->writer_cond);
+}
+
+static void
+queue_write(GtCacheFile* self, const gchar* id, gconstpointer data, gsize length)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_hash_table_insert(priv->pending, g_strdup(id), g_bytes_new(data, length));
+    g_queue_push_tail(priv->pending_queue, g_strdup(id));
+    priv->pending_size += length;
+
+    wake_writer(self);
+}
+
+static void
+request_compaction(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    priv->compact_requested = TRUE;
+
+    wake_writer(self);
+}
+
+static void
+request_sweep(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    if (priv->sweep_requested || priv->sweeping || priv->writer_quit)
+        return;
+
+    priv->sweep_requested = TRUE;
+
+    wake_writer(self);
+}
+
+static gboolean
+sweep_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(udata), G_SOURCE_REMOVE);
+
+    GtCacheFile* self = GT_CACHE_FILE(udata);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+
+    priv->sweep_source_id = 0;
+
+    if (!priv->loaded)
+    {
+        schedule_sweep(self, SWEEP_RETRY_INTERVAL);
+        return G_SOURCE_REMOVE;
+    }
+
+    request_sweep(self);
+
+    schedule_sweep(self, SWEEP_INTERVAL);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+save_data(GtCache* cache, const gchar* key, gconstpointer data, gsize length,
+    GDateTime* last_updated, GDateTime* expiry, const gchar* etag)
+{
+    RETURN_IF_FAIL(GT_IS_CACHE_FILE(cache));
+    RETURN_IF_FAIL(!utils_str_empty(key));
+    RETURN_IF_FAIL(data != NULL && length != 0);
+    RETURN_IF_FAIL(!(last_updated == NULL && etag == NULL));
+
+    GtCacheFile* self = GT_CACHE_FILE(cache);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    if (priv->read_only)
+        return;
+
+    GtCacheFileEntry* entry = NULL; /* NOTE: Don't free, owned by hash table */
+    g_autofree gchar* id = g_compute_checksum_for_data(G_CHECKSUM_SHA256, data, length);
+    g_autofree gchar* old_id = NULL;
+    g_autofree gchar* filename = NULL;
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+
+    if (!wait_loaded(self))
+        return;
+
+    /* NOTE: The writer can't keep up, drop this save rather than
+     * holding on to more memory. The old entry, if any, is stale by
+     * now and will be missed on the next lookup. */
+    if (!g_hash_table_contains(priv->pending, id) &&
+        priv->max_pending_size > 0 && priv->pending_size + length > priv->max_pending_size)
+    {
+        DEBUG("Dropping cache write for '%s', too much pending", key);
+        priv->dropped_writes++;
+        return;
+    }
+
+    if ((entry = lookup_entry(self, key)) != NULL)
+    {
+        priv->size -= MIN(priv->size, entry->size);
+        old_id = g_strdup(entry->id);
+
+        gt_cache_file_entry_update(entry, id, length, expiry, etag);
+    }
+    else
+    {
+        entry = gt_cache_file_entry_new_with_params(key, id, length, expiry, etag);
+
+        g_hash_table_replace(priv->db, g_strdup(key), entry);
+    }
+
+    append_journal(self, JOURNAL_OP_UPSERT, entry);
+
+    priv->size += length;
+
+    if (priv->max_size > 0 && priv->size > priv->max_size)
+        request_sweep(self);
+
+    /* NOTE: Same bytes as before, only the metadata changed */
+    if (g_strcmp0(old_id, id) == 0)
+        return;
+
+    ref_content(self, id);
+
+    if (old_id)
+        unref_content(self, old_id, NULL);
+
+    /* NOTE: Already queued, usually the same uri saved twice in a row */
+    if (g_hash_table_contains(priv->pending, id))
+    {
+        priv->coalesced_writes++;
+        return;
+    }
+
+    filename = content_path(priv, id);
+
+    /* NOTE: Another uri already stored the same bytes */
+    if (g_file_test(filename, G_FILE_TEST_EXISTS))
+    {
+        DEBUG("Deduplicated cache content for '%s'", key);
+        return;
+    }
+
+    queue_write(self, id, data, length);
+}
+
+gboolean
+is_data_stale(GtCache* cache, const gchar* key, GDateTime* last_updated, const gchar* etag)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(cache), TRUE);
+    RETURN_VAL_IF_FAIL(!utils_str_empty(key), TRUE);
+    RETURN_VAL_IF_FAIL(!(last_updated == NULL && etag == NULL), TRUE);
+
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(GT_CACHE_FILE(cache));
+
+    GtCacheFileEntry* entry = NULL; /* NOTE: Don't free, owned by hash table */
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+
+    priv->session_lookups++;
+
+    if (!wait_loaded(GT_CACHE_FILE(cache)))
+        return TRUE;
+
+    if ((entry = lookup_entry(GT_CACHE_FILE(cache), key)) != NULL)
+    {
+        /* NOTE: Past expiry date */
+        if (g_get_real_time() / G_USEC_PER_SEC > entry->expiry)
+        {
+            DEBUG("Cache miss: Past expiry date");
+            return TRUE;
+        }
+
+        /* NOTE: Check if newly updated */
+        if (last_updated && g_date_time_to_unix(last_updated) > entry->created)
+        {
+            DEBUG("Cache miss: Newly updated");
+            return TRUE;
+        }
+
+        /* NOTE: Check if etag differs */
+        if (etag && entry->etag && g_strcmp0(etag, entry->etag) != 0)
+        {
+            DEBUG("Cache miss: Etags differ");
+            return TRUE;
+        }
+    }
+    else
+        return TRUE; /* NOTE: Return true for data that doesn't exist */
+
+    priv->session_hits++;
+
+    return FALSE;
+}
+
+static gboolean
+get_validators(GtCache* cache, const gchar* key, GDateTime** last_updated, gchar** etag)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(cache), FALSE);
+    RETURN_VAL_IF_FAIL(!utils_str_empty(key), FALSE);
+
+    GtCacheFile* self = GT_CACHE_FILE(cache);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    GtCacheFileEntry* entry = NULL; /* NOTE: Don't free, owned by hash table */
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+
+    if (!wait_loaded(self) || (entry = lookup_entry(self, key)) == NULL)
+        return FALSE;
+
+    /* NOTE: We don't keep the server's Last-Modified, but the time we
+     * stored the entry is never earlier than it */
+    if (last_updated)
+        *last_updated = g_date_time_new_from_unix_utc(entry->created);
+    if (etag)
+        *etag = g_strdup(entry->etag);
+
+    return TRUE;
+}
+
+static void
+mark_data_fresh(GtCache* cache, const gchar* key, GDateTime* expiry)
+{
+    RETURN_IF_FAIL(GT_IS_CACHE_FILE(cache));
+    RETURN_IF_FAIL(!utils_str_empty(key));
+
+    GtCacheFile* self = GT_CACHE_FILE(cache);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    GtCacheFileEntry* entry = NULL; /* NOTE: Don't free, owned by hash table */
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+
+    if (!wait_loaded(self) || (entry = lookup_entry(self, key)) == NULL)
+        return;
+
+    entry->accessed = g_get_real_time() / G_USEC_PER_SEC;
+    entry->touched = TRUE;
+
+    if (expiry)
+    {
+        entry->expiry = g_date_time_to_unix(expiry);
+
+        append_journal(self, JOURNAL_OP_UPSERT, entry);
+    }
+}
+
+GInputStream*
+get_data_stream(GtCache* cache, const gchar* key, GError** error)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(cache), NULL);
+    RETURN_VAL_IF_FAIL(!utils_str_empty(key), NULL);
+
+    GtCacheFile* self = GT_CACHE_FILE(cache);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_autofree gchar* filename = NULL;
+    g_autoptr(GFile) file = NULL;
+    GtCacheFileEntry* entry = NULL;
+    g_autoptr(GInputStream) istream = NULL;
+    g_autoptr(GError) err = NULL;
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+
+    if (wait_loaded(self))
+        entry = lookup_entry(self, key);
+
+    if (entry == NULL)
+    {
+        g_set_error(error, GT_CACHE_ERROR, GT_CACHE_ERROR_ENTRY_NOT_FOUND,
+            "Couldn't find entry for given key '%s'", key);
+
+        return NULL;
+    }
+
+    /* NOTE: Still waiting for the writer */
+    if (g_hash_table_contains(priv->pending, entry->id))
+    {
+        entry->accessed = g_get_real_time() / G_USEC_PER_SEC;
+        entry->hits++;
+        entry->touched = TRUE;
+
+        return g_memory_input_stream_new_from_bytes(g_hash_table_lookup(priv->pending, entry->id));
+    }
+
+    filename = content_path(priv, entry->id);
+
+    file = g_file_new_for_path(filename);
+
+    istream = G_INPUT_STREAM(g_file_read(file, NULL, &err));
+
+    if (err)
+    {
+        /* NOTE: The file is gone, drop the entry so it gets fetched again */
+        if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+            remove_entry(self, key, NULL);
+
+        g_propagate_prefixed_error(error, g_steal_pointer(&err),
+            "Unable to get data stream for '%s' because: ", filename);
+
+        return NULL;
+    }
 
-    entry->id = g_uuid_string_random();
-    entry->created = g_date_time_new_now_utc();
+    /* NOTE: Only journaled on shutdown, see dispose */
+    entry->accessed = g_get_real_time() / G_USEC_PER_SEC;
+    entry->hits++;
+    entry->touched = TRUE;
 
-    return entry;
+    return g_steal_pointer(&istream);
 }
 
-static GtCacheFileEntry*
-gt_cache_file_entry_new_with_params(const gchar* key, GDateTime* expiry, const gchar* etag)
+GVariant*
+gt_cache_file_get_stats(GtCacheFile* self)
 {
-    GtCacheFileEntry* entry = gt_cache_file_entry_new();
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(self), NULL);
 
-    entry->key = g_strdup(key);
-    entry->expiry = g_date_time_ref(expiry);
-    entry->etag = g_strdup(etag);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
-    return entry;
+    GVariantBuilder builder;
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+
+    g_variant_builder_add(&builder, "{sv}", "entries", g_variant_new_uint64(priv->num_entries));
+    g_variant_builder_add(&builder, "{sv}", "size", g_variant_new_uint64(priv->size));
+    g_variant_builder_add(&builder, "{sv}", "max-size", g_variant_new_uint64(priv->max_size));
+    g_variant_builder_add(&builder, "{sv}", "evicted-entries", g_variant_new_uint64(priv->evicted_entries));
+    g_variant_builder_add(&builder, "{sv}", "evicted-bytes", g_variant_new_uint64(priv->evicted_bytes));
+    g_variant_builder_add(&builder, "{sv}", "pending-writes", g_variant_new_uint64(g_hash_table_size(priv->pending)));
+    g_variant_builder_add(&builder, "{sv}", "pending-bytes", g_variant_new_uint64(priv->pending_size));
+    g_variant_builder_add(&builder, "{sv}", "coalesced-writes", g_variant_new_uint64(priv->coalesced_writes));
+    g_variant_builder_add(&builder, "{sv}", "dropped-writes", g_variant_new_uint64(priv->dropped_writes));
+    g_variant_builder_add(&builder, "{sv}", "load-time", g_variant_new_int64(priv->load_time));
+    g_variant_builder_add(&builder, "{sv}", "load-main-wait-time", g_variant_new_int64(priv->load_main_wait_time));
+    g_variant_builder_add(&builder, "{sv}", "load-misses", g_variant_new_uint64(priv->load_misses));
+
+    return g_variant_builder_end(&builder);
 }
 
+/* NOTE: Only what's needed to group entries for --cache-stats, the
+ * request category isn't stored so the first path segment stands in */
 static void
-gt_cache_file_entry_update(GtCacheFileEntry* entry, GDateTime* expiry, const gchar* etag)
+split_key(const gchar* key, gchar** host, gchar** category)
 {
-    RETURN_IF_FAIL(entry != NULL);
+    const gchar* start = strstr(key, "://");
+    const gchar* path;
+    const gchar* end;
 
-    g_date_time_unref(entry->created);
-    g_date_time_unref(entry->expiry);
-    g_free(entry->etag);
+    start = start ? start + 3 : key;
+    path = strchr(start, '/');
 
-    entry->created = g_date_time_new_now_utc();
-    entry->expiry = g_date_time_ref(expiry);
-    entry->etag = g_strdup(etag);
+    *host = path ? g_strndup(start, path - start) : g_strdup(start);
+
+    if (!path)
+    {
+        *category = g_strdup("/");
+        return;
+    }
+
+    path++;
+    end = path + strcspn(path, "/?#");
+
+    *category = end > path ? g_strndup(path, end - path) : g_strdup("/");
 }
 
 static void
-gt_cache_file_entry_free(GtCacheFileEntry* entry)
+add_group_totals(GHashTable* table, const gchar* name, guint64 size)
 {
-    if (!entry) return;
+    guint64* totals = g_hash_table_lookup(table, name);
 
-    g_free(entry->key);
-    if (entry->created) g_date_time_unref(entry->created);
-    if (entry->expiry) g_date_time_unref(entry->expiry);
-    g_free(entry->etag);
-    g_slice_free(GtCacheFileEntry, entry);
-}
+    if (!totals)
+    {
+        totals = g_new0(guint64, 2);
+        g_hash_table_insert(table, g_strdup(name), totals);
+    }
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtCacheFileEntry, gt_cache_file_entry_free)
+    totals[0]++;
+    totals[1] += size;
+}
 
-static void
-save_db(GtCacheFile* self)
+static GVariant*
+group_totals_to_variant(GHashTable* table)
 {
-    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
-
-    g_autofree gchar* filename = g_build_filename(priv->cache_directory, "cache.json", NULL);
-    g_autoptr(GError) err = NULL;
+    GVariantBuilder builder;
     GHashTableIter iter;
-    gpointer key = NULL;
-    gpointer value = NULL;
-    g_autoptr(JsonBuilder) builder = json_builder_new();
-    g_autoptr(JsonGenerator) generator = NULL;
+    gpointer key;
+    gpointer value;
 
-    g_hash_table_iter_init(&iter, priv->db);
-    json_builder_begin_object(builder);
-    while(g_hash_table_iter_next(&iter, &key, &value))
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a{s(tt)}"));
+
+    g_hash_table_iter_init(&iter, table);
+    while (g_hash_table_iter_next(&iter, &key, &value))
     {
-        RETURN_IF_FAIL(value != NULL);
+        const guint64* totals = value;
 
-        const gchar* id = key;
-        const GtCacheFileEntry* entry = value;
+        g_variant_builder_add(&builder, "{s(tt)}", key, totals[0], totals[1]);
+    }
+
+    return g_variant_builder_end(&builder);
+}
 
-        json_builder_set_member_name(builder, id);
-        json_builder_begin_object(builder);
+/* NOTE: Content files that no live entry refers to */
+static void
+count_orphans(GtCacheFile* self, GArray* entries, guint64* count, guint64* size)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
-        json_builder_set_member_name(builder, ID_MEMBER_NAME);
-        json_builder_add_string_value(builder, entry->id);
+    g_autoptr(GHashTable) ids = g_hash_table_new(g_str_hash, g_str_equal);
+    g_autoptr(GPtrArray) files = g_ptr_array_new_with_free_func(g_free);
 
-        json_builder_set_member_name(builder, CREATED_MEMBER_NAME);
-        json_builder_add_int_value(builder, g_date_time_to_unix(entry->created));
+    *count = 0;
+    *size = 0;
 
-        json_builder_set_member_name(builder, EXPIRY_MEMBER_NAME);
-        json_builder_add_int_value(builder, g_date_time_to_unix(entry->expiry));
+    for (guint i = 0; i < entries->len; i++)
+        g_hash_table_add(ids, g_array_index(entries, GtCacheFileEntry, i).id);
 
-        json_builder_set_member_name(builder, ETAG_MEMBER_NAME);
-        json_builder_add_string_value(builder, entry->etag);
+    list_content_files(priv->cache_directory, files);
 
-        json_builder_end_object(builder);
-    }
-    json_builder_end_object(builder);
+    for (guint i = 0; i < files->len; i++)
+    {
+        const gchar* path = g_ptr_array_index(files, i);
+        g_autofree gchar* id = g_path_get_basename(path);
+        GStatBuf buf;
+
+        if (g_hash_table_contains(ids, id))
+            continue;
 
-    generator = json_generator_new();
-    json_generator_set_root(generator, json_builder_get_root(builder));
+        (*count)++;
 
-    json_generator_to_file(generator, filename, &err);
+        if (g_stat(path, &buf) == 0)
+            *size += buf.st_size;
+    }
+}
 
-    MESSAGE("Saved '%d' cache entries to file", g_hash_table_size(priv->db));
+static guint64
+file_size(GtCacheFilePrivate* priv, const gchar* name)
+{
+    g_autofree gchar* filename = g_build_filename(priv->cache_directory, name, NULL);
+    GStatBuf buf;
 
-    /* TODO: Put object into an error state */
-    RETURN_IF_ERROR(err);
+    return g_stat(filename, &buf) == 0 ? buf.st_size : 0;
 }
 
 static void
-load_db(GtCacheFile* self)
+save_session_stats(GtCacheFile* self)
 {
     GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
-    g_autofree gchar* filename = g_build_filename(priv->cache_directory, "cache.json", NULL);
+    g_autoptr(GKeyFile) key_file = g_key_file_new();
+    g_autofree gchar* filename = g_build_filename(priv->cache_directory, SESSION_STATS_FILENAME, NULL);
+    g_autoptr(GError) err = NULL;
+
+    g_key_file_set_uint64(key_file, "Session", "lookups", priv->session_lookups);
+    g_key_file_set_uint64(key_file, "Session", "hits", priv->session_hits);
+    g_key_file_set_int64(key_file, "Session", "ended", g_get_real_time() / G_USEC_PER_SEC);
 
-    if (!g_file_test(filename, G_FILE_TEST_EXISTS))
+    if (!g_key_file_save_to_file(key_file, filename, &err))
+        WARNING("Unable to save cache session stats because: %s", err->message);
+}
+
+/* NOTE: Returns a floating a{sv} describing what the cache holds:
+ * 'entries' and 'bytes', 'categories' and 'hosts' as a{s(tt)} of
+ * entries and bytes, 'ages' as a(stt) with the same per age bucket,
+ * 'orphans' and 'orphan-bytes' and, if a previous session left them,
+ * 'session-lookups', 'session-hits' and 'session-ended'. Blocks until
+ * the index is loaded. */
+GVariant*
+gt_cache_file_inspect(GtCacheFile* self)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(self), NULL);
+
+    static const struct
     {
-        INFO("No cache db file at '%s'", filename);
-        return;
-    }
+        const gchar* name;
+        gint64 max_age;
+    } AGE_BUCKETS[] =
+    {
+        {"1 hour", 60*60},
+        {"1 day", 24*60*60},
+        {"1 week", 7*24*60*60},
+        {"30 days", 30*24*60*60},
+        {"older", G_MAXINT64},
+    };
 
-    g_autoptr(JsonParser) parser = json_parser_new();
-    g_autoptr(JsonReader) reader = NULL;
-    g_autoptr(GError) err = NULL;
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
-    json_parser_load_from_file(parser, filename, &err);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+    g_autoptr(GArray) entries = NULL;
+    g_autoptr(GHashTable) categories = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    g_autoptr(GHashTable) hosts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    g_autoptr(GKeyFile) session = g_key_file_new();
+    g_autofree gchar* session_filename = g_build_filename(priv->cache_directory, SESSION_STATS_FILENAME, NULL);
+    guint64 age_totals[G_N_ELEMENTS(AGE_BUCKETS)][2] = {{0}};
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    guint64 bytes = 0;
+    guint64 orphans;
+    guint64 orphan_bytes;
+    GVariantBuilder builder;
+    GVariantBuilder ages;
 
-    /* TODO: Put object into an error state */
-    RETURN_IF_ERROR(err);
+    block_until_loaded(self);
 
-    reader = json_reader_new(json_parser_get_root(parser));
+    fill_entry_sizes(self);
 
-    /* TODO: Read version number */
+    entries = collect_entries(self);
 
-    for (gint i = 0; i < json_reader_count_members(reader); i++)
+    for (guint i = 0; i < entries->len; i++)
     {
-        g_autoptr(GtCacheFileEntry) entry = gt_cache_file_entry_new();
+        GtCacheFileEntry* entry = &g_array_index(entries, GtCacheFileEntry, i);
+        guint64 size = entry->size;
+        g_autofree gchar* host = NULL;
+        g_autofree gchar* category = NULL;
+        gint64 age = now - entry->created;
+        guint bucket = 0;
 
-        /* TODO: Handle error */
-        if (!json_reader_read_element(reader, i))
-            RETURN_IF_ERROR(json_reader_get_error(reader));
+        split_key(entry->key, &host, &category);
 
-        entry->key = g_strdup(json_reader_get_member_name(reader));
+        add_group_totals(hosts, host, size);
+        add_group_totals(categories, category, size);
 
-        RETURN_IF_FAIL(entry->key != NULL);
+        while (age > AGE_BUCKETS[bucket].max_age)
+            bucket++;
 
-        /* TODO: Handle error */
-        if (!json_reader_read_member(reader, ID_MEMBER_NAME))
-            RETURN_IF_ERROR(json_reader_get_error(reader));
-        RETURN_IF_FAIL(!json_reader_get_null_value(reader));
-        entry->id = g_strdup(json_reader_get_string_value(reader));
-        json_reader_end_member(reader);
+        age_totals[bucket][0]++;
+        age_totals[bucket][1] += size;
 
-        /* TODO: Put object into an error state */
-        if (!json_reader_read_member(reader, CREATED_MEMBER_NAME))
-            RETURN_IF_ERROR(json_reader_get_error(reader));
-        entry->created = g_date_time_new_from_unix_utc(json_reader_get_int_value(reader));
-        json_reader_end_member(reader);
+        bytes += size;
+    }
 
-        /* TODO: Put object into an error state */
-        if (!json_reader_read_member(reader, EXPIRY_MEMBER_NAME))
-            RETURN_IF_ERROR(json_reader_get_error(reader));
-        entry->expiry = g_date_time_new_from_unix_utc(json_reader_get_int_value(reader));
-        json_reader_end_member(reader);
+    count_orphans(self, entries, &orphans, &orphan_bytes);
 
-        /* TODO: Handle error */
-        if (!json_reader_read_member(reader, ETAG_MEMBER_NAME))
-            RETURN_IF_ERROR(json_reader_get_error(reader));
-        entry->etag = json_reader_get_null_value(reader) ?
-            NULL : g_strdup(json_reader_get_string_value(reader));
-        json_reader_end_member(reader);
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_init(&ages, G_VARIANT_TYPE("a(stt)"));
 
-        json_reader_end_element(reader);
+    for (guint i = 0; i < G_N_ELEMENTS(AGE_BUCKETS); i++)
+        g_variant_builder_add(&ages, "(stt)", AGE_BUCKETS[i].name, age_totals[i][0], age_totals[i][1]);
+
+    g_variant_builder_add(&builder, "{sv}", "entries", g_variant_new_uint64(entries->len));
+    g_variant_builder_add(&builder, "{sv}", "bytes", g_variant_new_uint64(bytes));
+    g_variant_builder_add(&builder, "{sv}", "categories", group_totals_to_variant(categories));
+    g_variant_builder_add(&builder, "{sv}", "hosts", group_totals_to_variant(hosts));
+    g_variant_builder_add(&builder, "{sv}", "ages", g_variant_builder_end(&ages));
+    g_variant_builder_add(&builder, "{sv}", "orphans", g_variant_new_uint64(orphans));
+    g_variant_builder_add(&builder, "{sv}", "orphan-bytes", g_variant_new_uint64(orphan_bytes));
 
-        g_hash_table_insert(priv->db, g_strdup(entry->key), entry);
-        g_steal_pointer(&entry);
+    if (g_key_file_load_from_file(session, session_filename, G_KEY_FILE_NONE, NULL))
+    {
+        g_variant_builder_add(&builder, "{sv}", "session-lookups",
+            g_variant_new_uint64(g_key_file_get_uint64(session, "Session", "lookups", NULL)));
+        g_variant_builder_add(&builder, "{sv}", "session-hits",
+            g_variant_new_uint64(g_key_file_get_uint64(session, "Session", "hits", NULL)));
+        g_variant_builder_add(&builder, "{sv}", "session-ended",
+            g_variant_new_int64(g_key_file_get_int64(session, "Session", "ended", NULL)));
     }
 
-    MESSAGE("Loaded '%d' cache entries from file", g_hash_table_size(priv->db));
+    return g_variant_builder_end(&builder);
 }
 
-static void
-write_data_cb(GObject* source,
-    GAsyncResult* res, gpointer udata)
+/* NOTE: Whether another instance has the cache directory open, in
+ * which case nothing is written and what's read may be behind */
+gboolean
+gt_cache_file_is_read_only(GtCacheFile* self)
 {
-    RETURN_IF_FAIL(G_IS_FILE(source));
-    RETURN_IF_FAIL(G_IS_ASYNC_RESULT(res));
-    RETURN_IF_FAIL(udata != NULL);
-
-    g_autoptr(GError) err = NULL;
-
-    g_file_replace_contents_finish(G_FILE(source), res, NULL, &err);
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(self), TRUE);
 
-    g_free(udata);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
-    if (err)
-        WARNING("Couldn't write cache file data because: %s, failing silently", err->message);
+    return priv->read_only;
 }
 
-static void
-save_data(GtCache* cache, const gchar* key, gconstpointer data, gsize length,
-    GDateTime* last_updated, GDateTime* expiry, const gchar* etag)
+/* NOTE: Returns a floating a{sv} with the index and journal before
+ * compaction and the number of entries the new index would hold. The
+ * index is only rewritten if 'dry_run' isn't set. Returns NULL if
+ * writing it failed. Blocks until the index is loaded. */
+GVariant*
+gt_cache_file_compact(GtCacheFile* self, gboolean dry_run)
 {
-    RETURN_IF_FAIL(GT_IS_CACHE_FILE(cache));
-    RETURN_IF_FAIL(!utils_str_empty(key));
-    RETURN_IF_FAIL(data != NULL && length != 0);
-    RETURN_IF_FAIL(!(last_updated == NULL && etag == NULL));
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(self), NULL);
 
-    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(GT_CACHE_FILE(cache));
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
-    GtCacheFileEntry* entry = NULL; /* NOTE: Don't free, owned by hash table */
-    g_autofree gchar* filename = NULL;
-    g_autoptr(GFile) file = NULL;
-    gpointer copied_data;
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+    g_autoptr(GArray) entries = NULL;
+    GVariantBuilder builder;
 
-    if ((entry = g_hash_table_lookup(priv->db, key)) != NULL)
-    {
-        gt_cache_file_entry_update(entry, expiry, etag);
-    }
-    else
-    {
-        entry = gt_cache_file_entry_new_with_params(key, expiry, etag);
+    block_until_loaded(self);
 
-        g_hash_table_insert(priv->db, g_strdup(key), entry);
-    }
+    entries = collect_entries(self);
 
-    filename = g_build_filename(priv->cache_directory, entry->id ,NULL);
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
 
-    file = g_file_new_for_path(filename);
+    g_variant_builder_add(&builder, "{sv}", "index-entries", g_variant_new_uint64(priv->index_n_entries));
+    g_variant_builder_add(&builder, "{sv}", "index-bytes", g_variant_new_uint64(file_size(priv, INDEX_FILENAME)));
+    g_variant_builder_add(&builder, "{sv}", "journal-records", g_variant_new_uint64(priv->journal_records));
+    g_variant_builder_add(&builder, "{sv}", "journal-bytes", g_variant_new_uint64(file_size(priv, JOURNAL_FILENAME)));
+    g_variant_builder_add(&builder, "{sv}", "live-entries", g_variant_new_uint64(entries->len));
+
+    g_clear_pointer(&entries, g_array_unref);
+
+    if (!dry_run)
+    {
+        if (!compact(self))
+        {
+            g_variant_builder_clear(&builder);
+            return NULL;
+        }
 
-    /* NOTE: Will be free'd in callback */
-    copied_data = g_memdup(data, length);
+        g_variant_builder_add(&builder, "{sv}", "compacted-index-bytes",
+            g_variant_new_uint64(file_size(priv, INDEX_FILENAME)));
+    }
 
-    g_file_replace_contents_async(file, copied_data, length, NULL, FALSE,
-        G_FILE_CREATE_REPLACE_DESTINATION, NULL, write_data_cb, copied_data);
+    return g_variant_builder_end(&builder);
 }
 
-gboolean
-is_data_stale(GtCache* cache, const gchar* key, GDateTime* last_updated, const gchar* etag)
+/* NOTE: Reads back every entry's content and checks that it exists,
+ * has the recorded size and, for content addressed entries, still
+ * hashes to its id. Returns a floating a{sv} with 'checked',
+ * 'missing', 'size-mismatch', 'corrupt', 'orphans' and 'problems' as
+ * a(ss) of key and reason. Nothing is changed, a bad entry is dropped
+ * the next time it's read. Blocks until the index is loaded. */
+GVariant*
+gt_cache_file_verify(GtCacheFile* self)
 {
-    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(cache), TRUE);
-    RETURN_VAL_IF_FAIL(!utils_str_empty(key), TRUE);
-    RETURN_VAL_IF_FAIL(!(last_updated == NULL && etag == NULL), TRUE);
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(self), NULL);
 
-    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(GT_CACHE_FILE(cache));
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
-    GtCacheFileEntry* entry = NULL; /* NOTE: Don't free, owned by hash table */
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+    g_autoptr(GArray) entries = NULL;
+    guint64 missing = 0;
+    guint64 size_mismatch = 0;
+    guint64 corrupt = 0;
+    guint64 orphans;
+    guint64 orphan_bytes;
+    GVariantBuilder builder;
+    GVariantBuilder problems;
+
+    block_until_loaded(self);
+
+    entries = collect_entries(self);
 
-    if ((entry = g_hash_table_lookup(priv->db, key)) != NULL)
+    g_variant_builder_init(&problems, G_VARIANT_TYPE("a(ss)"));
+
+    for (guint i = 0; i < entries->len; i++)
     {
-        g_autoptr(GDateTime) now = g_date_time_new_now_utc();
+        const GtCacheFileEntry* entry = &g_array_index(entries, GtCacheFileEntry, i);
+        g_autofree gchar* filename = NULL;
+        g_autofree gchar* contents = NULL;
+        g_autofree gchar* hash = NULL;
+        gsize length;
 
-        /* NOTE: Past expiry date */
-        if (g_date_time_compare(now, entry->expiry) == 1)
+        /* NOTE: Still waiting for the writer */
+        if (g_hash_table_contains(priv->pending, entry->id))
+            continue;
+
+        filename = content_path(priv, entry->id);
+
+        if (!g_file_get_contents(filename, &contents, &length, NULL))
         {
-            DEBUG("Cache miss: Past expiry date");
-            return TRUE;
+            missing++;
+            g_variant_builder_add(&problems, "(ss)", entry->key, "missing");
+            continue;
         }
 
-        /* NOTE: Check if newly updated */
-        if (last_updated && g_date_time_compare(last_updated, entry->created) == 1)
+        if (entry->size > 0 && entry->size != length)
         {
-            DEBUG("Cache miss: Newly updated");
-            return TRUE;
+            size_mismatch++;
+            g_variant_builder_add(&problems, "(ss)", entry->key, "size mismatch");
+            continue;
         }
 
-        /* NOTE: Check if etag differs */
-        if (etag && entry->etag && g_strcmp0(etag, entry->etag) != 0)
+        if (strlen(entry->id) != CONTENT_HASH_LENGTH)
+            continue;
+
+        hash = g_compute_checksum_for_data(G_CHECKSUM_SHA256, (const guchar*) contents, length);
+
+        if (g_strcmp0(hash, entry->id) != 0)
         {
-            DEBUG("Cache miss: Etags differ");
-            return TRUE;
+            corrupt++;
+            g_variant_builder_add(&problems, "(ss)", entry->key, "corrupt");
         }
     }
-    else
-        return TRUE; /* NOTE: Return true for data that doesn't exist */
 
-    return FALSE;
+    count_orphans(self, entries, &orphans, &orphan_bytes);
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+
+    g_variant_builder_add(&builder, "{sv}", "checked", g_variant_new_uint64(entries->len));
+    g_variant_builder_add(&builder, "{sv}", "missing", g_variant_new_uint64(missing));
+    g_variant_builder_add(&builder, "{sv}", "size-mismatch", g_variant_new_uint64(size_mismatch));
+    g_variant_builder_add(&builder, "{sv}", "corrupt", g_variant_new_uint64(corrupt));
+    g_variant_builder_add(&builder, "{sv}", "orphans", g_variant_new_uint64(orphans));
+    g_variant_builder_add(&builder, "{sv}", "problems", g_variant_builder_end(&problems));
+
+    return g_variant_builder_end(&builder);
 }
 
-GInputStream*
-get_data_stream(GtCache* cache, const gchar* key, GError** error)
+static void
+dispose(GObject* obj)
 {
-    RETURN_VAL_IF_FAIL(GT_IS_CACHE_FILE(cache), NULL);
-    RETURN_VAL_IF_FAIL(!utils_str_empty(key), NULL);
+    RETURN_IF_FAIL(GT_IS_CACHE_FILE(obj));
 
-    GtCacheFile* self = GT_CACHE_FILE(cache);
+    GtCacheFile* self = GT_CACHE_FILE(obj);
     GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
-    g_autofree gchar* filename = NULL;
-    g_autoptr(GFile) file = NULL;
-    const GtCacheFileEntry* entry = NULL;
-    g_autoptr(GInputStream) istream = NULL;
-    g_autoptr(GError) err = NULL;
-
-    entry = g_hash_table_lookup(priv->db, key);
-
-    if (entry == NULL)
+    GHashTableIter iter;
+    gpointer value;
+    g_autoptr(GMutexLocker) locker = NULL;
+
+    /* NOTE: Let the writer finish what's queued so the journal
+     * doesn't point at content that never made it to disk. A
+     * compaction that hasn't started yet is left to the loader on the
+     * next start. */
+    g_mutex_lock(&priv->mutex);
+    priv->writer_quit = TRUE;
+    priv->compact_requested = FALSE;
+    priv->sweep_requested = FALSE;
+    g_cond_signal(&priv->writer_cond);
+    g_mutex_unlock(&priv->mutex);
+
+    if (priv->writer)
     {
-        g_set_error(error, GT_CACHE_ERROR, GT_CACHE_ERROR_ENTRY_NOT_FOUND,
-            "Couldn't find entry for given key '%s'", key);
-
-        return NULL;
+        g_thread_join(priv->writer);
+        priv->writer = NULL;
     }
 
-    filename = g_build_filename(priv->cache_directory, entry->id, NULL);
+    locker = g_mutex_locker_new(&priv->mutex);
 
-    file = g_file_new_for_path(filename);
+    block_until_loaded(self);
 
-    istream = G_INPUT_STREAM(g_file_read(file, NULL, &err));
+    if (priv->session_lookups > 0 && !priv->read_only)
+        save_session_stats(self);
 
-    if (err)
+    /* NOTE: Access times and hits aren't worth a write on every read,
+     * they're journaled in one go here and lost on a crash */
+    g_hash_table_iter_init(&iter, priv->db);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
     {
-        g_propagate_prefixed_error(error, g_steal_pointer(&err),
-            "Unable to get data stream for '%s' because: ", filename);
-
-        return NULL;
-    }
-
-    return g_steal_pointer(&istream);
-}
+        GtCacheFileEntry* entry = value;
 
-static void
-dispose(GObject* obj)
-{
-    RETURN_IF_FAIL(GT_IS_CACHE_FILE(obj));
+        if (entry->touched && !entry->deleted)
+            append_journal(self, JOURNAL_OP_UPSERT, entry);
 
-    GtCacheFile* self = GT_CACHE_FILE(obj);
-    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+        entry->touched = FALSE;
+    }
 
-    save_db(self);
+    if (priv->sweep_source_id > 0)
+    {
+        g_source_remove(priv->sweep_source_id);
+        priv->sweep_source_id = 0;
+    }
 
-    g_hash_table_unref(priv->db);
+    /* NOTE: Compacting here would hold up quitting, the loader does
+     * it on the next start if the journal is still too long */
+    g_clear_object(&priv->journal);
 
     G_OBJECT_CLASS(gt_cache_file_parent_class)->dispose(obj);
 }
@@ -404,8 +2470,20 @@ finalize(GObject* obj)
     GtCacheFile* self = GT_CACHE_FILE(obj);
     GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
+    unmap_index(self);
+    g_hash_table_unref(priv->db);
+    g_hash_table_unref(priv->content_refs);
+    g_hash_table_unref(priv->pending);
+    g_queue_free_full(priv->pending_queue, g_free);
+    g_hash_table_unref(priv->compact_dirty);
+    g_cond_clear(&priv->writer_cond);
+    g_cond_clear(&priv->loaded_cond);
+    g_mutex_clear(&priv->mutex);
     g_free(priv->cache_directory);
 
+    if (priv->lock_fd >= 0)
+        close(priv->lock_fd);
+
     G_OBJECT_CLASS(gt_cache_file_parent_class)->finalize(obj);
 }
 
@@ -425,6 +2503,24 @@ get_property(GObject* obj,
         case PROP_CACHE_DIRECTORY:
             g_value_set_string(val, priv->cache_directory);
             break;
+        case PROP_MAX_SIZE:
+            g_value_set_uint64(val, priv->max_size);
+            break;
+        case PROP_SIZE:
+            g_value_set_uint64(val, priv->size);
+            break;
+        case PROP_EVICTED_ENTRIES:
+            g_value_set_uint64(val, priv->evicted_entries);
+            break;
+        case PROP_EVICTED_BYTES:
+            g_value_set_uint64(val, priv->evicted_bytes);
+            break;
+        case PROP_MAX_PENDING_SIZE:
+            g_value_set_uint64(val, priv->max_pending_size);
+            break;
+        case PROP_DURABILITY:
+            g_value_set_enum(val, priv->durability);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
     }
@@ -447,11 +2543,115 @@ set_property(GObject* obj,
             g_free(priv->cache_directory);
             priv->cache_directory = g_value_dup_string(val);
             break;
+        case PROP_MAX_SIZE:
+            priv->max_size = g_value_get_uint64(val);
+            break;
+        case PROP_MAX_PENDING_SIZE:
+            g_mutex_lock(&priv->mutex);
+            priv->max_pending_size = g_value_get_uint64(val);
+            g_mutex_unlock(&priv->mutex);
+            break;
+        case PROP_DURABILITY:
+            g_mutex_lock(&priv->mutex);
+            priv->durability = g_value_get_enum(val);
+            g_mutex_unlock(&priv->mutex);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
     }
 }
 
+static void
+set_loaded(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    g_mutex_lock(&priv->mutex);
+    priv->loaded = TRUE;
+    g_cond_broadcast(&priv->loaded_cond);
+    g_mutex_unlock(&priv->mutex);
+}
+
+/* NOTE: Runs in a thread so replaying the journal or importing the
+ * legacy db doesn't hold up the window being built. The db isn't
+ * locked while loading, see 'loaded'. */
+static void
+load_cb(GTask* task, gpointer source,
+    gpointer task_data, GCancellable* cancel)
+{
+    RETURN_IF_FAIL(GT_IS_CACHE_FILE(source));
+
+    GtCacheFile* self = GT_CACHE_FILE(source);
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    gint64 start = g_get_monotonic_time();
+    gboolean rewrite;
+    gboolean imported = FALSE;
+
+    map_index(self);
+
+    rewrite = !replay_journal(self);
+
+    /* NOTE: First start after upgrading, import the old JSON db once */
+    if (!priv->index && priv->journal_records == 0)
+        imported = load_legacy_db(self);
+
+    rewrite = rewrite || imported || should_compact(self);
+
+    if (!priv->read_only)
+        open_journal(self, FALSE);
+
+    if (rewrite && !priv->read_only && compact(self) && imported)
+    {
+        g_autofree gchar* legacy_filename = g_build_filename(priv->cache_directory, LEGACY_DB_FILENAME, NULL);
+
+        if (g_remove(legacy_filename) != 0)
+            WARNING("Unable to remove legacy cache db at '%s'", legacy_filename);
+    }
+
+    priv->load_time = g_get_monotonic_time() - start;
+
+    set_loaded(self);
+
+    MESSAGE("Loaded cache index in '%.2f' ms", priv->load_time / 1000.0);
+
+    g_task_return_boolean(task, TRUE);
+}
+
+static void
+lock_directory(GtCacheFile* self)
+{
+    GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
+
+    priv->lock_fd = g_open(priv->cache_directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC, 0);
+
+    if (priv->lock_fd < 0)
+    {
+        WARNING("Unable to lock cache directory at '%s' because: %s",
+            priv->cache_directory, g_strerror(errno));
+        return;
+    }
+
+    if (flock(priv->lock_fd, LOCK_EX | LOCK_NB) == 0)
+        return;
+
+    if (errno == EWOULDBLOCK)
+    {
+        MESSAGE("Cache directory at '%s' is in use by another instance, opening it read only",
+            priv->cache_directory);
+
+        priv->read_only = TRUE;
+    }
+    else
+    {
+        WARNING("Unable to lock cache directory at '%s' because: %s",
+            priv->cache_directory, g_strerror(errno));
+    }
+
+    close(priv->lock_fd);
+    priv->lock_fd = -1;
+}
+
 static void
 constructed(GObject* obj)
 {
@@ -460,6 +2660,8 @@ constructed(GObject* obj)
     GtCacheFile* self = GT_CACHE_FILE(obj);
     GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
+    g_autoptr(GTask) task = NULL;
+
     G_OBJECT_CLASS(gt_cache_file_parent_class)->constructed(obj);
 
     if (!g_file_test(priv->cache_directory, G_FILE_TEST_EXISTS))
@@ -474,11 +2676,19 @@ constructed(GObject* obj)
             WARNING("Unable to create cache directory at %s because: %s",
                 priv->cache_directory, err->message);
             /* TODO: Put us in some kind of 'unable to cache' state */
+            set_loaded(self);
             return;
         }
     }
 
-    load_db(self);
+    lock_directory(self);
+
+    if (!priv->read_only)
+        schedule_sweep(self, SWEEP_STARTUP_DELAY);
+
+    task = g_task_new(self, NULL, NULL, NULL);
+
+    g_task_run_in_thread(task, load_cb);
 }
 
 static void
@@ -487,6 +2697,8 @@ gt_cache_iface_init(GtCacheInterface* iface)
     iface->save_data = save_data;
     iface->get_data_stream = get_data_stream;
     iface->is_data_stale = is_data_stale;
+    iface->get_validators = get_validators;
+    iface->mark_data_fresh = mark_data_fresh;
 }
 
 static void
@@ -508,6 +2720,37 @@ gt_cache_file_class_init(GtCacheFileClass* klass)
         default_cache_directory, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
 
     g_object_class_override_property(obj_class, PROP_CACHE_DIRECTORY, "cache-directory");
+
+    props[PROP_MAX_SIZE] = g_param_spec_uint64("max-size",
+        "Max size", "Disk budget in bytes, 0 for unlimited",
+        0, G_MAXUINT64, DEFAULT_MAX_SIZE, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    props[PROP_SIZE] = g_param_spec_uint64("size",
+        "Size", "Bytes used as of the last sweep and saves since",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE);
+
+    props[PROP_EVICTED_ENTRIES] = g_param_spec_uint64("evicted-entries",
+        "Evicted entries", "Number of entries evicted this session",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE);
+
+    props[PROP_EVICTED_BYTES] = g_param_spec_uint64("evicted-bytes",
+        "Evicted bytes", "Number of bytes freed by evictions this session",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE);
+
+    props[PROP_MAX_PENDING_SIZE] = g_param_spec_uint64("max-pending-size",
+        "Max pending size", "Bytes that may wait in memory to be written, 0 for unlimited",
+        0, G_MAXUINT64, DEFAULT_MAX_PENDING_SIZE, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    props[PROP_DURABILITY] = g_param_spec_enum("durability",
+        "Durability", "How carefully content files are written",
+        GT_TYPE_CACHE_FILE_DURABILITY, GT_CACHE_FILE_DURABILITY_ATOMIC, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    g_object_class_install_property(obj_class, PROP_MAX_SIZE, props[PROP_MAX_SIZE]);
+    g_object_class_install_property(obj_class, PROP_SIZE, props[PROP_SIZE]);
+    g_object_class_install_property(obj_class, PROP_EVICTED_ENTRIES, props[PROP_EVICTED_ENTRIES]);
+    g_object_class_install_property(obj_class, PROP_EVICTED_BYTES, props[PROP_EVICTED_BYTES]);
+    g_object_class_install_property(obj_class, PROP_MAX_PENDING_SIZE, props[PROP_MAX_PENDING_SIZE]);
+    g_object_class_install_property(obj_class, PROP_DURABILITY, props[PROP_DURABILITY]);
 }
 
 static void
@@ -518,6 +2761,15 @@ gt_cache_file_init(GtCacheFile* self)
     GtCacheFilePrivate* priv = gt_cache_file_get_instance_private(self);
 
     priv->db = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) gt_cache_file_entry_free);
+    priv->content_refs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    priv->pending = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_bytes_unref);
+    priv->pending_queue = g_queue_new();
+    priv->compact_dirty = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    priv->lock_fd = -1;
+
+    g_mutex_init(&priv->mutex);
+    g_cond_init(&priv->writer_cond);
+    g_cond_init(&priv->loaded_cond);
 }
 
 GtCacheFile*
@@ -7,6 +7,17 @@ G_BEGIN_DECLS
 
 #define GT_TYPE_CACHE_FILE gt_cache_file_get_type()
 
+typedef enum
+{
+    GT_CACHE_FILE_DURABILITY_NONE,
+    GT_CACHE_FILE_DURABILITY_ATOMIC,
+    GT_CACHE_FILE_DURABILITY_SYNC,
+} GtCacheFileDurability;
+
+#define GT_TYPE_CACHE_FILE_DURABILITY gt_cache_file_durability_get_type()
+
+GType gt_cache_file_durability_get_type();
+
 G_DECLARE_FINAL_TYPE(GtCacheFile, gt_cache_file, GT, CACHE_FILE, GObject);
 
 struct _GtCacheFile
@@ -15,6 +26,11 @@ struct _GtCacheFile
 };
 
 GtCacheFile* gt_cache_file_new();
+GVariant*    gt_cache_file_get_stats(GtCacheFile* self);
+GVariant*    gt_cache_file_inspect(GtCacheFile* self);
+GVariant*    gt_cache_file_compact(GtCacheFile* self, gboolean dry_run);
+GVariant*    gt_cache_file_verify(GtCacheFile* self);
+gboolean     gt_cache_file_is_read_only(GtCacheFile* self);
 
 G_END_DECLS
 
@@ -60,3 +60,34 @@ gt_cache_is_data_stale(GtCache* cache, const gchar* key, GDateTime* last_updated
 
     return GT_CACHE_GET_IFACE(cache)->is_data_stale(cache, key, last_updated, etag);
 }
+
+/* NOTE: Gets what is needed to revalidate an entry with a conditional
+ * request, returns FALSE if there is nothing cached for the key. The
+ * validators are still returned for expired entries. */
+gboolean
+gt_cache_get_validators(GtCache* cache, const gchar* key, GDateTime** last_updated, gchar** etag)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE(cache), FALSE);
+
+    if (last_updated) *last_updated = NULL;
+    if (etag) *etag = NULL;
+
+    /* NOTE: Optional, implementations without it never revalidate */
+    if (GT_CACHE_GET_IFACE(cache)->get_validators == NULL)
+        return FALSE;
+
+    return GT_CACHE_GET_IFACE(cache)->get_validators(cache, key, last_updated, etag);
+}
+
+/* NOTE: Called when the server confirmed the entry is unchanged, a
+ * NULL expiry keeps the current one */
+void
+gt_cache_mark_data_fresh(GtCache* cache, const gchar* key, GDateTime* expiry)
+{
+    RETURN_IF_FAIL(GT_IS_CACHE(cache));
+
+    if (GT_CACHE_GET_IFACE(cache)->mark_data_fresh == NULL)
+        return;
+
+    GT_CACHE_GET_IFACE(cache)->mark_data_fresh(cache, key, expiry);
+}
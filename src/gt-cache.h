@@ -24,12 +24,16 @@ struct _GtCacheInterface
     void (*save_data) (GtCache* self, const gchar* key, gconstpointer data, gsize length, GDateTime* last_updated, GDateTime* expiry, const gchar* etag);
     GInputStream* (*get_data_stream) (GtCache* self, const gchar* key, GError** error);
     gboolean (*is_data_stale) (GtCache* self, const gchar* key, GDateTime* last_updated, const gchar* etag);
+    gboolean (*get_validators) (GtCache* self, const gchar* key, GDateTime** last_updated, gchar** etag);
+    void (*mark_data_fresh) (GtCache* self, const gchar* key, GDateTime* expiry);
 };
 
 /* TODO: Add docs */
 void gt_cache_save_data(GtCache* self, const gchar* key, gconstpointer data, gsize length, GDateTime* last_updated, GDateTime* expiry, const gchar* etag);
 GInputStream* gt_cache_get_data_stream(GtCache* self, const gchar* key, GError** error);
 gboolean gt_cache_is_data_stale(GtCache* self, const gchar* key, GDateTime* last_updated, const gchar* etag);
+gboolean gt_cache_get_validators(GtCache* self, const gchar* key, GDateTime** last_updated, gchar** etag);
+void gt_cache_mark_data_fresh(GtCache* self, const gchar* key, GDateTime* expiry);
 
 G_END_DECLS
 
@@ -74,6 +74,17 @@ create_child(GtItemContainer* item_container, gpointer data)
     return GTK_WIDGET(gt_vod_container_child_new(GT_VOD(data)));
 }
 
+static void
+bind_child(GtItemContainer* item_container,
+    GtkWidget* child, gpointer data)
+{
+    RETURN_IF_FAIL(GT_IS_CHANNEL_VOD_CONTAINER(item_container));
+    RETURN_IF_FAIL(GT_IS_VOD_CONTAINER_CHILD(child));
+    RETURN_IF_FAIL(GT_IS_VOD(data));
+
+    g_object_set(child, "vod", data, NULL);
+}
+
 static void
 activate_child(GtItemContainer* item_container, gpointer child)
 {
@@ -270,6 +281,7 @@ gt_channel_vod_container_class_init(GtChannelVODContainerClass* klass)
     GT_ITEM_CONTAINER_CLASS(klass)->get_container_properties = get_container_properties;
     GT_ITEM_CONTAINER_CLASS(klass)->request_extra_items = request_extra_items;
     GT_ITEM_CONTAINER_CLASS(klass)->create_child = create_child;
+    GT_ITEM_CONTAINER_CLASS(klass)->bind_child = bind_child;
     GT_ITEM_CONTAINER_CLASS(klass)->activate_child = activate_child;
 
     props[PROP_CHANNEL_ID] = g_param_spec_string("channel-id", "Channel ID", "ID of the currently open channel",
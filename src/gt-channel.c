@@ -28,17 +28,38 @@
 
 #define N_JSON_PROPS 2
 
+#define PREVIEW_WIDTH 320
+#define PREVIEW_HEIGHT 180
+
+/* NOTE: Twitch regenerates live previews every few minutes, keep them
+ * for less than the auto update interval so that still fetches */
+#define LIVE_PREVIEW_TTL 60
+
+/* NOTE: Auto update intervals in seconds */
+#define UPDATE_INTERVAL_WATCHING 60
+#define UPDATE_INTERVAL_ONLINE 120
+#define UPDATE_INTERVAL_OFFLINE 300
+#define UPDATE_INTERVAL_LONG_OFFLINE 900
+#define LONG_OFFLINE_TIME 3600*G_USEC_PER_SEC
+
 typedef struct
 {
     GtChannelData* data;
 
     GdkPixbuf* preview;
+    gchar* preview_uri;
 
     gboolean followed;
 
     gboolean auto_update;
+    gboolean watching;
     gboolean updating;
 
+    gboolean in_view;
+    gboolean preview_pending; /* NOTE: Waiting to come into view */
+
+    gint64 offline_since; /* NOTE: Monotonic, 0 if online */
+
     gboolean error;
     gchar* error_message;
     gchar* error_details;
@@ -48,6 +69,7 @@ typedef struct
     JsonParser* json_parser;
 
     GCancellable* cancel;
+    GCancellable* preview_cancel; /* NOTE: Cancelled on its own when scrolled away */
 } GtChannelPrivate;
 
 G_DEFINE_TYPE_WITH_CODE(GtChannel, gt_channel, G_TYPE_INITIALLY_UNOWNED,
@@ -71,6 +93,8 @@ enum
     PROP_FOLLOWED,
     PROP_ONLINE,
     PROP_AUTO_UPDATE,
+    PROP_WATCHING,
+    PROP_IN_VIEW,
     PROP_UPDATING,
     PROP_ERROR,
     NUM_PROPS
@@ -78,44 +102,29 @@ enum
 
 static GParamSpec* props[NUM_PROPS];
 
-static void
-channel_followed_cb(GtFollowsManager* mgr,
-    GtChannel* chan, gpointer udata)
-{
-    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(mgr));
-    RETURN_IF_FAIL(GT_IS_CHANNEL(chan));
-    RETURN_IF_FAIL(GT_IS_CHANNEL(udata));
+/* NOTE: Every view gets the same GtChannel for a given id so there is
+ * only one refresh and one preview per channel. The channels are also
+ * created on the GtTwitch worker threads, hence the lock. */
+static GMutex registry_mutex;
+static GHashTable* registry = NULL; /* NOTE: Maps ids to weak refs */
 
-    GtChannel* self = GT_CHANNEL(udata);
+/* NOTE: Channels being watched are kept fresh, channels that have
+ * been offline for a while are unlikely to change soon */
+static guint
+get_update_interval(GtChannel* self)
+{
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
 
-    if (!gt_channel_compare(self, chan) && !priv->followed)
-    {
-        GQuark detail = g_quark_from_static_string("followed");
-        g_signal_handlers_block_matched(self, G_SIGNAL_MATCH_DATA | G_SIGNAL_MATCH_DETAIL, 0, detail, NULL, NULL, main_app->fav_mgr);
-        g_object_set(self, "followed", TRUE, NULL);
-        g_signal_handlers_unblock_matched(self, G_SIGNAL_MATCH_DATA | G_SIGNAL_MATCH_DETAIL, 0, detail, NULL, NULL, main_app->fav_mgr);
-    }
-}
+    if (priv->watching)
+        return UPDATE_INTERVAL_WATCHING;
 
-static void
-channel_unfollowed_cb(GtFollowsManager* mgr,
-    GtChannel* chan, gpointer udata)
-{
-    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(mgr));
-    RETURN_IF_FAIL(GT_IS_CHANNEL(chan));
-    RETURN_IF_FAIL(GT_IS_CHANNEL(udata));
+    if (priv->data && priv->data->online)
+        return UPDATE_INTERVAL_ONLINE;
 
-    GtChannel* self = GT_CHANNEL(udata);
-    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+    if (priv->offline_since > 0 && g_get_monotonic_time() - priv->offline_since > LONG_OFFLINE_TIME)
+        return UPDATE_INTERVAL_LONG_OFFLINE;
 
-    if (!gt_channel_compare(self, chan) && priv->followed)
-    {
-        GQuark detail = g_quark_from_static_string("followed");
-        g_signal_handlers_block_matched(self, G_SIGNAL_MATCH_DATA | G_SIGNAL_MATCH_DETAIL, 0, detail, NULL, NULL, main_app->fav_mgr);
-        g_object_set(self, "followed", FALSE, NULL);
-        g_signal_handlers_unblock_matched(self, G_SIGNAL_MATCH_DATA | G_SIGNAL_MATCH_DETAIL, 0, detail, NULL, NULL, main_app->fav_mgr);
-    }
+    return UPDATE_INTERVAL_OFFLINE;
 }
 
 static gboolean
@@ -134,31 +143,41 @@ auto_update_cb(gpointer udata)
         return G_SOURCE_REMOVE;
     }
 
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    /* NOTE: The auto update category is held back while a stream is
+     * playing, which would hold back the channel being played too */
     g_object_set_data_full(G_OBJECT(self), "category",
-        g_strdup("gt-channel-auto-update"), g_free);
+        g_strdup(priv->watching ? "gt-channel" : "gt-channel-auto-update"), g_free);
 
     gt_channel_update(self);
 
+    gt_scheduler_set_interval(main_app->scheduler, priv->update_id, get_update_interval(self));
+
     return G_SOURCE_CONTINUE;
 }
 
-/* TODO: Move this into set_property */
+/* NOTE: Registers with the central scheduler instead of running a
+ * timer per channel, which would all fire at once for the follows */
 static void
-auto_update_set_cb(GObject* src,
-    GParamSpec* pspec, gpointer udata)
+update_schedule(GtChannel* self)
 {
-    RETURN_IF_FAIL(GT_IS_CHANNEL(src));
-
-    GtChannel* self = GT_CHANNEL(src);
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
 
-    if (priv->auto_update)
+    gboolean scheduled = priv->auto_update || priv->watching;
+
+    if (scheduled && priv->update_id == 0)
     {
-        priv->update_id = g_timeout_add_seconds_full(G_PRIORITY_LOW, 120, /* TODO: Add the timeout as a setting */
+        priv->update_id = gt_scheduler_add(main_app->scheduler, get_update_interval(self),
             auto_update_cb, utils_weak_ref_new(self), (GDestroyNotify) utils_weak_ref_free);
     }
-    else
-        g_source_remove(priv->update_id);
+    else if (!scheduled && priv->update_id > 0)
+    {
+        gt_scheduler_remove(main_app->scheduler, priv->update_id);
+        priv->update_id = 0;
+    }
+    else if (scheduled)
+        gt_scheduler_set_interval(main_app->scheduler, priv->update_id, get_update_interval(self));
 }
 
 static gboolean
@@ -180,6 +199,21 @@ notify_preview_cb(gpointer udata)
     return G_SOURCE_REMOVE;
 }
 
+static void update_preview(GtChannel* self);
+
+static void
+preview_cancelled(GtChannel* self)
+{
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    /* NOTE: Scrolled back into view before the cancelled download
+     * got back to us */
+    if (priv->preview_pending && priv->in_view)
+        update_preview(self);
+    else
+        notify_preview_cb(self);
+}
+
 static void
 handle_preview_download_cb(GObject* source,
     GAsyncResult* res, gpointer udata)
@@ -194,10 +228,25 @@ handle_preview_download_cb(GObject* source,
 
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
     g_autoptr(GError) err = NULL;
-
-    priv->preview = gdk_pixbuf_new_from_stream_finish(res, &err);
+    g_autoptr(GdkPixbuf) preview = gdk_pixbuf_new_from_stream_finish(res, &err);
 
     if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        preview_cancelled(self);
+
+        return;
+    }
+
+    g_clear_object(&priv->preview);
+    priv->preview = g_steal_pointer(&preview);
+
+    if (priv->preview && !utils_str_empty(priv->preview_uri))
+    {
+        gt_image_cache_insert(main_app->image_cache, priv->preview_uri, PREVIEW_WIDTH, PREVIEW_HEIGHT,
+            priv->preview, priv->data->online ? LIVE_PREVIEW_TTL : 0);
+    }
+
+    if (err)
     {
         WARNING("Unable to download preview because: %s", err->message);
 
@@ -223,23 +272,26 @@ handle_preview_response_cb(GtHTTP* http, gpointer ret,
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
     GInputStream* istream = ret;
 
-    if (error)
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
     {
-        if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-        {
-            WARNING("Unable to send request to download preview because: %s", error->message);
+        preview_cancelled(self);
 
-            priv->error_message = g_strdup_printf(_("Unable to update preview image"));
-            priv->error_details = g_strdup_printf(_("Unable to update preveiw image because: %s"), error->message);
-        }
+        return;
+    }
+    else if (error)
+    {
+        WARNING("Unable to send request to download preview because: %s", error->message);
+
+        priv->error_message = g_strdup_printf(_("Unable to update preview image"));
+        priv->error_details = g_strdup_printf(_("Unable to update preveiw image because: %s"), error->message);
 
         notify_preview_cb(self);
 
         return;
     }
 
-    gdk_pixbuf_new_from_stream_at_scale_async(istream, 320, 180, FALSE,
-        priv->cancel, handle_preview_download_cb, g_steal_pointer(&ref));
+    gdk_pixbuf_new_from_stream_at_scale_async(istream, PREVIEW_WIDTH, PREVIEW_HEIGHT, FALSE,
+        priv->preview_cancel, handle_preview_download_cb, g_steal_pointer(&ref));
 }
 
 static void
@@ -249,24 +301,58 @@ update_preview(GtChannel* self)
 
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
     g_autoptr(GError) err = NULL;
+    g_autoptr(GdkPixbuf) cached = NULL;
+
+    g_free(priv->preview_uri);
+    priv->preview_uri = g_strdup(priv->data->online ?
+        priv->data->preview_url : priv->data->video_banner_url);
+
+    /* NOTE: Already decoded for another view */
+    if ((cached = gt_image_cache_lookup(main_app->image_cache, priv->preview_uri, PREVIEW_WIDTH, PREVIEW_HEIGHT)) != NULL)
+    {
+        priv->preview_pending = FALSE;
+
+        g_clear_object(&priv->preview);
+        priv->preview = g_steal_pointer(&cached);
+
+        notify_preview_cb(self);
+
+        return;
+    }
+
+    /* NOTE: Leave the download until the channel is scrolled near so
+     * the ones in view get the bandwidth */
+    if (!priv->in_view)
+    {
+        priv->preview_pending = TRUE;
+
+        notify_preview_cb(self);
+
+        return;
+    }
+
+    priv->preview_pending = FALSE;
+
+    utils_refresh_cancellable(&priv->preview_cancel);
 
     if (priv->data->online)
     {
         gt_http_get_with_category(main_app->http, priv->data->preview_url, g_object_get_data(G_OBJECT(self), "category"),
-            DEFAULT_TWITCH_HEADERS, priv->cancel, G_CALLBACK(handle_preview_response_cb), utils_weak_ref_new(self),
+            DEFAULT_TWITCH_HEADERS, priv->preview_cancel, G_CALLBACK(handle_preview_response_cb), utils_weak_ref_new(self),
             GT_HTTP_FLAG_RETURN_STREAM);
     }
     else if (!utils_str_empty(priv->data->video_banner_url))
     {
         g_object_set_data_full(G_OBJECT(self), "category", g_strdup("gt-channel-auto-update"), g_free);
         gt_http_get_with_category(main_app->http, priv->data->video_banner_url, g_object_get_data(G_OBJECT(self), "category"),
-            DEFAULT_TWITCH_HEADERS, priv->cancel, G_CALLBACK(handle_preview_response_cb), utils_weak_ref_new(self),
+            DEFAULT_TWITCH_HEADERS, priv->preview_cancel, G_CALLBACK(handle_preview_response_cb), utils_weak_ref_new(self),
             GT_HTTP_FLAG_RETURN_STREAM | GT_HTTP_FLAG_CACHE_RESPONSE);
     }
     else
     {
+        g_clear_object(&priv->preview);
         priv->preview = gdk_pixbuf_new_from_resource_at_scale(
-            "/com/vinszent/GnomeTwitch/icons/offline-cover.png", 320, 180, FALSE, &err);
+            "/com/vinszent/GnomeTwitch/icons/offline-cover.png", PREVIEW_WIDTH, PREVIEW_HEIGHT, FALSE, &err);
 
         if (err)
         {
@@ -283,6 +369,59 @@ update_preview(GtChannel* self)
     g_object_set_data_full(G_OBJECT(self), "category", g_strdup("gt-channel"), g_free);
 }
 
+/* NOTE: The image cache keeps its own reference for as long as its
+ * budget allows, so coming back into view is usually just a lookup */
+static void
+release_preview(GtChannel* self)
+{
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    g_cancellable_cancel(priv->preview_cancel);
+
+    /* NOTE: Still waiting for its data, nothing to let go of */
+    if (!priv->data)
+        return;
+
+    priv->preview_pending = TRUE;
+
+    if (priv->preview)
+    {
+        g_clear_object(&priv->preview);
+        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PREVIEW]);
+    }
+}
+
+static void
+set_in_view(GtChannel* self, gboolean in_view)
+{
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    if (priv->in_view == in_view)
+        return;
+
+    priv->in_view = in_view;
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_IN_VIEW]);
+
+    if (!in_view)
+    {
+        release_preview(self);
+
+        return;
+    }
+
+    /* NOTE: Still waiting for its data, it will get the preview with it */
+    if (main_app->hydration_queue)
+        gt_hydration_queue_promote(main_app->hydration_queue, G_OBJECT(self));
+
+    if (priv->preview_pending && !priv->updating)
+    {
+        priv->updating = TRUE;
+        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_UPDATING]);
+
+        update_preview(self);
+    }
+}
+
 static void
 update_from_data(GtChannel* self, GtChannelData* data)
 {
@@ -298,6 +437,11 @@ update_from_data(GtChannel* self, GtChannelData* data)
 
     priv->data = data;
 
+    if (data->online)
+        priv->offline_since = 0;
+    else if (priv->offline_since == 0)
+        priv->offline_since = g_get_monotonic_time();
+
     if (old_data)
     {
         if (!STRING_EQUALS(old_data->id, data->id))
@@ -349,7 +493,12 @@ update_from_data(GtChannel* self, GtChannelData* data)
         if (!STRING_EQUALS(old_data->profile_url, data->profile_url))
             g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PROFILE_URL]);
         if (old_data->online != data->online)
+        {
             g_object_notify_by_pspec(G_OBJECT(self), props[PROP_ONLINE]);
+
+            if (priv->update_id > 0)
+                update_schedule(self);
+        }
         if (old_data->viewers != data->viewers)
             g_object_notify_by_pspec(G_OBJECT(self), props[PROP_VIEWERS]);
         if (data->stream_started_time && old_data->stream_started_time &&
@@ -579,8 +728,10 @@ dispose(GObject* object)
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
 
     g_cancellable_cancel(priv->cancel);
+    g_cancellable_cancel(priv->preview_cancel);
 
     g_clear_object(&priv->cancel);
+    g_clear_object(&priv->preview_cancel);
     g_clear_object(&priv->preview);
 
     G_OBJECT_CLASS(gt_channel_parent_class)->dispose(object);
@@ -592,13 +743,13 @@ finalize(GObject* object)
     GtChannel* self = (GtChannel*) object;
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
 
-    gt_channel_data_free(priv->data);
+    registry_remove(self);
 
-    if (priv->update_id > 0)
-        g_source_remove(priv->update_id);
+    gt_channel_data_free(priv->data);
+    g_free(priv->preview_uri);
 
-    g_signal_handlers_disconnect_by_func(main_app->fav_mgr, channel_followed_cb, self);
-    g_signal_handlers_disconnect_by_func(main_app->fav_mgr, channel_unfollowed_cb, self);
+    if (priv->update_id > 0 && main_app->scheduler)
+        gt_scheduler_remove(main_app->scheduler, priv->update_id);
 
     G_OBJECT_CLASS(gt_channel_parent_class)->finalize(object);
 }
@@ -658,6 +809,12 @@ get_property (GObject*    obj,
         case PROP_AUTO_UPDATE:
             g_value_set_boolean(val, priv->auto_update);
             break;
+        case PROP_WATCHING:
+            g_value_set_boolean(val, priv->watching);
+            break;
+        case PROP_IN_VIEW:
+            g_value_set_boolean(val, priv->in_view);
+            break;
         case PROP_UPDATING:
             g_value_set_boolean(val, priv->updating);
             break;
@@ -688,6 +845,14 @@ set_property(GObject*      obj,
             break;
         case PROP_AUTO_UPDATE:
             priv->auto_update = g_value_get_boolean(val);
+            update_schedule(self);
+            break;
+        case PROP_WATCHING:
+            priv->watching = g_value_get_boolean(val);
+            update_schedule(self);
+            break;
+        case PROP_IN_VIEW:
+            set_in_view(self, g_value_get_boolean(val));
             break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
@@ -753,6 +918,12 @@ gt_channel_class_init(GtChannelClass* klass)
     props[PROP_AUTO_UPDATE] = g_param_spec_boolean("auto-update", "Auto Update", "Whether it should update itself automatically",
         FALSE, G_PARAM_READWRITE);
 
+    props[PROP_WATCHING] = g_param_spec_boolean("watching", "Watching", "Whether the channel is being watched",
+        FALSE, G_PARAM_READWRITE);
+
+    props[PROP_IN_VIEW] = g_param_spec_boolean("in-view", "In view", "Whether the channel is shown in or near a view",
+        FALSE, G_PARAM_READWRITE);
+
     props[PROP_ERROR] = g_param_spec_boolean("error", "Error", "Whether in error state",
         FALSE, G_PARAM_READABLE);
 
@@ -770,6 +941,7 @@ gt_channel_init(GtChannel* self)
     priv->data = NULL;
     priv->updating = FALSE;
     priv->cancel = g_cancellable_new();
+    priv->preview_cancel = g_cancellable_new();
 
     priv->update_id = 0;
 
@@ -778,28 +950,157 @@ gt_channel_init(GtChannel* self)
 
     priv->json_parser = json_parser_new();
 
-    g_signal_connect(self, "notify::auto-update", G_CALLBACK(auto_update_set_cb), NULL);
-    g_signal_connect(main_app->fav_mgr, "channel-followed", G_CALLBACK(channel_followed_cb), self);
-    g_signal_connect(main_app->fav_mgr, "channel-unfollowed", G_CALLBACK(channel_unfollowed_cb), self);
-
     gt_follows_manager_attach_to_channel(main_app->fav_mgr, self);
 
     /* NOTE: Set the initial category to the 'default' one */
     g_object_set_data_full(G_OBJECT(self), "category", g_strdup("gt-channel"), g_free);
 }
 
+static GtChannel*
+registry_lookup(const gchar* id)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&registry_mutex);
+    GWeakRef* ref = NULL;
+
+    if (!registry || (ref = g_hash_table_lookup(registry, id)) == NULL)
+        return NULL;
+
+    return g_weak_ref_get(ref);
+}
+
+/* NOTE: Registers the channel unless another one with the same id got
+ * there first, in which case a ref to that one is returned instead */
+static GtChannel*
+registry_insert(GtChannel* self)
+{
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&registry_mutex);
+    GtChannel* existing = NULL;
+    GWeakRef* ref = NULL;
+
+    if (!registry)
+    {
+        registry = g_hash_table_new_full(g_str_hash, g_str_equal,
+            g_free, (GDestroyNotify) utils_weak_ref_free);
+    }
+    else if ((ref = g_hash_table_lookup(registry, priv->data->id)) != NULL
+        && (existing = g_weak_ref_get(ref)) != NULL)
+    {
+        return existing;
+    }
+
+    g_hash_table_replace(registry, g_strdup(priv->data->id), utils_weak_ref_new(self));
+
+    return NULL;
+}
+
+static void
+registry_remove(GtChannel* self)
+{
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    /* NOTE: Declared before the locker so it's dropped after the mutex
+     * is released, dropping the last ref would finalize it and land
+     * right back in here */
+    g_autoptr(GtChannel) current = NULL;
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&registry_mutex);
+    GWeakRef* ref = NULL;
+
+    if (!registry || !priv->data || (ref = g_hash_table_lookup(registry, priv->data->id)) == NULL)
+        return;
+
+    /* NOTE: Another channel with the same id may have been registered
+     * after we lost our last reference */
+    if ((current = g_weak_ref_get(ref)) == NULL)
+        g_hash_table_remove(registry, priv->data->id);
+}
+
+typedef struct
+{
+    GtChannel* channel;
+    GtChannelData* data;
+} MergeData;
+
+/* NOTE: Listings of channels don't say whether they're live, so they
+ * don't get to take the stream away from a channel we know is live.
+ * The auto update will notice when it actually goes offline. */
+static gboolean
+merge_data_cb(gpointer udata)
+{
+    MergeData* merge = udata;
+    GtChannelPrivate* priv = gt_channel_get_instance_private(merge->channel);
+    GtChannelData* data = merge->data;
+
+    if (priv->data && priv->data->online && !data->online)
+    {
+        data->online = TRUE;
+        data->viewers = priv->data->viewers;
+        g_free(data->preview_url);
+        data->preview_url = g_strdup(priv->data->preview_url);
+        if (priv->data->stream_started_time && !data->stream_started_time)
+            data->stream_started_time = g_date_time_ref(priv->data->stream_started_time);
+    }
+
+    gt_channel_update_from_data(merge->channel, data);
+
+    g_object_unref(merge->channel);
+    g_slice_free(MergeData, merge);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+hydrate_cb(GObject* item)
+{
+    gt_channel_update(GT_CHANNEL(item));
+}
+
+static void
+merge_data(GtChannel* channel, GtChannelData* data)
+{
+    MergeData* merge = g_slice_new0(MergeData);
+
+    merge->channel = g_object_ref(channel);
+    merge->data = data;
+
+    /* NOTE: Runs right away on the main thread */
+    g_main_context_invoke(NULL, merge_data_cb, merge);
+}
+
 GtChannel*
 gt_channel_new(GtChannelData* data)
 {
     RETURN_VAL_IF_FAIL(data != NULL, NULL);
 
-    GtChannel* channel = g_object_new(GT_TYPE_CHANNEL, NULL);
-    GtChannelPrivate* priv = gt_channel_get_instance_private(channel);
+    GtChannel* channel = registry_lookup(data->id);
+    GtChannel* existing = NULL;
+    GtChannelPrivate* priv = NULL;
+
+    if (channel)
+    {
+        merge_data(channel, data);
+
+        return channel;
+    }
+
+    channel = g_object_ref_sink(g_object_new(GT_TYPE_CHANNEL, NULL));
+    priv = gt_channel_get_instance_private(channel);
 
     update_from_data(channel, data);
 
     priv->followed = gt_follows_manager_is_channel_followed(main_app->fav_mgr, channel);
 
+    /* NOTE: Another thread registered the same channel while we were
+     * building ours, keep theirs and give it our data instead */
+    if ((existing = registry_insert(channel)) != NULL)
+    {
+        merge_data(existing, g_steal_pointer(&priv->data));
+        g_object_unref(channel);
+
+        return existing;
+    }
+
     return channel;
 }
 
@@ -809,22 +1110,48 @@ gt_channel_new_from_id_and_name(const gchar* id, const gchar* name)
     RETURN_VAL_IF_FAIL(!utils_str_empty(id), NULL);
     RETURN_VAL_IF_FAIL(!utils_str_empty(name), NULL);
 
-    GtChannel* channel = g_object_new(GT_TYPE_CHANNEL, NULL);
-    GtChannelPrivate* priv = gt_channel_get_instance_private(channel);
-    GtChannelData* data = gt_channel_data_new();
+    GtChannel* channel = registry_lookup(id);
+    GtChannel* existing = NULL;
+    GtChannelPrivate* priv = NULL;
+    GtChannelData* data = NULL;
+
+    if (channel)
+        return channel;
+
+    channel = g_object_ref_sink(g_object_new(GT_TYPE_CHANNEL, NULL));
+    priv = gt_channel_get_instance_private(channel);
+    data = gt_channel_data_new();
 
     data->id = g_strdup(id);
     data->name = g_strdup(name);
 
     priv->data = data;
+    priv->followed = gt_follows_manager_is_channel_followed(main_app->fav_mgr, channel);
 
-    gt_channel_update(channel);
+    if ((existing = registry_insert(channel)) != NULL)
+    {
+        g_object_unref(channel);
 
-    priv->followed = gt_follows_manager_is_channel_followed(main_app->fav_mgr, channel);
+        return existing;
+    }
+
+    /* NOTE: Only the id and name are known, the rest is filled in when
+     * there's room for it so loading a lot of these doesn't send every
+     * request at once */
+    priv->updating = TRUE;
+    gt_hydration_queue_add(main_app->hydration_queue, G_OBJECT(channel), hydrate_cb);
 
     return channel;
 }
 
+GtChannel*
+gt_channel_lookup(const gchar* id)
+{
+    RETURN_VAL_IF_FAIL(!utils_str_empty(id), NULL);
+
+    return registry_lookup(id);
+}
+
 void
 gt_channel_toggle_followed(GtChannel* self)
 {
@@ -909,6 +1236,16 @@ gt_channel_get_status(GtChannel* self)
     return priv->data->status;
 }
 
+const GtChannelData*
+gt_channel_get_data(GtChannel* self)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(self), NULL);
+
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    return priv->data;
+}
+
 gboolean
 gt_channel_is_online(GtChannel* self)
 {
@@ -960,6 +1297,8 @@ gt_channel_update(GtChannel* self)
 
     utils_refresh_cancellable(&priv->cancel);
 
+    gt_hydration_queue_remove(main_app->hydration_queue, G_OBJECT(self));
+
     DEBUG("Initiating update for channel with id '%s' and name '%s'",
         priv->data->id, priv->data->name);
 
@@ -981,6 +1320,42 @@ gt_channel_update(GtChannel* self)
     return TRUE;
 }
 
+/* NOTE: For callers that fetched the data themselves, e.g. in bulk.
+ * Takes ownership of the data and returns FALSE without touching the
+ * channel if nothing changed */
+gboolean
+gt_channel_update_from_data(GtChannel* self, GtChannelData* data)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(self), FALSE);
+    RETURN_VAL_IF_FAIL(data != NULL, FALSE);
+
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    if (gt_channel_data_equal(priv->data, data))
+    {
+        gt_channel_data_free(data);
+
+        return FALSE;
+    }
+
+    utils_refresh_cancellable(&priv->cancel);
+
+    gt_hydration_queue_remove(main_app->hydration_queue, G_OBJECT(self));
+
+    g_clear_pointer(&priv->error_message, g_free);
+    g_clear_pointer(&priv->error_details, g_free);
+
+    if (priv->error)
+    {
+        priv->error = FALSE;
+        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_ERROR]);
+    }
+
+    update_from_data(self, data);
+
+    return TRUE;
+}
+
 const gchar*
 gt_channel_get_error_message(GtChannel* self)
 {
@@ -1030,6 +1405,32 @@ gt_channel_data_list_free(GtChannelDataList* list)
     g_list_free_full(list, (GDestroyNotify) gt_channel_data_free);
 }
 
+gboolean
+gt_channel_data_equal(GtChannelData* a, GtChannelData* b)
+{
+    if (!a || !b)
+        return a == b;
+
+    if (!STRING_EQUALS(a->id, b->id) || !STRING_EQUALS(a->name, b->name))
+        return FALSE;
+    if (!STRING_EQUALS(a->game, b->game) || !STRING_EQUALS(a->status, b->status))
+        return FALSE;
+    if (!STRING_EQUALS(a->display_name, b->display_name))
+        return FALSE;
+    if (!STRING_EQUALS(a->preview_url, b->preview_url) || !STRING_EQUALS(a->video_banner_url, b->video_banner_url))
+        return FALSE;
+    if (!STRING_EQUALS(a->logo_url, b->logo_url) || !STRING_EQUALS(a->profile_url, b->profile_url))
+        return FALSE;
+    if (a->online != b->online || a->viewers != b->viewers)
+        return FALSE;
+    if (!a->stream_started_time != !b->stream_started_time)
+        return FALSE;
+    if (a->stream_started_time && g_date_time_compare(a->stream_started_time, b->stream_started_time) != 0)
+        return FALSE;
+
+    return TRUE;
+}
+
 gint
 gt_channel_data_compare(GtChannelData* a, GtChannelData* b)
 {
@@ -53,6 +53,7 @@ typedef GList GtChannelList;
 
 GtChannel*     gt_channel_new(GtChannelData* data);
 GtChannel*     gt_channel_new_from_id_and_name(const gchar* id, const gchar* name);
+GtChannel*     gt_channel_lookup(const gchar* id);
 void           gt_channel_toggle_followed(GtChannel* self);
 void           gt_channel_list_free(GList* list);
 gboolean       gt_channel_compare(GtChannel* self, gpointer other);
@@ -61,6 +62,7 @@ const gchar*   gt_channel_get_display_name(GtChannel* self);
 const gchar*   gt_channel_get_id(GtChannel* self);
 const gchar*   gt_channel_get_game_name(GtChannel* self);
 const gchar*   gt_channel_get_status(GtChannel* self);
+const GtChannelData* gt_channel_get_data(GtChannel* self);
 gboolean       gt_channel_is_online(GtChannel* self);
 gboolean       gt_channel_is_error(GtChannel* self);
 gboolean       gt_channel_is_updating(GtChannel* self);
@@ -68,10 +70,12 @@ gboolean       gt_channel_is_followed(GtChannel* self);
 const gchar*   gt_channel_get_error_message(GtChannel* self);
 const gchar*   gt_channel_get_error_details(GtChannel* self);
 gboolean       gt_channel_update(GtChannel* self);
+gboolean       gt_channel_update_from_data(GtChannel* self, GtChannelData* data);
 GtChannelData* gt_channel_data_new();
 void           gt_channel_data_free(GtChannelData* data);
 void           gt_channel_data_list_free(GList* list);
 gint           gt_channel_data_compare(GtChannelData* a, GtChannelData* b);
+gboolean       gt_channel_data_equal(GtChannelData* a, GtChannelData* b);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtChannelList, gt_channel_list_free);
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtChannelData, gt_channel_data_free);
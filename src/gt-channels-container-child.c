@@ -43,6 +43,8 @@ typedef struct
     GtkWidget* error_reload_button;
     GtkWidget* error_link_button;
     GtkWidget* updating_spinner;
+
+    GPtrArray* bindings; /* NOTE: Dropped when rebound to another channel */
 } GtChannelsContainerChildPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GtChannelsContainerChild, gt_channels_container_child, GTK_TYPE_FLOW_BOX_CHILD)
@@ -73,6 +75,14 @@ motion_enter_cb(GtkWidget* widget,
     GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
 
     gtk_revealer_set_reveal_child(GTK_REVEALER(priv->preview_overlay_revealer), TRUE);
+
+    /* NOTE: Hovering is a good hint the channel is about to be opened,
+     * which needs an access token and then the playlist from usher */
+    if (gt_channel_is_online(self->channel))
+    {
+        gt_http_prewarm(main_app->http, "https://api.twitch.tv");
+        gt_http_prewarm(main_app->http, "http://usher.twitch.tv");
+    }
 }
 
 static void
@@ -212,16 +222,91 @@ state_changed_cb(GtChannelsContainerChild* self)
         gtk_stack_set_visible_child(GTK_STACK(priv->preview_stack), priv->preview_box);
 }
 
+static void
+error_reload_cb(GtChannelsContainerChild* self)
+{
+    g_assert(GT_IS_CHANNELS_CONTAINER_CHILD(self));
+
+    gt_channel_update(self->channel);
+}
+
+/* NOTE: Children are recycled by the item containers as they're
+ * scrolled, so the channel can change at any time */
+static void
+set_channel(GtChannelsContainerChild* self, GtChannel* chan)
+{
+    GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
+
+    if (self->channel)
+    {
+        g_ptr_array_set_size(priv->bindings, 0);
+        g_signal_handlers_disconnect_by_data(self->channel, self);
+        g_clear_object(&self->channel);
+    }
+
+    /* NOTE: Also called from dispose, which can run more than once and
+     * after the template children are gone */
+    if (!chan)
+        return;
+
+    gtk_revealer_set_reveal_child(GTK_REVEALER(priv->preview_overlay_revealer), FALSE);
+
+    self->channel = chan;
+
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "display-name",
+            priv->name_label, "label", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "game",
+            priv->game_label, "label", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "followed",
+            priv->follow_button, "active", G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "preview",
+            priv->preview_image, "pixbuf", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property_full(self->channel, "viewers",
+            priv->viewers_label, "label", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE,
+            (GBindingTransformFunc) viewers_converter, NULL, NULL, NULL));
+    g_ptr_array_add(priv->bindings, g_object_bind_property_full(self->channel, "stream-started-time",
+            priv->time_label, "label", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE,
+            (GBindingTransformFunc) time_converter, NULL, NULL, NULL));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->viewers_label, "visible", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->viewers_image, "visible", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->time_label, "visible", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->time_image, "visible", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->play_image, "visible", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+
+    g_signal_connect_object(self->channel, "notify::online", G_CALLBACK(online_cb), self, G_CONNECT_SWAPPED);
+    g_signal_connect_object(self->channel, "notify::error", G_CALLBACK(state_changed_cb), self, G_CONNECT_SWAPPED);
+    g_signal_connect_object(self->channel, "notify::updating", G_CALLBACK(state_changed_cb), self, G_CONNECT_SWAPPED);
+
+    state_changed_cb(self);
+    online_cb(self);
+}
+
 static void
 dispose(GObject* object)
 {
     GtChannelsContainerChild* self = GT_CHANNELS_CONTAINER_CHILD(object);
 
-    g_clear_object(&self->channel);
+    set_channel(self, NULL);
 
     G_OBJECT_CLASS(gt_channels_container_child_parent_class)->dispose(object);
 }
 
+static void
+finalize(GObject* object)
+{
+    GtChannelsContainerChild* self = GT_CHANNELS_CONTAINER_CHILD(object);
+    GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
+
+    g_ptr_array_unref(priv->bindings);
+
+    G_OBJECT_CLASS(gt_channels_container_child_parent_class)->finalize(object);
+}
+
 static void
 get_property (GObject*    obj,
               guint       prop,
@@ -253,84 +338,28 @@ set_property(GObject*      obj,
     switch (prop)
     {
         case PROP_CHANNEL:
-            g_clear_object(&self->channel);
-            self->channel = utils_value_ref_sink_object(val);
+            set_channel(self, utils_value_ref_sink_object(val));
             break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
     }
 }
 
-static void
-constructed(GObject* obj)
-{
-    GtChannelsContainerChild* self = GT_CHANNELS_CONTAINER_CHILD(obj);
-    GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
-
-    g_object_bind_property(self->channel, "display-name",
-                           priv->name_label, "label",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "game",
-                           priv->game_label, "label",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "followed",
-                           priv->follow_button, "active",
-                           G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "preview",
-                           priv->preview_image, "pixbuf",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property_full(self->channel, "viewers",
-                                priv->viewers_label, "label",
-                                G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE,
-                                (GBindingTransformFunc) viewers_converter,
-                                NULL, NULL, NULL);
-    g_object_bind_property_full(self->channel, "stream-started-time",
-                                priv->time_label, "label",
-                                G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE,
-                                (GBindingTransformFunc) time_converter,
-                                NULL, NULL, NULL);
-    g_object_bind_property(self->channel, "online",
-                           priv->viewers_label, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "online",
-                           priv->viewers_image, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "online",
-                           priv->time_label, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "online",
-                           priv->time_image, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "online",
-                           priv->play_image, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-
-    g_signal_connect_object(self->channel, "notify::online", G_CALLBACK(online_cb), self, G_CONNECT_SWAPPED);
-    g_signal_connect_object(self->channel, "notify::error", G_CALLBACK(state_changed_cb), self, G_CONNECT_SWAPPED);
-    g_signal_connect_object(self->channel, "notify::updating", G_CALLBACK(state_changed_cb), self, G_CONNECT_SWAPPED);
-    g_signal_connect_swapped(priv->error_reload_button, "clicked", G_CALLBACK(gt_channel_update), self->channel);
-
-    state_changed_cb(self);
-    online_cb(self);
-
-    G_OBJECT_CLASS(gt_channels_container_child_parent_class)->constructed(obj);
-}
-
 static void
 gt_channels_container_child_class_init(GtChannelsContainerChildClass* klass)
 {
     GObjectClass* object_class = G_OBJECT_CLASS(klass);
 
     object_class->dispose = dispose;
+    object_class->finalize = finalize;
     object_class->get_property = get_property;
     object_class->set_property = set_property;
-    object_class->constructed = constructed;
 
     gtk_widget_class_set_template_from_resource(GTK_WIDGET_CLASS(klass),
         "/com/vinszent/GnomeTwitch/ui/gt-channels-container-child.ui");
 
     props[PROP_CHANNEL] = g_param_spec_object("channel", "Channel", "Associated channel",
-        GT_TYPE_CHANNEL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+        GT_TYPE_CHANNEL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
 
     g_object_class_install_properties(object_class, NUM_PROPS, props);
 
@@ -361,9 +390,12 @@ gt_channels_container_child_init(GtChannelsContainerChild* self)
 {
     GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
 
+    priv->bindings = g_ptr_array_new_with_free_func((GDestroyNotify) g_binding_unbind);
+
     gtk_widget_init_template(GTK_WIDGET(self));
 
     g_signal_connect(priv->error_link_button, "clicked", G_CALLBACK(error_link_clicked_cb), self);
+    g_signal_connect_swapped(priv->error_reload_button, "clicked", G_CALLBACK(error_reload_cb), self);
 }
 
 void
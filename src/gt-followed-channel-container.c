@@ -34,7 +34,6 @@
 typedef struct
 {
     gchar* query;
-    GtkWidget* item_flow;
 } GtFollowedChannelContainerPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GtFollowedChannelContainer, gt_followed_channel_container, GT_TYPE_ITEM_CONTAINER);
@@ -72,10 +71,18 @@ channel_updating_cb(GObject* source,
     RETURN_IF_FAIL(GT_IS_CHANNEL(source));
 
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
-    GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
 
     if (!gt_channel_is_updating(GT_CHANNEL(source)))
-        gtk_flow_box_invalidate_sort(GTK_FLOW_BOX(priv->item_flow));
+        gt_item_container_invalidate_sort(GT_ITEM_CONTAINER(self));
+}
+
+/* NOTE: Channels are shared, so make sure it's only watched once */
+static void
+watch_channel(GtFollowedChannelContainer* self, GtChannel* chan)
+{
+    g_signal_handlers_disconnect_by_func(chan, channel_updating_cb, self);
+    g_signal_connect_object(chan, "notify::updating",
+        G_CALLBACK(channel_updating_cb), self, 0);
 }
 
 static GtkWidget*
@@ -84,12 +91,18 @@ create_child(GtItemContainer* item_container, gpointer data)
     RETURN_VAL_IF_FAIL(GT_IS_FOLLOWED_CHANNEL_CONTAINER(item_container), NULL);
     RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(data), NULL);
 
-    GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(item_container);
+    return GTK_WIDGET(gt_channels_container_child_new(GT_CHANNEL(data)));
+}
 
-    g_signal_connect_object(data, "notify::updating",
-        G_CALLBACK(channel_updating_cb), self, 0);
+static void
+bind_child(GtItemContainer* item_container,
+    GtkWidget* child, gpointer data)
+{
+    RETURN_IF_FAIL(GT_IS_FOLLOWED_CHANNEL_CONTAINER(item_container));
+    RETURN_IF_FAIL(GT_IS_CHANNELS_CONTAINER_CHILD(child));
+    RETURN_IF_FAIL(GT_IS_CHANNEL(data));
 
-    return GTK_WIDGET(gt_channels_container_child_new(GT_CHANNEL(data)));
+    g_object_set(child, "channel", data, NULL);
 }
 
 static void
@@ -115,7 +128,13 @@ channel_followed_cb(GtFollowsManager* mgr,
 
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
 
+    watch_channel(self, chan);
+
     gt_item_container_append_item(GT_ITEM_CONTAINER(self), chan);
+
+    /* NOTE: Show follows as they come in instead of waiting for all of them */
+    if (gt_follows_manager_is_loading_follows(mgr))
+        gt_item_container_set_fetching_items(GT_ITEM_CONTAINER(self), FALSE);
 }
 
 static void
@@ -128,6 +147,8 @@ channel_unfollowed_cb(GtFollowsManager* mgr,
 
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
 
+    g_signal_handlers_disconnect_by_func(chan, channel_updating_cb, self);
+
     gt_item_container_remove_item(GT_ITEM_CONTAINER(self), chan);
 }
 
@@ -141,31 +162,24 @@ loading_follows_cb(GObject* source,
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
     GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
 
+    /* NOTE: The follows are added through channel-followed while they
+     * load so there is nothing to set once they're done */
     if (gt_follows_manager_is_loading_follows(main_app->fav_mgr))
     {
-        g_signal_handlers_block_by_func(main_app->fav_mgr, channel_followed_cb, self);
-        g_signal_handlers_block_by_func(main_app->fav_mgr, channel_unfollowed_cb, self);
-
         gt_item_container_set_items(GT_ITEM_CONTAINER(self), NULL);
         gt_item_container_set_fetching_items(GT_ITEM_CONTAINER(self), TRUE);
     }
     else
-    {
-        g_signal_handlers_unblock_by_func(main_app->fav_mgr, channel_followed_cb, self);
-        g_signal_handlers_unblock_by_func(main_app->fav_mgr, channel_unfollowed_cb, self);
-
-        gt_item_container_set_items(GT_ITEM_CONTAINER(self), main_app->fav_mgr->follow_channels);
         gt_item_container_set_fetching_items(GT_ITEM_CONTAINER(self), FALSE);
-    }
 }
 static gboolean
-filter_by_name(GtkFlowBoxChild* _child,
+filter_by_name(gpointer item,
     gpointer udata)
 {
-    RETURN_VAL_IF_FAIL(GT_IS_CHANNELS_CONTAINER_CHILD(_child), FALSE);
+    RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(item), FALSE);
     RETURN_VAL_IF_FAIL(GT_IS_FOLLOWED_CHANNEL_CONTAINER(udata), FALSE);
 
-    GtChannelsContainerChild* child = GT_CHANNELS_CONTAINER_CHILD(_child);
+    GtChannel* chan = GT_CHANNEL(item);
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
     GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
     gboolean ret = FALSE;
@@ -174,7 +188,7 @@ filter_by_name(GtkFlowBoxChild* _child,
         ret = TRUE;
     else
     {
-        gchar* name = g_utf8_casefold(gt_channel_get_name(child->channel), -1);
+        gchar* name = g_utf8_casefold(gt_channel_get_name(chan), -1);
         gchar* query = g_utf8_casefold(priv->query, -1);
 
         ret = g_strrstr(name, query) != NULL;
@@ -187,28 +201,26 @@ filter_by_name(GtkFlowBoxChild* _child,
 }
 
 static gint
-sort_by_name_and_online(GtkFlowBoxChild* _child1,
-    GtkFlowBoxChild* _child2, gpointer udata)
+sort_by_name_and_online(gconstpointer item1,
+    gconstpointer item2, gpointer udata)
 {
     RETURN_VAL_IF_FAIL(GT_IS_FOLLOWED_CHANNEL_CONTAINER(udata), -1);
-    RETURN_VAL_IF_FAIL(GT_IS_CHANNELS_CONTAINER_CHILD(_child1), -1);
+    RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(item1), -1);
 
-    RETURN_VAL_IF_FAIL(GT_IS_CHANNELS_CONTAINER_CHILD(_child2), -1);
+    RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(item2), -1);
 
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
-    GtChannelsContainerChild* child1 = GT_CHANNELS_CONTAINER_CHILD(_child1);
-    GtChannelsContainerChild* child2 = GT_CHANNELS_CONTAINER_CHILD(_child2);
     gboolean online1;
     gboolean online2;
     g_autofree gchar* name1;
     g_autofree gchar* name2;
     gint ret = 0;
 
-    g_object_get(child1->channel,
+    g_object_get((gpointer) item1,
                  "online", &online1,
                  "name", &name1,
                  NULL);
-    g_object_get(child2->channel,
+    g_object_get((gpointer) item2,
                  "online", &online2,
                  "name", &name2,
                  NULL);
@@ -257,7 +269,7 @@ set_property(GObject* obj,
             g_clear_pointer(&priv->query, g_free);
             priv->query = g_value_dup_string(val);
 
-            gtk_flow_box_invalidate_filter(GTK_FLOW_BOX(priv->item_flow));
+            gt_item_container_invalidate_filter(GT_ITEM_CONTAINER(self));
             break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
@@ -270,19 +282,24 @@ constructed(GObject* obj)
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(obj);
     GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
 
-    gtk_flow_box_set_filter_func(GTK_FLOW_BOX(priv->item_flow),
-        (GtkFlowBoxFilterFunc) filter_by_name,
-        self, NULL);
-
-    gtk_flow_box_set_sort_func(GTK_FLOW_BOX(priv->item_flow),
-        (GtkFlowBoxSortFunc) sort_by_name_and_online, self, NULL);
+    gt_item_container_set_filter_func(GT_ITEM_CONTAINER(self), filter_by_name, self);
+    gt_item_container_set_sort_func(GT_ITEM_CONTAINER(self), sort_by_name_and_online, self);
 
     g_signal_connect(main_app->fav_mgr, "notify::loading-follows", G_CALLBACK(loading_follows_cb), self);
     g_signal_connect(main_app->fav_mgr, "channel-followed", G_CALLBACK(channel_followed_cb), self);
     g_signal_connect(main_app->fav_mgr, "channel-unfollowed", G_CALLBACK(channel_unfollowed_cb), self);
 
-    if (!gt_follows_manager_is_loading_follows(main_app->fav_mgr))
-        gt_item_container_set_items(GT_ITEM_CONTAINER(self), g_list_copy(main_app->fav_mgr->follow_channels));
+    {
+        g_autoptr(GList) channels = gt_follows_manager_get_followed_channels(main_app->fav_mgr);
+
+        for (GList* l = channels; l != NULL; l = l->next)
+            watch_channel(self, l->data);
+
+        gt_item_container_set_items(GT_ITEM_CONTAINER(self), channels);
+
+        if (channels && gt_follows_manager_is_loading_follows(main_app->fav_mgr))
+            gt_item_container_set_fetching_items(GT_ITEM_CONTAINER(self), FALSE);
+    }
 
     G_OBJECT_CLASS(gt_followed_channel_container_parent_class)->constructed(obj);
 }
@@ -295,6 +312,7 @@ gt_followed_channel_container_class_init(GtFollowedChannelContainerClass* klass)
     G_OBJECT_CLASS(klass)->set_property = set_property;
 
     GT_ITEM_CONTAINER_CLASS(klass)->create_child = create_child;
+    GT_ITEM_CONTAINER_CLASS(klass)->bind_child = bind_child;
     GT_ITEM_CONTAINER_CLASS(klass)->get_properties = get_properties;
     GT_ITEM_CONTAINER_CLASS(klass)->activate_child = activate_child;
 
@@ -308,7 +326,7 @@ gt_followed_channel_container_init(GtFollowedChannelContainer* self)
 {
     GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
 
-    priv->item_flow = gt_item_container_get_flow_box(GT_ITEM_CONTAINER(self));
+    priv->query = NULL;
 }
 
 GtFollowedChannelContainer*
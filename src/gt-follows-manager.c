@@ -32,17 +32,72 @@
 #define OLD_FAV_CHANNELS_FILE g_build_filename(g_get_user_data_dir(), "gnome-twitch", "favourite-channels.json", NULL);
 #define FAV_CHANNELS_FILE g_build_filename(g_get_user_data_dir(), "gnome-twitch", "followed-channels.json", NULL);
 
+#define FOLLOWS_SNAPSHOT_FILE g_build_filename(g_get_user_cache_dir(), "gnome-twitch", "follows-snapshot.json", NULL);
+
 #define FOLLOWED_CHANNELS_FILE_VERSION 1
+#define FOLLOWS_SNAPSHOT_VERSION 1
+
+#define STATUS_REFRESH_INTERVAL 120 /* NOTE: Seconds */
+#define STATUS_REFRESH_BATCH_SIZE 100 /* NOTE: Most channel ids the API takes at once */
+#define FOLLOWS_PAGE_SIZE 100
+#define FOLLOWED_STREAMS_URI "https://api.twitch.tv/kraken/streams/followed?oauth_token=%s&limit=%d&offset=%d&stream_type=live"
+#define FOLLOWED_CHANNELS_URI "https://api.twitch.tv/kraken/users/%s/follows/channels?limit=%d&offset=%d"
+#define STATUS_REFRESH_URI "https://api.twitch.tv/kraken/streams?channel=%s&limit=%d&stream_type=live"
+
+/* NOTE: Channels are kept in an array to preserve their order and
+ * indexed by id so that membership checks don't have to walk it */
+typedef struct
+{
+    GPtrArray* channels;
+    GHashTable* index;
+} ChannelSet;
 
 struct _GtFollowsManagerPrivate
 {
     gboolean loading_follows;
     GCancellable* cancel;
-    JsonParser* json_parser;
-    gint current_offset;
-    GtChannelList* loading_list;
+    gint64 load_start_time;
+
+    ChannelSet follows;
+    ChannelSet loading;
+
+    /* NOTE: Channels of each page by page number, NULL until the page
+     * has been loaded */
+    GPtrArray* stream_pages;
+    GPtrArray* channel_pages;
+    guint pages_pending;
+    guint pages_failed;
+
+    /* NOTE: Set while follows shown from the snapshot are brought up
+     * to date, only the differences are applied to them */
+    gboolean syncing;
+
+    GCancellable* refresh_cancel;
+    guint refresh_id;
 };
 
+typedef struct
+{
+    GWeakRef* self;
+    GPtrArray* channels;
+    JsonParser* json_parser;
+} StatusRefreshData;
+
+typedef enum
+{
+    FOLLOWS_PAGE_STREAMS,
+    FOLLOWS_PAGE_CHANNELS,
+} FollowsPageKind;
+
+typedef struct
+{
+    GWeakRef* self;
+    GCancellable* cancel;
+    FollowsPageKind kind;
+    guint index;
+    JsonParser* json_parser;
+} FollowsPageData;
+
 G_DEFINE_TYPE_WITH_PRIVATE(GtFollowsManager, gt_follows_manager, G_TYPE_OBJECT)
 
 enum
@@ -70,6 +125,121 @@ gt_follows_manager_new(void)
                         NULL);
 }
 
+static StatusRefreshData*
+status_refresh_data_new(GtFollowsManager* self)
+{
+    StatusRefreshData* data = g_slice_new0(StatusRefreshData);
+
+    data->self = utils_weak_ref_new(self);
+    data->channels = g_ptr_array_new_with_free_func(g_object_unref);
+    data->json_parser = json_parser_new();
+
+    return data;
+}
+
+static void
+status_refresh_data_free(StatusRefreshData* data)
+{
+    if (!data) return;
+
+    utils_weak_ref_free(data->self);
+    g_ptr_array_unref(data->channels);
+    g_object_unref(data->json_parser);
+
+    g_slice_free(StatusRefreshData, data);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(StatusRefreshData, status_refresh_data_free);
+
+static FollowsPageData*
+follows_page_data_new(GtFollowsManager* self, GCancellable* cancel,
+    FollowsPageKind kind, guint index)
+{
+    FollowsPageData* data = g_slice_new0(FollowsPageData);
+
+    data->self = utils_weak_ref_new(self);
+    data->cancel = g_object_ref(cancel);
+    data->kind = kind;
+    data->index = index;
+    data->json_parser = json_parser_new();
+
+    return data;
+}
+
+static void
+follows_page_data_free(FollowsPageData* data)
+{
+    if (!data) return;
+
+    utils_weak_ref_free(data->self);
+    g_object_unref(data->cancel);
+    g_object_unref(data->json_parser);
+
+    g_slice_free(FollowsPageData, data);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FollowsPageData, follows_page_data_free);
+
+static void
+channel_set_init(ChannelSet* set)
+{
+    set->channels = g_ptr_array_new_with_free_func(g_object_unref);
+    set->index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+}
+
+static void
+channel_set_clear(ChannelSet* set)
+{
+    g_clear_pointer(&set->index, g_hash_table_unref);
+    g_clear_pointer(&set->channels, g_ptr_array_unref);
+}
+
+static void
+channel_set_remove_all(ChannelSet* set)
+{
+    g_hash_table_remove_all(set->index);
+    g_ptr_array_set_size(set->channels, 0);
+}
+
+static gboolean
+channel_set_contains(ChannelSet* set, const gchar* id)
+{
+    return g_hash_table_contains(set->index, id);
+}
+
+/* NOTE: Takes a ref of its own */
+static gboolean
+channel_set_add(ChannelSet* set, GtChannel* chan)
+{
+    const gchar* id = gt_channel_get_id(chan);
+
+    if (channel_set_contains(set, id))
+        return FALSE;
+
+    g_hash_table_insert(set->index, g_strdup(id), chan);
+    g_ptr_array_add(set->channels, g_object_ref(chan));
+
+    return TRUE;
+}
+
+/* NOTE: Returns a new ref to the removed channel or NULL if it wasn't
+ * in the set */
+static GtChannel*
+channel_set_remove(ChannelSet* set, const gchar* id)
+{
+    GtChannel* chan = g_hash_table_lookup(set->index, id);
+
+    if (!chan)
+        return NULL;
+
+    g_object_ref(chan);
+
+    g_hash_table_remove(set->index, id);
+    g_ptr_array_remove(set->channels, chan);
+
+    return chan;
+}
+
 static void
 channel_online_cb(GObject* source,
     GParamSpec* pspec, gpointer udata)
@@ -105,6 +275,23 @@ static void
 channel_followed_cb(GObject* source,
                       GParamSpec* pspec,
                       gpointer udata);
+
+/* NOTE: Channels are shared by id so the registered channel is almost
+ * always the one that changed, this only catches the odd straggler
+ * without every channel having to listen for follows */
+static void
+sync_registered_channel(GtFollowsManager* self, GtChannel* chan)
+{
+    g_autoptr(GtChannel) shared = gt_channel_lookup(gt_channel_get_id(chan));
+
+    if (!shared || shared == chan || gt_channel_is_followed(shared) == gt_channel_is_followed(chan))
+        return;
+
+    g_signal_handlers_block_by_func(shared, channel_followed_cb, self);
+    g_object_set(shared, "followed", gt_channel_is_followed(chan), NULL);
+    g_signal_handlers_unblock_by_func(shared, channel_followed_cb, self);
+}
+
 static gboolean
 toggle_followed_cb(gpointer udata)
 {
@@ -128,7 +315,9 @@ channel_followed_cb(GObject* source,
     RETURN_IF_FAIL(GT_IS_CHANNEL(source));
 
     GtFollowsManager* self = GT_FOLLOWS_MANAGER(udata);
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
     GtChannel* chan = GT_CHANNEL(source);
+    g_autoptr(GtChannel) found = NULL;
     g_autoptr(GError) err = NULL;
     const gchar* name = gt_channel_get_name(chan);
 
@@ -160,20 +349,20 @@ channel_followed_cb(GObject* source,
             }
         }
 
-        self->follow_channels = g_list_append(self->follow_channels, chan);
+        channel_set_add(&priv->follows, chan);
+        g_signal_handlers_disconnect_by_func(chan, channel_online_cb, self);
         g_signal_connect(chan, "notify::online", G_CALLBACK(channel_online_cb), self);
-        g_object_ref(chan);
 
         MESSAGEF("Followed channel '%s'", name);
 
+        sync_registered_channel(self, chan);
+
         g_signal_emit(self, sigs[SIG_CHANNEL_FOLLOWED], 0, chan);
     }
     else
     {
-        GList* found = g_list_find_custom(self->follow_channels, chan, (GCompareFunc) gt_channel_compare);
-
-        /* NOTE: This should never be NULL */
-        RETURN_IF_FAIL(found != NULL);
+        /* NOTE: This should never be FALSE */
+        RETURN_IF_FAIL(channel_set_contains(&priv->follows, gt_channel_get_id(chan)));
 
         if (gt_app_is_logged_in(main_app))
         {
@@ -201,18 +390,16 @@ channel_followed_cb(GObject* source,
             }
         }
 
-        g_signal_handlers_disconnect_by_func(found->data, channel_online_cb, self);
+        // Remove the channel before the signal is emitted, we keep a ref while it is
+        found = channel_set_remove(&priv->follows, gt_channel_get_id(chan));
 
-        // Remove the link before the signal is emitted
-        self->follow_channels = g_list_remove_link(self->follow_channels, found);
+        g_signal_handlers_disconnect_by_func(found, channel_online_cb, self);
 
         MESSAGEF("Unfollowed channel '%s'", gt_channel_get_name(chan));
 
-        g_signal_emit(self, sigs[SIG_CHANNEL_UNFOLLOWED], 0, found->data);
+        sync_registered_channel(self, chan);
 
-        // Unref here so that the GtChannel has a ref while the signal is being emitted
-        g_clear_object(&found->data);
-        g_list_free(found);
+        g_signal_emit(self, sigs[SIG_CHANNEL_UNFOLLOWED], 0, found);
     }
 }
 
@@ -228,6 +415,7 @@ channel_updating_oneshot_cb(GObject* source,
 
     if (!gt_channel_is_updating(chan))
     {
+        g_signal_handlers_disconnect_by_func(chan, channel_online_cb, self);
         g_signal_connect(chan, "notify::online",
             G_CALLBACK(channel_online_cb), self);
 
@@ -245,13 +433,12 @@ shutdown_cb(GApplication* app,
 //    gt_follows_manager_save(self);
 }
 
-static GList*
-load_from_file(const char* filepath, GError** error)
+static void
+load_from_file(const char* filepath, ChannelSet* set, GError** error)
 {
     g_autoptr(JsonParser) parser = json_parser_new();
     g_autoptr(JsonReader) reader = NULL;
     g_autoptr(GError) err = NULL;
-    GList* ret = NULL;
 
     if (!g_file_test(filepath, G_FILE_TEST_EXISTS))
     {
@@ -260,7 +447,7 @@ load_from_file(const char* filepath, GError** error)
         g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
             "File '%s' does not exist", filepath);
 
-        return NULL;
+        return;
     }
 
     json_parser_load_from_file(parser, filepath, error);
@@ -315,17 +502,16 @@ load_from_file(const char* filepath, GError** error)
 
         chan = gt_channel_new_from_id_and_name(id, name);
 
-        g_object_ref_sink(chan);
-
-        ret = g_list_append(ret, chan);
+        /* NOTE: The file may list a channel twice, only the first
+         * one is added */
+        channel_set_add(set, chan);
+        g_object_unref(chan);
     }
 
-    return ret;
+    return;
 
 error:
-    gt_channel_list_free(ret);
-
-    return ret;
+    channel_set_remove_all(set);
 }
 
 static void
@@ -394,8 +580,17 @@ move_local_follows_cb(GtkInfoBar* bar,
         g_autofree gchar* filepath = FAV_CHANNELS_FILE;
         g_autoptr(GError) err = NULL;
         GList* channels = NULL;
+        ChannelSet set;
+
+        channel_set_init(&set);
+
+        load_from_file(filepath, &set, &err);
 
-        channels = load_from_file(filepath, &err);
+        /* NOTE: The list keeps its own refs, it's walked by follow_next_channel_cb */
+        for (guint i = set.channels->len; i > 0; i--)
+            channels = g_list_prepend(channels, g_object_ref(g_ptr_array_index(set.channels, i - 1)));
+
+        channel_set_clear(&set);
 
         if (err)
         {
@@ -403,6 +598,8 @@ move_local_follows_cb(GtkInfoBar* bar,
 
             WARNING("Unable to move local follows to Twitch because: %s", err->message);
 
+            g_list_free_full(channels, g_object_unref);
+
             win = GT_WIN_ACTIVE;
 
             RETURN_IF_FAIL(GT_IS_WIN(win));
@@ -413,6 +610,18 @@ move_local_follows_cb(GtkInfoBar* bar,
             return;
         }
 
+        /* NOTE: Nothing to move */
+        if (!channels)
+        {
+            g_autofree gchar* new_fp = g_strconcat(filepath, ".bak", NULL);
+
+            g_rename(filepath, new_fp);
+
+            gt_follows_manager_load_from_twitch(self);
+
+            return;
+        }
+
         channels = g_list_append(channels, self);
 
         gt_twitch_follow_channel_async(main_app->twitch,
@@ -455,262 +664,773 @@ logged_in_cb(GObject* source,
 }
 
 static void
-handle_channels_response_cb(GtHTTP* http,
-    gpointer res, GError* error, gpointer udata);
+page_results_free(gpointer page)
+{
+    if (page)
+        g_ptr_array_unref(page);
+}
 
 static void
-process_channels_json_cb(GObject* source,
-    GAsyncResult* res, gpointer udata)
+follow_loaded_channel(GtFollowsManager* self, GtChannel* chan)
 {
-    RETURN_IF_FAIL(JSON_IS_PARSER(source));
-    RETURN_IF_FAIL(G_IS_ASYNC_RESULT(res));
-    RETURN_IF_FAIL(udata != NULL);
+    g_signal_handlers_disconnect_by_func(chan, channel_online_cb, self);
+    g_signal_handlers_disconnect_by_func(chan, channel_updating_oneshot_cb, self);
 
-    g_autoptr(GWeakRef) ref = udata;
-    g_autoptr(GtFollowsManager) self = g_weak_ref_get(ref);
+    if (gt_channel_is_updating(chan))
+    {
+        g_signal_connect(chan, "notify::updating",
+            G_CALLBACK(channel_updating_oneshot_cb), self);
+    }
+    else
+        g_signal_connect(chan, "notify::online", G_CALLBACK(channel_online_cb), self);
 
-    if (!self)
+    g_signal_handlers_block_by_func(chan, channel_followed_cb, self);
+
+    g_object_set(chan, "followed", TRUE, NULL);
+    g_signal_emit(self, sigs[SIG_CHANNEL_FOLLOWED], 0, chan);
+
+    g_signal_handlers_unblock_by_func(chan, channel_followed_cb, self);
+}
+
+static void
+add_string_member(JsonBuilder* builder, const gchar* member, const gchar* value)
+{
+    json_builder_set_member_name(builder, member);
+
+    if (value)
+        json_builder_add_string_value(builder, value);
+    else
+        json_builder_add_null_value(builder);
+}
+
+static gchar*
+read_string_member(JsonReader* reader, const gchar* member)
+{
+    gchar* ret = NULL;
+
+    if (json_reader_read_member(reader, member) && !json_reader_get_null_value(reader))
+        ret = g_strdup(json_reader_get_string_value(reader));
+    json_reader_end_member(reader);
+
+    return ret;
+}
+
+/* NOTE: Keeps everything needed to show the follows straight away on
+ * the next start. The preview urls are also what the image cache is
+ * keyed on, so the previews come from the cache as well. */
+static void
+snapshot_save(GtFollowsManager* self)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    const GtOAuthInfo* info = gt_app_get_oauth_info(main_app);
+    g_autofree gchar* fp = FOLLOWS_SNAPSHOT_FILE;
+    g_autofree gchar* dir = g_path_get_dirname(fp);
+    g_autoptr(JsonBuilder) builder = json_builder_new();
+    g_autoptr(JsonGenerator) gen = json_generator_new();
+    g_autoptr(JsonNode) root = NULL;
+    g_autoptr(GError) err = NULL;
+
+    json_builder_begin_object(builder);
+
+    json_builder_set_member_name(builder, "version");
+    json_builder_add_int_value(builder, FOLLOWS_SNAPSHOT_VERSION);
+
+    add_string_member(builder, "user-id", info->user_id);
+
+    json_builder_set_member_name(builder, "follows");
+    json_builder_begin_array(builder);
+
+    for (guint i = 0; i < priv->follows.channels->len; i++)
     {
-        TRACE("Not processing followed streams json because we were unreffed while waiting");
-        return;
+        const GtChannelData* data = gt_channel_get_data(g_ptr_array_index(priv->follows.channels, i));
+
+        json_builder_begin_object(builder);
+
+        add_string_member(builder, "id", data->id);
+        add_string_member(builder, "name", data->name);
+        add_string_member(builder, "display-name", data->display_name);
+        add_string_member(builder, "game", data->game);
+        add_string_member(builder, "status", data->status);
+        add_string_member(builder, "preview-url", data->preview_url);
+        add_string_member(builder, "video-banner-url", data->video_banner_url);
+        add_string_member(builder, "logo-url", data->logo_url);
+        add_string_member(builder, "profile-url", data->profile_url);
+
+        json_builder_set_member_name(builder, "viewers");
+        json_builder_add_int_value(builder, data->viewers);
+
+        json_builder_set_member_name(builder, "online");
+        json_builder_add_boolean_value(builder, data->online);
+
+        json_builder_set_member_name(builder, "stream-started");
+        json_builder_add_int_value(builder, data->stream_started_time ?
+            g_date_time_to_unix(data->stream_started_time) : 0);
+
+        json_builder_end_object(builder);
     }
 
+    json_builder_end_array(builder);
+    json_builder_end_object(builder);
+
+    root = json_builder_get_root(builder);
+
+    g_mkdir_with_parents(dir, 0700);
+
+    json_generator_set_root(gen, root);
+
+    if (!json_generator_to_file(gen, fp, &err))
+        WARNING("Unable to save follows snapshot because: %s", err->message);
+    else
+        DEBUG("Saved snapshot of '%d' follows", priv->follows.channels->len);
+}
+
+static gboolean
+snapshot_load(GtFollowsManager* self, const gchar* user_id)
+{
     GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    g_autofree gchar* fp = FOLLOWS_SNAPSHOT_FILE;
+    g_autofree gchar* snapshot_user_id = NULL;
+    g_autoptr(JsonParser) parser = json_parser_new();
     g_autoptr(JsonReader) reader = NULL;
     g_autoptr(GError) err = NULL;
+    gint64 version = 0;
     gint num_elements;
-    gint64 total;
 
-    json_parser_load_from_stream_finish(priv->json_parser, res, &err);
+    if (!g_file_test(fp, G_FILE_TEST_EXISTS))
+        return FALSE;
 
-    RETURN_IF_ERROR(err); /* FIXME: Handle error */
+    if (!json_parser_load_from_file(parser, fp, &err))
+    {
+        WARNING("Unable to load follows snapshot because: %s", err->message);
+        return FALSE;
+    }
 
-    reader = json_reader_new(json_parser_get_root(priv->json_parser));
+    reader = json_reader_new(json_parser_get_root(parser));
 
-    if (!json_reader_read_member(reader, "_total")) RETURN_IF_REACHED(); /* FIXME: Handle error */
-    total = json_reader_get_int_value(reader);
+    if (json_reader_read_member(reader, "version"))
+        version = json_reader_get_int_value(reader);
     json_reader_end_member(reader);
 
-    if (!json_reader_read_member(reader, "follows")) RETURN_IF_REACHED(); /* FIXME: Handle error */
+    snapshot_user_id = read_string_member(reader, "user-id");
+
+    /* NOTE: Don't show the follows of whoever was logged in before */
+    if (version != FOLLOWS_SNAPSHOT_VERSION || !STRING_EQUALS(snapshot_user_id, user_id))
+    {
+        DEBUG("Not using follows snapshot because it's from another version or user");
+        return FALSE;
+    }
+
+    if (!json_reader_read_member(reader, "follows"))
+    {
+        json_reader_end_member(reader);
+        return FALSE;
+    }
 
     num_elements = json_reader_count_elements(reader);
 
     for (gint i = 0; i < num_elements; i++)
     {
-        GtChannelData* data = NULL;
-        gboolean found = FALSE;
+        g_autoptr(GtChannelData) data = NULL;
+        GtChannel* chan = NULL;
+        gint64 started = 0;
+
+        if (!json_reader_read_element(reader, i))
+        {
+            json_reader_end_element(reader);
+            continue;
+        }
+
+        data = gt_channel_data_new();
+        data->id = read_string_member(reader, "id");
+        data->name = read_string_member(reader, "name");
+        data->display_name = read_string_member(reader, "display-name");
+        data->game = read_string_member(reader, "game");
+        data->status = read_string_member(reader, "status");
+        data->preview_url = read_string_member(reader, "preview-url");
+        data->video_banner_url = read_string_member(reader, "video-banner-url");
+        data->logo_url = read_string_member(reader, "logo-url");
+        data->profile_url = read_string_member(reader, "profile-url");
+
+        if (json_reader_read_member(reader, "viewers"))
+            data->viewers = json_reader_get_int_value(reader);
+        json_reader_end_member(reader);
 
-        if (!json_reader_read_element(reader, i)) RETURN_IF_REACHED(); /* FIXME: Handle error */
-        if (!json_reader_read_member(reader, "channel")) RETURN_IF_REACHED(); /* FIXME: Handle error */
+        if (json_reader_read_member(reader, "online"))
+            data->online = json_reader_get_boolean_value(reader);
+        json_reader_end_member(reader);
 
-        data = utils_parse_channel_from_json(reader, &err);
+        if (json_reader_read_member(reader, "stream-started"))
+            started = json_reader_get_int_value(reader);
+        json_reader_end_member(reader);
 
-        RETURN_IF_ERROR(err); /* FIXME: Handle error */
+        if (started > 0)
+            data->stream_started_time = g_date_time_new_from_unix_utc(started);
 
-        for (GList* l = priv->loading_list; l != NULL; l = l->next)
-        {
-            GtChannel* chan = GT_CHANNEL(l->data);
+        json_reader_end_element(reader);
 
-            if (STRING_EQUALS(gt_channel_get_id(chan), data->id)
-                && STRING_EQUALS(gt_channel_get_name(chan), data->name))
-            {
-                gt_channel_data_free(data);
-                found = TRUE;
+        if (utils_str_empty(data->id) || utils_str_empty(data->name))
+            continue;
 
-                break;
-            }
-        }
+        chan = gt_channel_new(g_steal_pointer(&data));
 
-        if (!found)
-            priv->loading_list = g_list_append(priv->loading_list, gt_channel_new(data));
+        if (channel_set_add(&priv->follows, chan))
+            follow_loaded_channel(self, chan);
 
-        json_reader_end_member(reader);
-        json_reader_end_element(reader);
+        g_object_unref(chan);
     }
 
     json_reader_end_member(reader);
 
-    priv->current_offset += num_elements;
+    return priv->follows.channels->len > 0;
+}
 
-    const GtOAuthInfo* info = gt_app_get_oauth_info(main_app);
+static void
+unfollow_loaded_channel(GtFollowsManager* self, GtChannel* chan)
+{
+    g_signal_handlers_disconnect_by_func(chan, channel_online_cb, self);
+    g_signal_handlers_disconnect_by_func(chan, channel_updating_oneshot_cb, self);
 
-    if (priv->current_offset < total)
+    g_signal_handlers_block_by_func(chan, channel_followed_cb, self);
+
+    g_object_set(chan, "followed", FALSE, NULL);
+    g_signal_emit(self, sigs[SIG_CHANNEL_UNFOLLOWED], 0, chan);
+
+    g_signal_handlers_unblock_by_func(chan, channel_followed_cb, self);
+}
+
+/* NOTE: Pages arrive in any order, the follows are put back in the
+ * order Twitch gave them once all of them are in */
+static void
+finish_loading_follows(GtFollowsManager* self)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    GPtrArray* all_pages[] = {priv->stream_pages, priv->channel_pages};
+    g_autoptr(GHashTable) live = g_hash_table_new(g_direct_hash, g_direct_equal);
+    gboolean complete = priv->pages_failed == 0;
+    guint removed = 0;
+    ChannelSet tmp;
+
+    channel_set_remove_all(&priv->loading);
+
+    for (guint i = 0; i < G_N_ELEMENTS(all_pages); i++)
     {
-        g_autofree gchar* uri = NULL;
+        for (guint j = 0; j < all_pages[i]->len; j++)
+        {
+            GPtrArray* page = g_ptr_array_index(all_pages[i], j);
+
+            if (!page)
+                continue;
 
-        uri = g_strdup_printf("https://api.twitch.tv/kraken/users/%s/follows/channels?limit=%d&offset=%d",
-            info->user_id, 100, priv->current_offset);
+            for (guint k = 0; k < page->len; k++)
+            {
+                GtChannel* chan = g_ptr_array_index(page, k);
+
+                channel_set_add(&priv->loading, chan);
 
-        gt_http_get_with_category(main_app->http, uri, "gt-follows-manager", DEFAULT_TWITCH_HEADERS, priv->cancel,
-            G_CALLBACK(handle_channels_response_cb), g_steal_pointer(&ref), GT_HTTP_FLAG_RETURN_STREAM);
+                if (all_pages[i] == priv->stream_pages)
+                    g_hash_table_add(live, chan);
+            }
+        }
     }
-    else
+
+    /* NOTE: Channel listings can't take a stream away, so ask the
+     * channels that we think are live but weren't in the followed streams */
+    if (complete)
     {
-        for (GList* l = priv->loading_list; l != NULL; l = l->next)
+        for (guint i = 0; i < priv->loading.channels->len; i++)
         {
-            GtChannel* chan = l->data;
+            GtChannel* chan = g_ptr_array_index(priv->loading.channels, i);
 
-            RETURN_IF_FAIL(GT_IS_CHANNEL(chan));
-            RETURN_IF_FAIL(g_object_is_floating(chan));
+            if (gt_channel_is_online(chan) && !gt_channel_is_updating(chan)
+                && !g_hash_table_contains(live, chan))
+            {
+                gt_channel_update(chan);
+            }
+        }
+    }
 
-            g_object_ref_sink(chan);
+    for (guint i = 0; i < G_N_ELEMENTS(all_pages); i++)
+        g_ptr_array_set_size(all_pages[i], 0);
 
-            g_signal_connect(chan, "notify::updating",
-                G_CALLBACK(channel_updating_oneshot_cb), self);
+    tmp = priv->follows;
+    priv->follows = priv->loading;
+    priv->loading = tmp;
 
-            g_signal_handlers_block_by_func(chan, channel_followed_cb, self);
+    /* NOTE: The view still has the follows from the snapshot, take away
+     * the ones that have been unfollowed since. If a page is missing we
+     * can't tell which ones those are so keep them followed, they are
+     * still shown and can be unfollowed from there. */
+    if (priv->syncing)
+    {
+        for (guint i = 0; i < priv->loading.channels->len; i++)
+        {
+            GtChannel* chan = g_ptr_array_index(priv->loading.channels, i);
 
-            g_object_set(chan,
-                "auto-update", TRUE,
-                "followed", TRUE,
-                NULL);
-            g_signal_emit(self, sigs[SIG_CHANNEL_FOLLOWED], 0, chan);
+            if (channel_set_contains(&priv->follows, gt_channel_get_id(chan)))
+                continue;
 
-            g_signal_handlers_unblock_by_func(chan, channel_followed_cb, self);
+            if (complete)
+            {
+                unfollow_loaded_channel(self, chan);
+                removed++;
+            }
+            else
+                channel_set_add(&priv->follows, chan);
         }
+    }
+
+    channel_set_remove_all(&priv->loading);
 
-        gt_channel_list_free(self->follow_channels);
-        self->follow_channels = priv->loading_list;
-        priv->loading_list = NULL;
+    if (complete)
+        snapshot_save(self);
+
+    if (priv->syncing)
+    {
+        priv->syncing = FALSE;
 
+        MESSAGE("Synced '%d' follows with '%d' removed in '%" G_GINT64_FORMAT "' ms",
+            priv->follows.channels->len, removed, (g_get_monotonic_time() - priv->load_start_time) / 1000);
+    }
+    else
+    {
         priv->loading_follows = FALSE;
         g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
 
-        MESSAGE("Loaded '%d' follows", g_list_length(self->follow_channels));
+        MESSAGE("Loaded '%d' follows in '%" G_GINT64_FORMAT "' ms", priv->follows.channels->len,
+            (g_get_monotonic_time() - priv->load_start_time) / 1000);
     }
 }
 
 static void
-handle_channels_response_cb(GtHTTP* http,
-    gpointer res, GError* error, gpointer udata)
+handle_page_response_cb(GtHTTP* http,
+    gpointer res, GError* error, gpointer udata);
+
+static void
+request_page(GtFollowsManager* self, FollowsPageKind kind, guint index)
 {
-    RETURN_IF_FAIL(GT_IS_HTTP(http));
-    RETURN_IF_FAIL(udata != NULL);
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    GPtrArray* pages = kind == FOLLOWS_PAGE_STREAMS ? priv->stream_pages : priv->channel_pages;
+    const GtOAuthInfo* info = gt_app_get_oauth_info(main_app);
+    g_autofree gchar* uri = NULL;
 
-    g_autoptr(GWeakRef) ref = udata;
-    g_autoptr(GtFollowsManager) self = g_weak_ref_get(ref);
+    if (kind == FOLLOWS_PAGE_STREAMS)
+    {
+        uri = g_strdup_printf(FOLLOWED_STREAMS_URI, info->oauth_token,
+            FOLLOWS_PAGE_SIZE, index*FOLLOWS_PAGE_SIZE);
+    }
+    else
+    {
+        uri = g_strdup_printf(FOLLOWED_CHANNELS_URI, info->user_id,
+            FOLLOWS_PAGE_SIZE, index*FOLLOWS_PAGE_SIZE);
+    }
 
-    if (!self) {TRACE("Unreffed while waiting"); return;}
+    if (index >= pages->len)
+        g_ptr_array_set_size(pages, index + 1);
 
+    priv->pages_pending++;
+
+    gt_http_get_with_category(main_app->http, uri, "gt-follows-manager", DEFAULT_TWITCH_HEADERS, priv->cancel,
+        G_CALLBACK(handle_page_response_cb), follows_page_data_new(self, priv->cancel, kind, index),
+        GT_HTTP_FLAG_RETURN_STREAM);
+}
+
+/* NOTE: The page can be NULL if it couldn't be loaded, the rest of the
+ * follows are still shown */
+static void
+page_done(GtFollowsManager* self, FollowsPageData* data, GPtrArray* page)
+{
     GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    GPtrArray* pages = data->kind == FOLLOWS_PAGE_STREAMS ? priv->stream_pages : priv->channel_pages;
 
-    RETURN_IF_ERROR(error); /* FIXME: Handle error */
+    RETURN_IF_FAIL(data->index < pages->len);
+    RETURN_IF_FAIL(priv->pages_pending > 0);
 
-    RETURN_IF_FAIL(G_IS_INPUT_STREAM(res));
+    page_results_free(g_ptr_array_index(pages, data->index));
+    g_ptr_array_index(pages, data->index) = page;
 
-    json_parser_load_from_stream_async(priv->json_parser, res, priv->cancel,
-        process_channels_json_cb, g_steal_pointer(&ref));
-}
+    if (!page)
+        priv->pages_failed++;
 
-static void
-handle_streams_response_cb(GtHTTP* http,
-    gpointer res, GError* error, gpointer udata);
+    if (--priv->pages_pending == 0)
+        finish_loading_follows(self);
+}
 
 static void
-process_streams_json_cb(GObject* source,
+process_page_json_cb(GObject* source,
     GAsyncResult* res, gpointer udata)
 {
     RETURN_IF_FAIL(JSON_IS_PARSER(source));
     RETURN_IF_FAIL(G_IS_ASYNC_RESULT(res));
     RETURN_IF_FAIL(udata != NULL);
 
-    g_autoptr(GWeakRef) ref = udata;
-    g_autoptr(GtFollowsManager) self = g_weak_ref_get(ref);
+    g_autoptr(FollowsPageData) data = udata;
+    g_autoptr(GtFollowsManager) self = g_weak_ref_get(data->self);
 
     if (!self)
     {
-        TRACE("Not processing followed channels json because we were unreffed while waiting");
+        TRACE("Not processing follows json because we were unreffed while waiting");
+        return;
+    }
+
+    if (g_cancellable_is_cancelled(data->cancel))
+    {
+        TRACE("Not processing follows json because the load was cancelled");
         return;
     }
 
     GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
     g_autoptr(JsonReader) reader = NULL;
+    g_autoptr(GPtrArray) page = NULL;
     g_autoptr(GError) err = NULL;
     gint num_elements;
     gint64 total;
 
-    json_parser_load_from_stream_finish(priv->json_parser, res, &err);
+    json_parser_load_from_stream_finish(data->json_parser, res, &err);
 
-    RETURN_IF_ERROR(err); /* FIXME: Handle error */
+    if (err)
+    {
+        WARNING("Unable to process follows page because: %s", err->message);
+        page_done(self, data, NULL);
+        return;
+    }
 
-    reader = json_reader_new(json_parser_get_root(priv->json_parser));
+    reader = json_reader_new(json_parser_get_root(data->json_parser));
 
-    if (!json_reader_read_member(reader, "_total")) RETURN_IF_REACHED(); /* FIXME: Handle error */
+    if (!json_reader_read_member(reader, "_total")) goto error;
     total = json_reader_get_int_value(reader);
     json_reader_end_member(reader);
 
-    if (!json_reader_read_member(reader, "streams")) RETURN_IF_REACHED(); /* FIXME: Handle error */
+    if (!json_reader_read_member(reader, data->kind == FOLLOWS_PAGE_STREAMS ? "streams" : "follows")) goto error;
 
     num_elements = json_reader_count_elements(reader);
 
+    page = g_ptr_array_new_full(num_elements, g_object_unref);
+
     for (gint i = 0; i < num_elements; i++)
     {
-        json_reader_read_element(reader, i);
+        GtChannelData* chan_data = NULL;
+        GtChannel* chan = NULL;
+
+        if (!json_reader_read_element(reader, i)) goto error;
 
-        priv->loading_list = g_list_append(priv->loading_list,
-            gt_channel_new(utils_parse_stream_from_json(reader, &err)));
+        if (data->kind == FOLLOWS_PAGE_STREAMS)
+            chan_data = utils_parse_stream_from_json(reader, &err);
+        else
+        {
+            if (!json_reader_read_member(reader, "channel")) goto error;
 
-        RETURN_IF_ERROR(err); /* FIXME: Handle error */
+            chan_data = utils_parse_channel_from_json(reader, &err);
+
+            json_reader_end_member(reader);
+        }
 
         json_reader_end_element(reader);
+
+        if (err)
+        {
+            WARNING("Unable to parse followed channel because: %s", err->message);
+            page_done(self, data, NULL);
+            return;
+        }
+
+        /* NOTE: A channel that is live is in both lists, we don't
+         * want the channel listing to replace the stream */
+        if (data->kind == FOLLOWS_PAGE_CHANNELS
+            && (chan = g_hash_table_lookup(priv->loading.index, chan_data->id)) != NULL)
+        {
+            gt_channel_data_free(chan_data);
+            g_object_ref(chan);
+        }
+        else
+            chan = gt_channel_new(chan_data);
+
+        g_ptr_array_add(page, chan);
     }
 
     json_reader_end_member(reader);
 
-    priv->current_offset += num_elements;
+    /* NOTE: Show the channels as soon as their page is in, only the
+     * order has to wait for the other pages. Not before, a page that
+     * fails halfway never makes it into the follows. When syncing the
+     * view already has the channels we knew about. */
+    for (guint i = 0; i < page->len; i++)
+    {
+        GtChannel* chan = g_ptr_array_index(page, i);
 
-    const GtOAuthInfo* info = gt_app_get_oauth_info(main_app);
+        if (channel_set_add(&priv->loading, chan)
+            && (!priv->syncing || !channel_set_contains(&priv->follows, gt_channel_get_id(chan))))
+        {
+            follow_loaded_channel(self, chan);
+        }
+    }
 
-    g_autofree gchar* uri = NULL;
+    /* NOTE: Now that we know how many follows there are request the
+     * remaining pages all at once, the HTTP category limits how many
+     * are actually in flight */
+    if (data->index == 0)
+    {
+        for (gint64 offset = FOLLOWS_PAGE_SIZE; offset < total; offset += FOLLOWS_PAGE_SIZE)
+            request_page(self, data->kind, offset / FOLLOWS_PAGE_SIZE);
+    }
+
+    page_done(self, data, g_steal_pointer(&page));
+
+    return;
+
+error:
+    WARNING("Unable to process follows page because: %s",
+        json_reader_get_error(reader) ? json_reader_get_error(reader)->message : "Unexpected json");
 
-    if (priv->current_offset < total)
+    page_done(self, data, NULL);
+}
+
+static void
+handle_page_response_cb(GtHTTP* http,
+    gpointer res, GError* error, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP(http));
+    RETURN_IF_FAIL(udata != NULL);
+
+    g_autoptr(FollowsPageData) data = udata;
+    g_autoptr(GtFollowsManager) self = g_weak_ref_get(data->self);
+
+    if (!self) {TRACE("Unreffed while waiting"); return;}
+
+    if (g_cancellable_is_cancelled(data->cancel))
     {
-        uri = g_strdup_printf("https://api.twitch.tv/kraken/streams/followed?oauth_token=%s&limit=%d&offset=%d&stream_type=live",
-            info->oauth_token, 100, priv->current_offset);
+        TRACE("Not handling follows page because the load was cancelled");
+        return;
+    }
 
-        gt_http_get_with_category(main_app->http, uri, "gt-follows-manager", DEFAULT_TWITCH_HEADERS, priv->cancel,
-            G_CALLBACK(handle_streams_response_cb), g_steal_pointer(&ref), GT_HTTP_FLAG_RETURN_STREAM);
+    if (error)
+    {
+        WARNING("Unable to load follows page because: %s", error->message);
+        page_done(self, data, NULL);
+        return;
     }
-    else
+
+    RETURN_IF_FAIL(G_IS_INPUT_STREAM(res));
+
+    json_parser_load_from_stream_async(data->json_parser, res, data->cancel,
+        process_page_json_cb, g_steal_pointer(&data));
+}
+
+static void
+process_status_json_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
+{
+    RETURN_IF_FAIL(JSON_IS_PARSER(source));
+    RETURN_IF_FAIL(G_IS_ASYNC_RESULT(res));
+    RETURN_IF_FAIL(udata != NULL);
+
+    g_autoptr(StatusRefreshData) data = udata;
+    g_autoptr(GtFollowsManager) self = g_weak_ref_get(data->self);
+
+    if (!self) {TRACE("Unreffed while waiting"); return;}
+
+    g_autoptr(JsonReader) reader = NULL;
+    g_autoptr(GHashTable) online = NULL;
+    g_autoptr(GError) err = NULL;
+    guint updated = 0;
+    guint went_offline = 0;
+    gint num_elements;
+
+    json_parser_load_from_stream_finish(data->json_parser, res, &err);
+
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        DEBUG("Refreshing followed channels cancelled");
+        return;
+    }
+    else if (err)
     {
-        priv->current_offset = 0;
+        WARNING("Unable to refresh followed channels because: %s", err->message);
+        return;
+    }
 
-        uri = g_strdup_printf("https://api.twitch.tv/kraken/users/%s/follows/channels?limit=%d&offset=%d",
-            info->user_id, 100, 0);
+    reader = json_reader_new(json_parser_get_root(data->json_parser));
 
-        gt_http_get_with_category(main_app->http, uri, "gt-follows-manager", DEFAULT_TWITCH_HEADERS, priv->cancel,
-            G_CALLBACK(handle_channels_response_cb), g_steal_pointer(&ref), GT_HTTP_FLAG_RETURN_STREAM);
+    if (!json_reader_read_member(reader, "streams"))
+    {
+        WARNING("Unable to refresh followed channels because: %s", json_reader_get_error(reader)->message);
+        return;
     }
+
+    online = g_hash_table_new_full(g_str_hash, g_str_equal,
+        NULL, (GDestroyNotify) gt_channel_data_free);
+
+    num_elements = json_reader_count_elements(reader);
+
+    for (gint i = 0; i < num_elements; i++)
+    {
+        GtChannelData* chan_data = NULL;
+
+        json_reader_read_element(reader, i);
+
+        chan_data = utils_parse_stream_from_json(reader, &err);
+
+        json_reader_end_element(reader);
+
+        if (err)
+        {
+            WARNING("Unable to refresh followed channels because: %s", err->message);
+            return;
+        }
+
+        g_hash_table_replace(online, chan_data->id, chan_data);
+    }
+
+    json_reader_end_member(reader);
+
+    for (guint i = 0; i < data->channels->len; i++)
+    {
+        GtChannel* chan = g_ptr_array_index(data->channels, i);
+        GtChannelData* chan_data = NULL;
+
+        if (g_hash_table_lookup_extended(online, gt_channel_get_id(chan), NULL, (gpointer*) &chan_data))
+        {
+            g_hash_table_steal(online, gt_channel_get_id(chan));
+
+            if (gt_channel_update_from_data(chan, chan_data))
+                updated++;
+        }
+        /* NOTE: Streams only tell us who's live, fetch the channel
+         * data for the few that just went offline */
+        else if (gt_channel_is_online(chan))
+        {
+            g_object_set_data_full(G_OBJECT(chan), "category",
+                g_strdup("gt-channel-auto-update"), g_free);
+
+            gt_channel_update(chan);
+
+            went_offline++;
+        }
+    }
+
+    DEBUG("Refreshed '%d' followed channels, '%d' changed and '%d' went offline",
+        data->channels->len, updated, went_offline);
 }
 
 static void
-handle_streams_response_cb(GtHTTP* http,
+handle_status_response_cb(GtHTTP* http,
     gpointer res, GError* error, gpointer udata)
 {
     RETURN_IF_FAIL(GT_IS_HTTP(http));
     RETURN_IF_FAIL(udata != NULL);
 
-    g_autoptr(GWeakRef) ref = udata;
-    g_autoptr(GtFollowsManager) self = g_weak_ref_get(ref);
+    g_autoptr(StatusRefreshData) data = udata;
+    g_autoptr(GtFollowsManager) self = g_weak_ref_get(data->self);
 
     if (!self) {TRACE("Unreffed while waiting"); return;}
 
     GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
 
-    RETURN_IF_ERROR(error); /* FIXME: Handle error */
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        DEBUG("Refreshing followed channels cancelled");
+        return;
+    }
+    else if (error)
+    {
+        WARNING("Unable to refresh followed channels because: %s", error->message);
+        return;
+    }
 
     RETURN_IF_FAIL(G_IS_INPUT_STREAM(res));
 
-    json_parser_load_from_stream_async(priv->json_parser, res, priv->cancel,
-        process_streams_json_cb, g_steal_pointer(&ref));
+    json_parser_load_from_stream_async(data->json_parser, res, priv->refresh_cancel,
+        process_status_json_cb, g_steal_pointer(&data));
+}
+
+/* NOTE: Polls the online status of all follows in batches instead of
+ * every channel updating itself, only the channels that changed are
+ * then updated */
+static void
+refresh_status(GtFollowsManager* self)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    GPtrArray* channels = priv->follows.channels;
+    guint batches = 0;
+    guint i = 0;
+
+    utils_refresh_cancellable(&priv->refresh_cancel);
+
+    while (i < channels->len)
+    {
+        g_autoptr(StatusRefreshData) data = status_refresh_data_new(self);
+        g_autoptr(GString) ids = g_string_new(NULL);
+        g_autofree gchar* uri = NULL;
+
+        for (; i < channels->len && data->channels->len < STATUS_REFRESH_BATCH_SIZE; i++)
+        {
+            GtChannel* chan = g_ptr_array_index(channels, i);
+
+            /* NOTE: Still loading its initial data */
+            if (gt_channel_is_updating(chan))
+                continue;
+
+            if (ids->len > 0)
+                g_string_append_c(ids, ',');
+            g_string_append(ids, gt_channel_get_id(chan));
+
+            g_ptr_array_add(data->channels, g_object_ref(chan));
+        }
+
+        if (data->channels->len == 0)
+            break;
+
+        uri = g_strdup_printf(STATUS_REFRESH_URI, ids->str, STATUS_REFRESH_BATCH_SIZE);
+
+        gt_http_get_with_category(main_app->http, uri, "gt-channel-auto-update", DEFAULT_TWITCH_HEADERS,
+            priv->refresh_cancel, G_CALLBACK(handle_status_response_cb), g_steal_pointer(&data),
+            GT_HTTP_FLAG_RETURN_STREAM);
+
+        batches++;
+    }
+
+    DEBUG("Refreshing '%d' followed channels in '%d' requests",
+        channels->len, batches);
+}
+
+static gboolean
+refresh_status_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(udata != NULL, G_SOURCE_REMOVE);
+
+    g_autoptr(GtFollowsManager) self = g_weak_ref_get(udata);
+
+    if (!self) {TRACE("Unreffed while waiting"); return G_SOURCE_REMOVE;}
+
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+
+    if (!priv->loading_follows)
+        refresh_status(self);
+
+    return G_SOURCE_CONTINUE;
 }
 
 static void
 finalize(GObject* object)
 {
     GtFollowsManager* self = (GtFollowsManager*) object;
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+
+    if (priv->refresh_id > 0 && main_app->scheduler)
+        gt_scheduler_remove(main_app->scheduler, priv->refresh_id);
+
+    if (priv->refresh_cancel)
+        g_cancellable_cancel(priv->refresh_cancel);
+    g_clear_object(&priv->refresh_cancel);
+
+    if (priv->cancel)
+        g_cancellable_cancel(priv->cancel);
+    g_clear_object(&priv->cancel);
 
-    gt_channel_list_free(self->follow_channels);
+    channel_set_clear(&priv->follows);
+    channel_set_clear(&priv->loading);
+
+    g_ptr_array_unref(priv->stream_pages);
+    g_ptr_array_unref(priv->channel_pages);
 
     G_OBJECT_CLASS(gt_follows_manager_parent_class)->finalize(object);
 }
@@ -777,10 +1497,11 @@ gt_follows_manager_init(GtFollowsManager* self)
 
     GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
 
-    priv->json_parser = json_parser_new();
-    priv->loading_list = NULL;
+    channel_set_init(&priv->follows);
+    channel_set_init(&priv->loading);
 
-    self->follow_channels = NULL;
+    priv->stream_pages = g_ptr_array_new_with_free_func(page_results_free);
+    priv->channel_pages = g_ptr_array_new_with_free_func(page_results_free);
 
     g_autofree gchar* old_fp = OLD_FAV_CHANNELS_FILE;
     g_autofree gchar* new_fp = FAV_CHANNELS_FILE;
@@ -788,6 +1509,9 @@ gt_follows_manager_init(GtFollowsManager* self)
     g_signal_connect(main_app, "shutdown", G_CALLBACK(shutdown_cb), self);
     g_signal_connect(main_app, "notify::logged-in", G_CALLBACK(logged_in_cb), self);
 
+    priv->refresh_id = gt_scheduler_add(main_app->scheduler, STATUS_REFRESH_INTERVAL,
+        refresh_status_cb, utils_weak_ref_new(self), (GDestroyNotify) utils_weak_ref_free);
+
     //TODO: Remove this in a release or two
     if (g_file_test(old_fp, G_FILE_TEST_EXISTS))
         g_rename(old_fp, new_fp);
@@ -799,22 +1523,44 @@ gt_follows_manager_load_from_twitch(GtFollowsManager* self)
     RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(self));
 
     GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
-
-    priv->loading_follows = TRUE;
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
-
     const GtOAuthInfo* info = gt_app_get_oauth_info(main_app);
-    g_autofree gchar* uri = NULL;
 
     utils_refresh_cancellable(&priv->cancel);
 
-    priv->current_offset = 0;
+    /* NOTE: Throw away anything left over from a cancelled load */
+    channel_set_remove_all(&priv->loading);
+    g_ptr_array_set_size(priv->stream_pages, 0);
+    g_ptr_array_set_size(priv->channel_pages, 0);
 
-    uri = g_strdup_printf("https://api.twitch.tv/kraken/streams/followed?oauth_token=%s&limit=%d&offset=%d&stream_type=live",
-        info->oauth_token, 100, 0);
+    priv->pages_pending = 0;
+    priv->pages_failed = 0;
+    priv->syncing = FALSE;
+    priv->load_start_time = g_get_monotonic_time();
 
-    gt_http_get_with_category(main_app->http, uri, "gt-follows-manager", DEFAULT_TWITCH_HEADERS, priv->cancel,
-        G_CALLBACK(handle_streams_response_cb), utils_weak_ref_new(self), GT_HTTP_FLAG_RETURN_STREAM);
+    /* NOTE: Show the follows from last time straight away and only
+     * apply what changed once they have been synced */
+    if (priv->follows.channels->len == 0 && snapshot_load(self, info->user_id))
+    {
+        priv->syncing = TRUE;
+
+        MESSAGE("Showing '%d' follows from snapshot in '%" G_GINT64_FORMAT "' ms",
+            priv->follows.channels->len, (g_get_monotonic_time() - priv->load_start_time) / 1000);
+
+        if (priv->loading_follows)
+        {
+            priv->loading_follows = FALSE;
+            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
+        }
+    }
+    else
+    {
+        priv->loading_follows = TRUE;
+        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
+    }
+
+    /* NOTE: The first page of each tells us how many more to request */
+    request_page(self, FOLLOWS_PAGE_STREAMS, 0);
+    request_page(self, FOLLOWS_PAGE_CHANNELS, 0);
 }
 
 void
@@ -825,14 +1571,14 @@ gt_follows_manager_load_from_file(GtFollowsManager* self)
     GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
     g_autofree gchar* filepath = FAV_CHANNELS_FILE;
     g_autoptr(GError) err = NULL;
+    gint64 start_time = g_get_monotonic_time();
 
     priv->loading_follows = TRUE;
     g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
 
-    g_clear_pointer(&self->follow_channels,
-        (GDestroyNotify) gt_channel_list_free);
+    channel_set_remove_all(&priv->follows);
 
-    self->follow_channels = load_from_file(filepath, &err);
+    load_from_file(filepath, &priv->follows, &err);
 
     if (err)
     {
@@ -853,25 +1599,17 @@ gt_follows_manager_load_from_file(GtFollowsManager* self)
         return;
     }
 
-    for (GList* l = self->follow_channels; l != NULL; l = l->next)
+    for (guint i = 0; i < priv->follows.channels->len; i++)
     {
-        GtChannel* chan = l->data;
+        GtChannel* chan = g_ptr_array_index(priv->follows.channels, i);
 
         RETURN_IF_FAIL(GT_IS_CHANNEL(chan));
 
-        g_signal_handlers_block_by_func(chan, channel_followed_cb, self);
-
-        g_object_set(chan,
-            "auto-update", TRUE,
-            "followed", TRUE,
-            NULL);
-
-        g_signal_handlers_unblock_by_func(chan, channel_followed_cb, self);
-
-        g_signal_connect(chan, "notify::updating", G_CALLBACK(channel_updating_oneshot_cb), self);
+        follow_loaded_channel(self, chan);
     }
 
-    MESSAGE("Loaded '%d' follows from file", g_list_length(self->follow_channels));
+    MESSAGE("Loaded '%d' follows from file in '%" G_GINT64_FORMAT "' ms", priv->follows.channels->len,
+        (g_get_monotonic_time() - start_time) / 1000);
 
 finish:
     priv->loading_follows = FALSE;
@@ -885,17 +1623,15 @@ gt_follows_manager_save(GtFollowsManager* self)
 {
     RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(self));
 
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
     g_autofree gchar* fp = FAV_CHANNELS_FILE;
 
     MESSAGE("Saving follows to file '%s'", fp);
 
-    if (g_list_length(self->follow_channels) == 0)
+    if (priv->follows.channels->len == 0)
     {
         if (g_file_test(fp, G_FILE_TEST_EXISTS))
-        {
             g_remove(fp);
-            g_free(fp);
-        }
 
         return;
     }
@@ -917,15 +1653,17 @@ gt_follows_manager_save(GtFollowsManager* self)
 
     json_builder_begin_array(builder);
 
-    for (GList* l = self->follow_channels; l != NULL; l = l->next)
+    for (guint i = 0; i < priv->follows.channels->len; i++)
     {
+        GtChannel* chan = g_ptr_array_index(priv->follows.channels, i);
+
         json_builder_begin_object(builder);
 
         json_builder_set_member_name(builder, "id");
-        json_builder_add_string_value(builder, gt_channel_get_id(l->data));
+        json_builder_add_string_value(builder, gt_channel_get_id(chan));
 
         json_builder_set_member_name(builder, "name");
-        json_builder_add_string_value(builder, gt_channel_get_name(l->data));
+        json_builder_add_string_value(builder, gt_channel_get_name(chan));
 
         json_builder_end_object(builder);
     }
@@ -946,7 +1684,25 @@ gt_follows_manager_is_channel_followed(GtFollowsManager* self, GtChannel* chan)
     RETURN_VAL_IF_FAIL(GT_IS_FOLLOWS_MANAGER(self), FALSE);
     RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(chan), FALSE);
 
-    return g_list_find_custom(self->follow_channels, chan, (GCompareFunc) gt_channel_compare) != NULL;
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+
+    return channel_set_contains(&priv->follows, gt_channel_get_id(chan));
+}
+
+GList*
+gt_follows_manager_get_followed_channels(GtFollowsManager* self)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_FOLLOWS_MANAGER(self), NULL);
+
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    /* NOTE: While loading these are the follows that have come in so far */
+    GPtrArray* channels = priv->loading_follows ? priv->loading.channels : priv->follows.channels;
+    GList* ret = NULL;
+
+    for (guint i = channels->len; i > 0; i--)
+        ret = g_list_prepend(ret, g_ptr_array_index(channels, i - 1));
+
+    return ret;
 }
 
 gboolean
@@ -976,5 +1732,5 @@ gt_follows_manager_refresh(GtFollowsManager* self)
     if (gt_app_is_logged_in(main_app))
         gt_follows_manager_load_from_twitch(self);
     else
-        g_list_foreach(self->follow_channels, (GFunc) gt_channel_update, NULL);
+        refresh_status(self);
 }
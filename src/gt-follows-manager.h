@@ -34,8 +34,6 @@ typedef struct _GtFollowsManagerPrivate GtFollowsManagerPrivate;
 struct _GtFollowsManager
 {
     GObject parent_instance;
-
-    GList* follow_channels;
 };
 
 GtFollowsManager* gt_follows_manager_new(void);
@@ -43,6 +41,7 @@ void              gt_follows_manager_load_from_file(GtFollowsManager* self);
 void              gt_follows_manager_load_from_twitch(GtFollowsManager* self);
 void              gt_follows_manager_save(GtFollowsManager* self);
 gboolean          gt_follows_manager_is_channel_followed(GtFollowsManager* self, GtChannel* chan);
+GList*            gt_follows_manager_get_followed_channels(GtFollowsManager* self);
 gboolean          gt_follows_manager_is_loading_follows(GtFollowsManager* self);
 void              gt_follows_manager_attach_to_channel(GtFollowsManager* self, GtChannel* chan);
 void              gt_follows_manager_refresh(GtFollowsManager* self);
@@ -84,7 +84,7 @@ process_json_cb(GObject* source,
 
     GtGameChannelContainerPrivate* priv = gt_game_channel_container_get_instance_private(self);
     g_autoptr(JsonReader) reader = NULL;
-    g_autoptr(GtGameList) items = NULL;
+    g_autoptr(GtChannelList) items = NULL;
     g_autoptr(GError) err = NULL;
 
     json_parser_load_from_stream_finish(priv->json_parser, res, &err);
@@ -141,7 +141,7 @@ process_json_cb(GObject* source,
 
     json_reader_end_member(reader);
 
-    gt_item_container_append_items(GT_ITEM_CONTAINER(self), g_steal_pointer(&items));
+    gt_item_container_append_items(GT_ITEM_CONTAINER(self), items);
     gt_item_container_set_fetching_items(GT_ITEM_CONTAINER(self), FALSE);
 }
 
@@ -209,6 +209,17 @@ create_child(GtItemContainer* item_container, gpointer data)
     return GTK_WIDGET(gt_channels_container_child_new(GT_CHANNEL(data)));
 }
 
+static void
+bind_child(GtItemContainer* item_container,
+    GtkWidget* child, gpointer data)
+{
+    g_assert(GT_IS_GAME_CHANNEL_CONTAINER(item_container));
+    g_assert(GT_IS_CHANNELS_CONTAINER_CHILD(child));
+    g_assert(GT_IS_CHANNEL(data));
+
+    g_object_set(child, "channel", data, NULL);
+}
+
 static void
 activate_child(GtItemContainer* item_container,
     gpointer child)
@@ -265,6 +276,7 @@ gt_game_channel_container_class_init(GtGameChannelContainerClass* klass)
     G_OBJECT_CLASS(klass)->set_property = set_property;
 
     GT_ITEM_CONTAINER_CLASS(klass)->create_child = create_child;
+    GT_ITEM_CONTAINER_CLASS(klass)->bind_child = bind_child;
     GT_ITEM_CONTAINER_CLASS(klass)->get_properties = get_properties;
     GT_ITEM_CONTAINER_CLASS(klass)->request_extra_items = request_extra_items;
     GT_ITEM_CONTAINER_CLASS(klass)->activate_child = activate_child;
@@ -26,12 +26,18 @@
 #define TAG "GtGame"
 #include "gnome-twitch/gt-log.h"
 
+#define PREVIEW_WIDTH 200
+#define PREVIEW_HEIGHT 270
+
 typedef struct
 {
     GtGameData* data;
 
     gboolean updating;
 
+    gboolean in_view;
+    gboolean preview_pending; /* NOTE: Waiting to come into view */
+
     GdkPixbuf* preview;
 
     GdkPixbuf* logo;
@@ -47,6 +53,7 @@ enum
     PROP_ID,
     PROP_NAME,
     PROP_UPDATING,
+    PROP_IN_VIEW,
     PROP_PREVIEW_URL,
     PROP_PREVIEW,
     PROP_LOGO,
@@ -73,6 +80,21 @@ notify_preview_cb(gpointer udata)
     return G_SOURCE_REMOVE;
 }
 
+static void update_preview(GtGame* self);
+
+static void
+preview_cancelled(GtGame* self)
+{
+    GtGamePrivate* priv = gt_game_get_instance_private(self);
+
+    /* NOTE: Scrolled back into view before the cancelled download
+     * got back to us */
+    if (priv->preview_pending && priv->in_view)
+        update_preview(self);
+    else
+        notify_preview_cb(self);
+}
+
 static void
 handle_preview_download_cb(GObject* source,
     GAsyncResult* res, gpointer udata)
@@ -87,11 +109,23 @@ handle_preview_download_cb(GObject* source,
 
     GtGamePrivate* priv = gt_game_get_instance_private(self);
     g_autoptr(GError) err = NULL;
+    g_autoptr(GdkPixbuf) preview = gdk_pixbuf_new_from_stream_finish(res, &err);
+
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        preview_cancelled(self);
 
-    priv->preview = gdk_pixbuf_new_from_stream_finish(res, &err);
+        return;
+    }
 
     RETURN_IF_FAIL(err == NULL); /* FIXME: Handle error */
 
+    g_clear_object(&priv->preview);
+    priv->preview = g_steal_pointer(&preview);
+
+    gt_image_cache_insert(main_app->image_cache, priv->data->preview_url,
+        PREVIEW_WIDTH, PREVIEW_HEIGHT, priv->preview, 0);
+
     notify_preview_cb(self);
 }
 
@@ -109,11 +143,18 @@ handle_preview_response_cb(GtHTTP* http,
 
     GtGamePrivate* priv = gt_game_get_instance_private(self);
 
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        preview_cancelled(self);
+
+        return;
+    }
+
     RETURN_IF_ERROR(error); /* FIXME: Handle error */
 
     RETURN_IF_FAIL(G_IS_INPUT_STREAM(res));
 
-    gdk_pixbuf_new_from_stream_at_scale_async(res, 200, 270, FALSE,
+    gdk_pixbuf_new_from_stream_at_scale_async(res, PREVIEW_WIDTH, PREVIEW_HEIGHT, FALSE,
         priv->cancel, handle_preview_download_cb, g_steal_pointer(&ref));
 }
 
@@ -124,13 +165,87 @@ update_preview(GtGame* self)
 
     GtGamePrivate* priv = gt_game_get_instance_private(self);
     g_autoptr(SoupMessage) msg = NULL;
+    g_autoptr(GdkPixbuf) cached = NULL;
 
     utils_refresh_cancellable(&priv->cancel);
 
+    /* NOTE: Already decoded for another view */
+    if ((cached = gt_image_cache_lookup(main_app->image_cache, priv->data->preview_url, PREVIEW_WIDTH, PREVIEW_HEIGHT)) != NULL)
+    {
+        priv->preview_pending = FALSE;
+
+        g_clear_object(&priv->preview);
+        priv->preview = g_steal_pointer(&cached);
+
+        notify_preview_cb(self);
+
+        return;
+    }
+
+    /* NOTE: Leave the download until the game is scrolled near */
+    if (!priv->in_view)
+    {
+        priv->preview_pending = TRUE;
+
+        notify_preview_cb(self);
+
+        return;
+    }
+
+    priv->preview_pending = FALSE;
+
     gt_http_get_with_category(main_app->http, priv->data->preview_url, "gt-game", DEFAULT_TWITCH_HEADERS, priv->cancel,
         G_CALLBACK(handle_preview_response_cb), utils_weak_ref_new(self), GT_HTTP_FLAG_RETURN_STREAM | GT_HTTP_FLAG_CACHE_RESPONSE);
 }
 
+/* NOTE: The image cache keeps its own reference for as long as its
+ * budget allows, so coming back into view is usually just a lookup */
+static void
+release_preview(GtGame* self)
+{
+    GtGamePrivate* priv = gt_game_get_instance_private(self);
+
+    if (!priv->data)
+        return;
+
+    g_cancellable_cancel(priv->cancel);
+
+    priv->preview_pending = TRUE;
+
+    if (priv->preview)
+    {
+        g_clear_object(&priv->preview);
+        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PREVIEW]);
+    }
+}
+
+static void
+set_in_view(GtGame* self, gboolean in_view)
+{
+    GtGamePrivate* priv = gt_game_get_instance_private(self);
+
+    if (priv->in_view == in_view)
+        return;
+
+    priv->in_view = in_view;
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_IN_VIEW]);
+
+    if (!in_view)
+    {
+        release_preview(self);
+
+        return;
+    }
+
+    if (priv->preview_pending && !priv->updating)
+    {
+        priv->updating = TRUE;
+        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_UPDATING]);
+
+        update_preview(self);
+    }
+}
+
 static void
 update_from_data(GtGame* self, GtGameData* data)
 {
@@ -227,6 +342,9 @@ get_property (GObject*    obj,
         case PROP_UPDATING:
             g_value_set_boolean(val, priv->updating);
             break;
+        case PROP_IN_VIEW:
+            g_value_set_boolean(val, priv->in_view);
+            break;
         case PROP_PREVIEW_URL:
             g_value_set_string(val, priv->data->preview_url);
             break;
@@ -253,8 +371,13 @@ set_property(GObject*      obj,
              const GValue* val,
              GParamSpec*   pspec)
 {
+    GtGame* self = GT_GAME(obj);
+
     switch (prop)
     {
+        case PROP_IN_VIEW:
+            set_in_view(self, g_value_get_boolean(val));
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
     }
@@ -279,6 +402,9 @@ gt_game_class_init(GtGameClass* klass)
     props[PROP_UPDATING] = g_param_spec_boolean("updating", "Updating", "Whether updating",
         FALSE, G_PARAM_READABLE);
 
+    props[PROP_IN_VIEW] = g_param_spec_boolean("in-view", "In view", "Whether the game is shown in or near a view",
+        FALSE, G_PARAM_READWRITE);
+
     props[PROP_PREVIEW_URL] = g_param_spec_string("preview-url", "Preview Url", "Current preview url",
         NULL, G_PARAM_READABLE);
 
@@ -305,6 +431,8 @@ gt_game_init(GtGame* self)
     GtGamePrivate* priv = gt_game_get_instance_private(self);
 
     priv->updating = FALSE;
+    priv->in_view = FALSE;
+    priv->preview_pending = FALSE;
     priv->preview = NULL;
     priv->logo = NULL;
 }
@@ -34,6 +34,8 @@ typedef struct
     GtkWidget* name_label;
     GtkWidget* viewers_label;
     GtkWidget* viewers_image;
+
+    GPtrArray* bindings; /* NOTE: Dropped when rebound to another game */
 } GtGamesContainerChildPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GtGamesContainerChild, gt_games_container_child, GTK_TYPE_FLOW_BOX_CHILD)
@@ -118,13 +120,56 @@ updating_cb(GObject* source,
         gt_game_get_updating(game) ? "load-spinner" : "cover");
 }
 
+/* NOTE: Children are recycled by the item containers as they're
+ * scrolled, so the game can change at any time */
+static void
+set_game(GtGamesContainerChild* self, GtGame* game)
+{
+    GtGamesContainerChildPrivate* priv = gt_games_container_child_get_instance_private(self);
+
+    if (priv->game)
+    {
+        g_ptr_array_set_size(priv->bindings, 0);
+        g_signal_handlers_disconnect_by_data(priv->game, self);
+        g_clear_object(&priv->game);
+    }
+
+    if (!game)
+        return;
+
+    gtk_revealer_set_reveal_child(GTK_REVEALER(priv->cover_overlay_revealer), FALSE);
+
+    priv->game = game;
+
+    g_ptr_array_add(priv->bindings, g_object_bind_property(priv->game, "name",
+            priv->name_label, "label", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(priv->game, "preview",
+            priv->cover_image, "pixbuf", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+
+    g_signal_connect_object(priv->game, "notify::viewers", G_CALLBACK(update_viewers_cb), self, 0);
+    g_signal_connect_object(priv->game, "notify::updating", G_CALLBACK(updating_cb), self, 0);
+
+    update_viewers_cb(G_OBJECT(priv->game), NULL, self);
+    updating_cb(G_OBJECT(priv->game), NULL, self);
+}
+
+static void
+dispose(GObject* object)
+{
+    GtGamesContainerChild* self = GT_GAMES_CONTAINER_CHILD(object);
+
+    set_game(self, NULL);
+
+    G_OBJECT_CLASS(gt_games_container_child_parent_class)->dispose(object);
+}
+
 static void
 finalize(GObject* object)
 {
     GtGamesContainerChild* self = (GtGamesContainerChild*) object;
     GtGamesContainerChildPrivate* priv = gt_games_container_child_get_instance_private(self);
 
-    g_object_unref(priv->game);
+    g_ptr_array_unref(priv->bindings);
 
     G_OBJECT_CLASS(gt_games_container_child_parent_class)->finalize(object);
 }
@@ -159,51 +204,28 @@ set_property(GObject* obj,
     switch (prop)
     {
         case PROP_GAME:
-            g_clear_object(&priv->game);
-            priv->game = utils_value_ref_sink_object(val);
+            set_game(self, utils_value_ref_sink_object(val));
             break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
     }
 }
 
-static void
-constructed(GObject* obj)
-{
-    GtGamesContainerChild* self = GT_GAMES_CONTAINER_CHILD(obj);
-    GtGamesContainerChildPrivate* priv = gt_games_container_child_get_instance_private(self);
-
-    g_object_bind_property(priv->game, "name",
-                           priv->name_label, "label",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(priv->game, "preview",
-                           priv->cover_image, "pixbuf",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-
-    g_signal_connect(priv->game, "notify::viewers", G_CALLBACK(update_viewers_cb), self);
-    g_signal_connect_object(priv->game, "notify::updating", G_CALLBACK(updating_cb), self, 0);
-
-    update_viewers_cb(G_OBJECT(priv->game), NULL, self);
-    updating_cb(G_OBJECT(priv->game), NULL, self);
-
-    G_OBJECT_CLASS(gt_games_container_child_parent_class)->constructed(obj);
-}
-
 static void
 gt_games_container_child_class_init(GtGamesContainerChildClass* klass)
 {
     GObjectClass* object_class = G_OBJECT_CLASS(klass);
 
+    object_class->dispose = dispose;
     object_class->finalize = finalize;
     object_class->get_property = get_property;
     object_class->set_property = set_property;
-    object_class->constructed = constructed;
 
     props[PROP_GAME] = g_param_spec_object("game",
                                            "Game",
                                            "Associated game",
                                            GT_TYPE_GAME,
-                                           G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+                                           G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
 
     g_object_class_install_properties(object_class,
                                       NUM_PROPS,
@@ -226,6 +248,8 @@ gt_games_container_child_init(GtGamesContainerChild* self)
 {
     GtGamesContainerChildPrivate* priv = gt_games_container_child_get_instance_private(self);
 
+    priv->bindings = g_ptr_array_new_with_free_func((GDestroyNotify) g_binding_unbind);
+
     gtk_widget_init_template(GTK_WIDGET(self));
 }
 
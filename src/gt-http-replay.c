@@ -0,0 +1,675 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-http-replay.h"
+#include "gt-http.h"
+#include "gt-http-stats.h"
+#include "gt-cache.h"
+#include "gt-app.h"
+#include "utils.h"
+#include "config.h"
+#include <libsoup/soup.h>
+
+#define TAG "GtHTTPReplay"
+#include "gnome-twitch/gt-log.h"
+
+typedef struct
+{
+    GQueue* message_queue;
+    GHashTable* inflight_table;
+    GtHTTPStats* stats;
+
+    guint max_inflight_per_category;
+    gchar* cache_directory;
+    gchar* fixture_directory;
+    guint latency;
+    guint bandwidth;
+    gboolean playback_active;
+
+    guint64 requests;
+    guint64 bytes;
+} GtHTTPReplayPrivate;
+
+typedef struct
+{
+    GWeakRef* self;
+    gchar* uri;
+    gchar* category;
+    GCancellable* cancel;
+    GtHTTPStreamCallback cb_stream;
+    GtHTTPDataCallback cb_data;
+    gpointer udata;
+    gint flags;
+    GBytes* body;
+    GError* error;
+    gint64 queued_time;
+    GDateTime* last_updated;
+    GDateTime* expiry;
+    gchar* etag;
+    gboolean cached;
+} ReplayCallbackData;
+
+static void gt_http_iface_init(GtHTTPInterface* iface);
+
+G_DEFINE_TYPE_WITH_CODE(GtHTTPReplay, gt_http_replay, G_TYPE_OBJECT,
+    G_IMPLEMENT_INTERFACE(GT_TYPE_HTTP, gt_http_iface_init)
+    G_ADD_PRIVATE(GtHTTPReplay));
+
+enum
+{
+    PROP_0,
+    PROP_MAX_INFLIGHT_PER_CATEGORY,
+    PROP_CACHE_DIRECTORY,
+    PROP_FIXTURE_DIRECTORY,
+    PROP_LATENCY,
+    PROP_BANDWIDTH,
+    PROP_REQUESTS,
+    PROP_BYTES,
+    PROP_PLAYBACK_ACTIVE,
+    NUM_PROPS,
+};
+
+static GParamSpec* props[NUM_PROPS];
+
+#define NO_CATEGORY "_NO_CATEGORY"
+
+static ReplayCallbackData*
+replay_callback_data_new(GtHTTPReplay* self, const gchar* uri, const gchar* category,
+    GCancellable* cancel, GCallback cb, gpointer udata, gint flags)
+{
+    ReplayCallbackData* data = g_slice_new0(ReplayCallbackData);
+
+    data->self = utils_weak_ref_new(self);
+    data->uri = g_strdup(uri);
+    data->category = g_strdup(category);
+    data->cancel = cancel ? g_object_ref(cancel) : NULL;
+    data->udata = udata;
+    data->flags = flags;
+    data->queued_time = g_get_monotonic_time();
+    if (flags & GT_HTTP_FLAG_RETURN_STREAM)
+        data->cb_stream = (GtHTTPStreamCallback) cb;
+    else if (flags & GT_HTTP_FLAG_RETURN_DATA)
+        data->cb_data = (GtHTTPDataCallback) cb;
+    else
+        RETURN_VAL_IF_REACHED(NULL);
+
+    return data;
+}
+
+static void
+replay_callback_data_free(ReplayCallbackData* data)
+{
+    if (!data) return;
+
+    g_free(data->uri);
+    g_free(data->category);
+    utils_weak_ref_free(data->self);
+    if (data->cancel) g_object_unref(data->cancel);
+    if (data->body) g_bytes_unref(data->body);
+    if (data->error) g_error_free(data->error);
+    if (data->last_updated) g_date_time_unref(data->last_updated);
+    if (data->expiry) g_date_time_unref(data->expiry);
+    g_free(data->etag);
+
+    g_slice_free(ReplayCallbackData, data);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(ReplayCallbackData, replay_callback_data_free);
+
+static void send_next_message(GtHTTPReplay* self);
+
+gchar*
+gt_http_replay_fixture_name(const gchar* uri)
+{
+    RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
+
+    return g_compute_checksum_for_string(G_CHECKSUM_SHA1, uri, -1);
+}
+
+static GDateTime*
+parse_http_time(const gchar* time)
+{
+    GDateTime* ret = NULL;
+    g_autoptr(SoupDate) soup_date = NULL;
+
+    if (utils_str_empty(time))
+        return NULL;
+
+    if ((soup_date = soup_date_new_from_string(time)) == NULL)
+        return NULL;
+
+    ret = g_date_time_new_from_unix_utc(soup_date_to_time_t(soup_date));
+
+    return ret;
+}
+
+/* NOTE: Header names are recorded the way the server sent them */
+static gchar*
+fixture_header(GKeyFile* meta, const gchar* name)
+{
+    g_auto(GStrv) keys = g_key_file_get_keys(meta, GT_HTTP_FIXTURE_GROUP_HEADERS, NULL, NULL);
+
+    for (gchar** key = keys; key && *key; key++)
+    {
+        if (g_ascii_strcasecmp(*key, name) == 0)
+            return g_key_file_get_string(meta, GT_HTTP_FIXTURE_GROUP_HEADERS, *key, NULL);
+    }
+
+    return NULL;
+}
+
+/* NOTE: Does what GtHTTPSoup and the server would do together. A copy
+ * the validators say is still current costs a 304 instead of the
+ * body, and only streams can be answered from the cache. */
+static gboolean
+check_cache(GtHTTPReplay* self, ReplayCallbackData* msg)
+{
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+    g_autoptr(GDateTime) last_updated = NULL;
+    g_autofree gchar* etag = NULL;
+    gboolean not_modified = FALSE;
+
+    if (!(msg->flags & GT_HTTP_FLAG_RETURN_STREAM))
+    {
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_CACHE_MISSES, 1);
+
+        return FALSE;
+    }
+
+    if (gt_cache_get_validators(main_app->cache, msg->uri, &last_updated, &etag))
+    {
+        if (!utils_str_empty(etag) && !utils_str_empty(msg->etag))
+            not_modified = STRING_EQUALS(etag, msg->etag);
+        else if (last_updated && msg->last_updated)
+            not_modified = g_date_time_compare(msg->last_updated, last_updated) <= 0;
+    }
+
+    if (not_modified)
+    {
+        DEBUG("Revalidated cached response for '%s'", msg->uri);
+
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_NOT_MODIFIED, 1);
+
+        gt_cache_mark_data_fresh(main_app->cache, msg->uri, msg->expiry);
+
+        return TRUE;
+    }
+
+    if (msg->last_updated && !gt_cache_is_data_stale(main_app->cache, msg->uri, msg->last_updated, msg->etag))
+    {
+        DEBUG("Cache hit for '%s'", msg->uri);
+
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_CACHE_HITS, 1);
+
+        return TRUE;
+    }
+
+    DEBUG("Cache miss for '%s'", msg->uri);
+
+    gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_CACHE_MISSES, 1);
+
+    return FALSE;
+}
+
+static void
+load_fixture(GtHTTPReplay* self, ReplayCallbackData* msg)
+{
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+    g_autofree gchar* name = gt_http_replay_fixture_name(msg->uri);
+    g_autofree gchar* meta_name = g_strconcat(name, GT_HTTP_FIXTURE_META_SUFFIX, NULL);
+    g_autofree gchar* body_filename = g_build_filename(priv->fixture_directory, name, NULL);
+    g_autofree gchar* meta_filename = g_build_filename(priv->fixture_directory, meta_name, NULL);
+    g_autoptr(GKeyFile) meta = g_key_file_new();
+    g_autoptr(GError) err = NULL;
+    gchar* contents = NULL;
+    gsize length = 0;
+    guint status;
+
+    if (!g_key_file_load_from_file(meta, meta_filename, G_KEY_FILE_NONE, &err))
+    {
+        g_set_error(&msg->error, GT_HTTP_ERROR, GT_HTTP_ERROR_NOT_FOUND,
+            "No fixture for uri '%s' at '%s' because: %s", msg->uri, meta_filename, err->message);
+
+        return;
+    }
+
+    status = g_key_file_get_integer(meta, GT_HTTP_FIXTURE_GROUP_RESPONSE, "status", NULL);
+
+    if (status < 200 || status > 299)
+    {
+        g_set_error(&msg->error, GT_HTTP_ERROR,
+            status == GT_HTTP_ERROR_NOT_FOUND ? GT_HTTP_ERROR_NOT_FOUND : GT_HTTP_ERROR_UNSUCCESSFUL_RESPONSE,
+            "Received unsuccesful response '%u' from uri '%s'", status, msg->uri);
+
+        return;
+    }
+
+    if (msg->flags & GT_HTTP_FLAG_CACHE_RESPONSE && main_app->cache)
+    {
+        g_autofree gchar* last_modified = fixture_header(meta, "Last-Modified");
+        g_autofree gchar* expires = fixture_header(meta, "Expires");
+
+        msg->last_updated = parse_http_time(last_modified);
+        msg->expiry = parse_http_time(expires);
+        msg->etag = fixture_header(meta, "ETag");
+
+        /* NOTE: The body isn't transferred when the cache answers */
+        if ((msg->cached = check_cache(self, msg)))
+            return;
+    }
+
+    if (!g_file_get_contents(body_filename, &contents, &length, &err))
+    {
+        g_set_error(&msg->error, GT_HTTP_ERROR, GT_HTTP_ERROR_UNKNOWN,
+            "Unable to read fixture body for uri '%s' because: %s", msg->uri, err->message);
+
+        return;
+    }
+
+    msg->body = g_bytes_new_take(contents, length);
+}
+
+static inline guint
+transfer_time(GtHTTPReplay* self, ReplayCallbackData* msg)
+{
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+    guint ret = priv->latency;
+
+    /* NOTE: Bandwidth is shaped per request and doesn't model
+     * several requests sharing one link */
+    if (msg->body && priv->bandwidth > 0)
+        ret += (guint) (g_bytes_get_size(msg->body) * 1000 / priv->bandwidth);
+
+    return ret;
+}
+
+static void
+deliver_response(GtHTTPReplay* self, ReplayCallbackData* msg)
+{
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+
+    if (g_cancellable_is_cancelled(msg->cancel))
+    {
+        g_clear_error(&msg->error);
+        g_set_error(&msg->error, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Cancelled");
+    }
+
+    priv->requests++;
+
+    gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_REQUESTS, 1);
+    gt_http_stats_add_timing(priv->stats, msg->category, GT_HTTP_STATS_TOTAL_TIME,
+        g_get_monotonic_time() - msg->queued_time);
+
+    if (msg->error)
+    {
+        gt_http_stats_add(priv->stats, msg->category,
+            g_error_matches(msg->error, G_IO_ERROR, G_IO_ERROR_CANCELLED) ?
+            GT_HTTP_STATS_CANCELLED : GT_HTTP_STATS_ERRORS, 1);
+
+        if (!g_error_matches(msg->error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            WARNING("%s", msg->error->message);
+
+        if (msg->flags & GT_HTTP_FLAG_RETURN_STREAM)
+            msg->cb_stream(GT_HTTP(self), NULL, g_steal_pointer(&msg->error), msg->udata);
+        else
+            msg->cb_data(GT_HTTP(self), NULL, 0, g_steal_pointer(&msg->error), msg->udata);
+
+        return;
+    }
+
+    if (msg->cached)
+    {
+        g_autoptr(GError) err = NULL;
+        g_autoptr(GInputStream) istream = gt_cache_get_data_stream(main_app->cache, msg->uri, &err);
+
+        if (err)
+        {
+            g_prefix_error(&err, "Couldn't get data stream for cached file because: ");
+            WARNING("%s", err->message);
+
+            gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_ERRORS, 1);
+
+            msg->cb_stream(GT_HTTP(self), NULL, g_steal_pointer(&err), msg->udata);
+
+            return;
+        }
+
+        DEBUG("Replaying cached response for uri '%s'", msg->uri);
+
+        msg->cb_stream(GT_HTTP(self), istream, NULL, msg->udata);
+
+        return;
+    }
+
+    priv->bytes += g_bytes_get_size(msg->body);
+
+    gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_BYTES, g_bytes_get_size(msg->body));
+
+    DEBUG("Replaying '%" G_GSIZE_FORMAT "' bytes for uri '%s'", g_bytes_get_size(msg->body), msg->uri);
+
+    if (msg->flags & GT_HTTP_FLAG_CACHE_RESPONSE && main_app->cache)
+    {
+        gsize length;
+        gconstpointer data = g_bytes_get_data(msg->body, &length);
+
+        gt_cache_save_data(main_app->cache, msg->uri, data, length, msg->last_updated, msg->expiry, msg->etag);
+    }
+
+    if (msg->flags & GT_HTTP_FLAG_RETURN_STREAM)
+    {
+        g_autoptr(GInputStream) istream = g_memory_input_stream_new_from_bytes(msg->body);
+
+        msg->cb_stream(GT_HTTP(self), istream, NULL, msg->udata);
+    }
+    else
+    {
+        gsize length;
+        gconstpointer data = g_bytes_get_data(msg->body, &length);
+
+        msg->cb_data(GT_HTTP(self), data, length, NULL, msg->udata);
+    }
+}
+
+static gboolean
+transfer_finished_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(udata != NULL, G_SOURCE_REMOVE);
+
+    g_autoptr(ReplayCallbackData) msg = udata;
+    g_autoptr(GtHTTPReplay) self = g_weak_ref_get(msg->self);
+
+    if (!self) {TRACE("Unreffed while waiting"); return G_SOURCE_REMOVE;}
+
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+    guint inflight = GPOINTER_TO_UINT(g_hash_table_lookup(priv->inflight_table, msg->category));
+
+    g_hash_table_insert(priv->inflight_table, g_strdup(msg->category),
+        GUINT_TO_POINTER(inflight > 0 ? inflight - 1 : 0));
+
+    deliver_response(self, msg);
+
+    send_next_message(self);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+send_next_message(GtHTTPReplay* self)
+{
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+    ReplayCallbackData* next_msg = NULL; /* NOTE: Doesn't need free */
+    guint inflight = 0;
+    guint i = 0;
+
+    for (i = 0; i < g_queue_get_length(priv->message_queue); i++)
+    {
+        next_msg = g_queue_peek_nth(priv->message_queue, i);
+
+        /* NOTE: Cancelled messages don't need a slot, they will be
+         * answered straight away */
+        if (g_cancellable_is_cancelled(next_msg->cancel))
+            break;
+
+        inflight = GPOINTER_TO_UINT(g_hash_table_lookup(priv->inflight_table, next_msg->category));
+
+        if (inflight < priv->max_inflight_per_category)
+            break;
+    }
+
+    next_msg = g_queue_pop_nth(priv->message_queue, i);
+
+    if (!next_msg)
+        return;
+
+    if (g_cancellable_is_cancelled(next_msg->cancel))
+    {
+        g_autoptr(ReplayCallbackData) msg = next_msg;
+
+        deliver_response(self, msg);
+        send_next_message(self);
+
+        return;
+    }
+
+    inflight = GPOINTER_TO_UINT(g_hash_table_lookup(priv->inflight_table, next_msg->category));
+    g_hash_table_insert(priv->inflight_table, g_strdup(next_msg->category), GUINT_TO_POINTER(inflight + 1));
+
+    gt_http_stats_add_timing(priv->stats, next_msg->category, GT_HTTP_STATS_QUEUE_WAIT,
+        g_get_monotonic_time() - next_msg->queued_time);
+
+    load_fixture(self, next_msg);
+
+    g_timeout_add(transfer_time(self, next_msg), transfer_finished_cb, next_msg); /* NOTE: Assumes ownership of next_msg */
+}
+
+static void
+get_with_category(GtHTTP* http, const gchar* uri, const gchar* category, gchar** headers,
+    GCancellable* cancel, GCallback cb, gpointer udata, gint flags)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP_REPLAY(http));
+    RETURN_IF_FAIL(!utils_str_empty(uri));
+    RETURN_IF_FAIL(!utils_str_empty(category));
+    RETURN_IF_FAIL(flags != 0);
+
+    GtHTTPReplay* self = GT_HTTP_REPLAY(http);
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+
+    g_queue_push_tail(priv->message_queue,
+        replay_callback_data_new(self, uri, category, cancel, cb, udata, flags));
+
+    send_next_message(self);
+}
+
+static void
+get(GtHTTP* http, const gchar* uri, gchar** headers,
+    GCancellable* cancel, GCallback cb, gpointer udata, gint flags)
+{
+    get_with_category(http, uri, NO_CATEGORY, headers, cancel, cb, udata, flags);
+}
+
+static GVariant*
+get_stats(GtHTTP* http)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_HTTP_REPLAY(http), NULL);
+
+    GtHTTPReplay* self = GT_HTTP_REPLAY(http);
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+
+    return gt_http_stats_snapshot(priv->stats);
+}
+
+static void
+dispose(GObject* obj)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP_REPLAY(obj));
+
+    GtHTTPReplay* self = GT_HTTP_REPLAY(obj);
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+
+    MESSAGE("Replayed '%" G_GUINT64_FORMAT "' requests with '%" G_GUINT64_FORMAT "' bytes",
+        priv->requests, priv->bytes);
+
+    g_clear_pointer(&priv->inflight_table, g_hash_table_unref);
+
+    G_OBJECT_CLASS(gt_http_replay_parent_class)->dispose(obj);
+}
+
+static void
+finalize(GObject* obj)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP_REPLAY(obj));
+
+    GtHTTPReplay* self = GT_HTTP_REPLAY(obj);
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+
+    g_queue_free_full(priv->message_queue, (GDestroyNotify) replay_callback_data_free);
+    g_free(priv->cache_directory);
+    g_free(priv->fixture_directory);
+    gt_http_stats_free(priv->stats);
+
+    G_OBJECT_CLASS(gt_http_replay_parent_class)->finalize(obj);
+}
+
+static void
+get_property(GObject* obj,
+    guint prop, GValue* val, GParamSpec* pspec)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP_REPLAY(obj));
+    RETURN_IF_FAIL(G_IS_VALUE(val));
+    RETURN_IF_FAIL(G_IS_PARAM_SPEC(pspec));
+
+    GtHTTPReplay* self = GT_HTTP_REPLAY(obj);
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+
+    switch (prop)
+    {
+        case PROP_MAX_INFLIGHT_PER_CATEGORY:
+            g_value_set_uint(val, priv->max_inflight_per_category);
+            break;
+        case PROP_CACHE_DIRECTORY:
+            g_value_set_string(val, priv->cache_directory);
+            break;
+        case PROP_FIXTURE_DIRECTORY:
+            g_value_set_string(val, priv->fixture_directory);
+            break;
+        case PROP_LATENCY:
+            g_value_set_uint(val, priv->latency);
+            break;
+        case PROP_BANDWIDTH:
+            g_value_set_uint(val, priv->bandwidth);
+            break;
+        case PROP_REQUESTS:
+            g_value_set_uint64(val, priv->requests);
+            break;
+        case PROP_BYTES:
+            g_value_set_uint64(val, priv->bytes);
+            break;
+        case PROP_PLAYBACK_ACTIVE:
+            g_value_set_boolean(val, priv->playback_active);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
+    }
+}
+
+static void
+set_property(GObject* obj,
+    guint prop, const GValue* val, GParamSpec* pspec)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP_REPLAY(obj));
+    RETURN_IF_FAIL(G_IS_VALUE(val));
+    RETURN_IF_FAIL(G_IS_PARAM_SPEC(pspec));
+
+    GtHTTPReplay* self = GT_HTTP_REPLAY(obj);
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+
+    switch (prop)
+    {
+        case PROP_MAX_INFLIGHT_PER_CATEGORY:
+            priv->max_inflight_per_category = g_value_get_uint(val);
+            break;
+        case PROP_CACHE_DIRECTORY:
+            g_free(priv->cache_directory);
+            priv->cache_directory = g_value_dup_string(val);
+            break;
+        case PROP_FIXTURE_DIRECTORY:
+            g_free(priv->fixture_directory);
+            priv->fixture_directory = g_value_dup_string(val);
+            break;
+        case PROP_LATENCY:
+            priv->latency = g_value_get_uint(val);
+            break;
+        case PROP_BANDWIDTH:
+            priv->bandwidth = g_value_get_uint(val);
+            break;
+        case PROP_PLAYBACK_ACTIVE:
+            priv->playback_active = g_value_get_boolean(val);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
+    }
+}
+
+static void
+gt_http_iface_init(GtHTTPInterface* iface)
+{
+    iface->get = get;
+    iface->get_with_category = get_with_category;
+    iface->get_stats = get_stats;
+}
+
+static void
+gt_http_replay_class_init(GtHTTPReplayClass* klass)
+{
+    GObjectClass* obj_class = G_OBJECT_CLASS(klass);
+
+    obj_class->get_property = get_property;
+    obj_class->set_property = set_property;
+    obj_class->finalize = finalize;
+    obj_class->dispose = dispose;
+
+    props[PROP_FIXTURE_DIRECTORY] = g_param_spec_string("fixture-directory",
+        "Fixture directory", "Directory where recorded responses are read from",
+        NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    props[PROP_LATENCY] = g_param_spec_uint("latency",
+        "Latency", "Simulated latency in milliseconds added to each response",
+        0, G_MAXUINT, 0, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    props[PROP_BANDWIDTH] = g_param_spec_uint("bandwidth",
+        "Bandwidth", "Simulated bandwidth in bytes per second for each response, 0 for unlimited",
+        0, G_MAXUINT, 0, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    props[PROP_REQUESTS] = g_param_spec_uint64("requests",
+        "Requests", "Number of requests served",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE);
+
+    props[PROP_BYTES] = g_param_spec_uint64("bytes",
+        "Bytes", "Number of body bytes served",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE);
+
+    g_object_class_override_property(obj_class, PROP_MAX_INFLIGHT_PER_CATEGORY, "max-inflight-per-category");
+    g_object_class_override_property(obj_class, PROP_CACHE_DIRECTORY, "cache-directory");
+    g_object_class_override_property(obj_class, PROP_PLAYBACK_ACTIVE, "playback-active");
+
+    g_object_class_install_property(obj_class, PROP_FIXTURE_DIRECTORY, props[PROP_FIXTURE_DIRECTORY]);
+    g_object_class_install_property(obj_class, PROP_LATENCY, props[PROP_LATENCY]);
+    g_object_class_install_property(obj_class, PROP_BANDWIDTH, props[PROP_BANDWIDTH]);
+    g_object_class_install_property(obj_class, PROP_REQUESTS, props[PROP_REQUESTS]);
+    g_object_class_install_property(obj_class, PROP_BYTES, props[PROP_BYTES]);
+}
+
+static void
+gt_http_replay_init(GtHTTPReplay* self)
+{
+    GtHTTPReplayPrivate* priv = gt_http_replay_get_instance_private(self);
+
+    priv->message_queue = g_queue_new();
+    priv->inflight_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    priv->stats = gt_http_stats_new();
+}
+
+GtHTTPReplay*
+gt_http_replay_new(const gchar* fixture_directory)
+{
+    RETURN_VAL_IF_FAIL(!utils_str_empty(fixture_directory), NULL);
+
+    return g_object_new(GT_TYPE_HTTP_REPLAY,
+        "fixture-directory", fixture_directory,
+        NULL);
+}
@@ -0,0 +1,48 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GT_HTTP_REPLAY_H
+#define GT_HTTP_REPLAY_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define GT_TYPE_HTTP_REPLAY gt_http_replay_get_type()
+
+G_DECLARE_FINAL_TYPE(GtHTTPReplay, gt_http_replay, GT, HTTP_REPLAY, GObject);
+
+struct _GtHTTPReplay
+{
+    GObject parent_instance;
+};
+
+/* NOTE: Fixtures are stored as two files per uri, both named after
+ * the SHA1 of the uri. '<sha1>' holds the response body and
+ * '<sha1>.meta' is a key file with the uri, status code and response
+ * headers. GtHTTPSoup writes these when 'record-directory' is set. */
+#define GT_HTTP_FIXTURE_META_SUFFIX ".meta"
+#define GT_HTTP_FIXTURE_GROUP_RESPONSE "Response"
+#define GT_HTTP_FIXTURE_GROUP_HEADERS "Headers"
+
+GtHTTPReplay* gt_http_replay_new(const gchar* fixture_directory);
+gchar*        gt_http_replay_fixture_name(const gchar* uri);
+
+G_END_DECLS
+
+#endif
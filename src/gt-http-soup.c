@@ -20,6 +20,8 @@
 #include "gt-http.h"
 #include "gt-cache.h"
 #include "gt-cache-file.h"
+#include "gt-http-replay.h"
+#include "gt-http-stats.h"
 #include "utils.h"
 #include "config.h"
 #include <libsoup/soup.h>
@@ -28,6 +30,11 @@
 #include "gnome-twitch/gt-log.h"
 
 #define BUFFER_SIZE 2*1000*1024 /* NOTE: 2 MB */
+#define RETRY_BASE_DELAY 500 /* NOTE: Milliseconds, doubled for each retry */
+#define RETRY_MAX_DELAY 8000
+#define HEDGE_MIN_SAMPLES 20
+#define HEDGE_MIN_DELAY 50
+#define PREWARM_INTERVAL 30*G_USEC_PER_SEC /* NOTE: Roughly how long servers keep idle connections */
 
 typedef struct
 {
@@ -35,15 +42,33 @@ typedef struct
     GQueue* message_queue;
     GHashTable* inflight_table;
     GtCache* cache;
+    GtHTTPStats* stats;
 
     guint max_inflight_per_category;
     gchar* cache_directory;
+    gchar* record_directory;
+    guint timeout;
+    guint max_retries;
+    GHashTable* policy_table;
+    GHashTable* prewarm_table;
+    GHashTable* priority_table;
+    gboolean playback_active;
+    guint playback_max_inflight;
 } GtHTTPSoupPrivate;
 
 typedef struct
 {
+    guint timeout;
+    guint max_retries;
+    gboolean hedge;
+} CategoryPolicy;
+
+typedef struct
+{
+    gint ref_count;
     GWeakRef* self;
-    SoupMessage* soup_message;
+    SoupMessage* request; /* NOTE: Template that every attempt is copied from, never sent */
+    SoupMessage* soup_message; /* NOTE: The attempt that was used for the response */
     gchar* uri;
     gchar* category;
     GCancellable* cancel;
@@ -54,8 +79,29 @@ typedef struct
     gint flags;
     gssize content_length;
     gssize bytes_read;
+    gint64 queued_time;
+    gint64 sent_time;
+    guint retries;
+    guint generation;
+    guint attempts_inflight;
+    gboolean holds_slot; /* NOTE: The winning attempt's slot while its body is read */
+    gboolean finished;
+    gboolean throttled;
+    gboolean timed_out;
+    guint timeout_source_id;
+    guint hedge_source_id;
+    GCancellable* body_cancel;
+    gulong body_cancel_id;
 } SoupCallbackData;
 
+typedef struct
+{
+    SoupCallbackData* msg;
+    SoupMessage* soup_message;
+    guint generation;
+    gint64 sent_time;
+} SoupAttemptData;
+
 static void gt_http_iface_init(GtHTTPInterface* iface);
 
 G_DEFINE_TYPE_WITH_CODE(GtHTTPSoup, gt_http_soup, G_TYPE_OBJECT,
@@ -67,6 +113,12 @@ enum
     PROP_0,
     PROP_MAX_INFLIGHT_PER_CATEGORY,
     PROP_CACHE_DIRECTORY,
+    PROP_RECORD_DIRECTORY,
+    PROP_TIMEOUT,
+    PROP_MAX_RETRIES,
+    PROP_PLAYBACK_ACTIVE,
+    PROP_PLAYBACK_MAX_INFLIGHT,
+    PROP_CACHE,
     NUM_PROPS,
 };
 
@@ -77,6 +129,7 @@ static GParamSpec* props[NUM_PROPS];
 #define CALL_ERROR_CB(msg, err)                                         \
     G_STMT_START                                                        \
     {                                                                   \
+        record_finished(self, msg, err);                                \
         if (msg->flags & GT_HTTP_FLAG_RETURN_STREAM)                    \
             msg->cb_stream(GT_HTTP(self), NULL, g_steal_pointer(&err), msg->udata); \
         else if (msg->flags & GT_HTTP_FLAG_RETURN_DATA)                 \
@@ -91,8 +144,9 @@ soup_callback_data_new(GtHTTPSoup* self, SoupMessage* soup_message, const gchar*
 {
     SoupCallbackData* data = g_slice_new0(SoupCallbackData);
 
+    data->ref_count = 1;
     data->self = utils_weak_ref_new(self);
-    data->soup_message = g_object_ref(soup_message);
+    data->request = g_object_ref(soup_message);
     data->uri = soup_uri_to_string(soup_message_get_uri(soup_message), FALSE);
     data->category = g_strdup(category);
     data->cancel = g_object_ref(cancel);
@@ -108,23 +162,69 @@ soup_callback_data_new(GtHTTPSoup* self, SoupMessage* soup_message, const gchar*
     return data;
 }
 
+static SoupCallbackData*
+soup_callback_data_ref(SoupCallbackData* data)
+{
+    RETURN_VAL_IF_FAIL(data != NULL, NULL);
+
+    g_atomic_int_inc(&data->ref_count);
+
+    return data;
+}
+
 static void
-soup_callback_data_free(SoupCallbackData* data)
+soup_callback_data_unref(SoupCallbackData* data)
 {
     if (!data) return;
 
+    if (!g_atomic_int_dec_and_test(&data->ref_count))
+        return;
+
     g_free(data->uri);
     g_free(data->category);
     utils_weak_ref_free(data->self);
-    g_object_unref(data->soup_message);
+    g_object_unref(data->request);
+    g_clear_object(&data->soup_message);
+    if (data->body_cancel_id) g_cancellable_disconnect(data->cancel, data->body_cancel_id);
+    g_clear_object(&data->body_cancel);
     if (data->cancel) g_object_unref(data->cancel);
 
     g_slice_free(SoupCallbackData, data);
 }
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC(SoupCallbackData, soup_callback_data_free);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(SoupCallbackData, soup_callback_data_unref);
+
+static void
+soup_attempt_data_free(SoupAttemptData* data)
+{
+    if (!data) return;
+
+    soup_callback_data_unref(data->msg);
+    g_object_unref(data->soup_message);
+
+    g_slice_free(SoupAttemptData, data);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(SoupAttemptData, soup_attempt_data_free);
 
-static inline void send_next_message(GtHTTPSoup* self);
+static inline gboolean send_next_message(GtHTTPSoup* self);
+static void end_request(GtHTTPSoup* self, SoupCallbackData* msg);
+
+static void
+record_finished(GtHTTPSoup* self, SoupCallbackData* msg, const GError* err)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_CANCELLED, 1);
+    else if (err)
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_ERRORS, 1);
+    else
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_BYTES, MAX(msg->bytes_read, 0));
+
+    gt_http_stats_add_timing(priv->stats, msg->category, GT_HTTP_STATS_TOTAL_TIME,
+        g_get_monotonic_time() - msg->queued_time);
+}
 
 static inline void
 decrement_inflight_for_category(GtHTTPSoup* self, const gchar* category)
@@ -184,13 +284,59 @@ static GDateTime*
 parse_http_time(const gchar* time)
 {
     GDateTime* ret = NULL;
-    g_autoptr(SoupDate) soup_date = soup_date_new_from_string(time);
+    g_autoptr(SoupDate) soup_date = NULL;
+
+    if (utils_str_empty(time))
+        return NULL;
+
+    if ((soup_date = soup_date_new_from_string(time)) == NULL)
+        return NULL;
 
     ret = g_date_time_new_from_unix_utc(soup_date_to_time_t(soup_date));
 
     return ret;
 }
 
+/* NOTE: Writes the response in the format GtHTTPReplay expects. This
+ * is a debugging aid so the files are written synchronously */
+static void
+record_response(GtHTTPSoup* self, SoupCallbackData* msg, gconstpointer data, gsize length)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+    g_autofree gchar* name = gt_http_replay_fixture_name(msg->uri);
+    g_autofree gchar* meta_name = g_strconcat(name, GT_HTTP_FIXTURE_META_SUFFIX, NULL);
+    g_autofree gchar* body_filename = g_build_filename(priv->record_directory, name, NULL);
+    g_autofree gchar* meta_filename = g_build_filename(priv->record_directory, meta_name, NULL);
+    g_autoptr(GKeyFile) meta = g_key_file_new();
+    g_autoptr(GError) err = NULL;
+    SoupMessageHeadersIter iter;
+    const gchar* header_name;
+    const gchar* header_value;
+
+    g_mkdir_with_parents(priv->record_directory, 0755);
+
+    g_key_file_set_string(meta, GT_HTTP_FIXTURE_GROUP_RESPONSE, "uri", msg->uri);
+    g_key_file_set_integer(meta, GT_HTTP_FIXTURE_GROUP_RESPONSE, "status", msg->soup_message->status_code);
+
+    soup_message_headers_iter_init(&iter, msg->soup_message->response_headers);
+    while (soup_message_headers_iter_next(&iter, &header_name, &header_value))
+        g_key_file_set_string(meta, GT_HTTP_FIXTURE_GROUP_HEADERS, header_name, header_value);
+
+    if (data && !g_file_set_contents(body_filename, data, length, &err))
+    {
+        WARNING("Unable to record response body for uri '%s' because: %s", msg->uri, err->message);
+        return;
+    }
+
+    if (!g_key_file_save_to_file(meta, meta_filename, &err))
+    {
+        WARNING("Unable to record response meta for uri '%s' because: %s", msg->uri, err->message);
+        return;
+    }
+
+    DEBUG("Recorded response for uri '%s' to '%s'", msg->uri, body_filename);
+}
+
 static void
 download_stream_fill_cb(GObject* source,
     GAsyncResult* res, gpointer udata)
@@ -208,27 +354,65 @@ download_stream_fill_cb(GObject* source,
 
     GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
     GBufferedInputStream* bistream = G_BUFFERED_INPUT_STREAM(source);
-
-    msg->bytes_read += g_buffered_input_stream_fill_finish(bistream, res, &err);
+    gssize bytes_read = g_buffered_input_stream_fill_finish(bistream, res, &err);
 
     if (err)
     {
-        if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        if (msg->timed_out)
+        {
+            g_clear_error(&err);
+            g_set_error(&err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+                "Timed out reading response from uri '%s'", msg->uri);
+
+            WARNING("%s", err->message);
+        }
+        else if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
         {
             g_prefix_error(&err, "Unable to cache request to '%s' because: ", msg->uri);
 
             WARNING("%s", err->message);
         }
 
+        end_request(self, msg);
+
         CALL_ERROR_CB(msg, err);
 
+        send_next_message(self);
+
         return;
     }
 
-    if (msg->bytes_read < msg->content_length)
+    msg->bytes_read += bytes_read;
+
+    /* NOTE: Chunked responses don't tell us their length up front so
+     * just keep filling until we hit the end of the stream. A full
+     * buffer could just as well be the whole response, so make room
+     * for one more byte to tell the two apart. */
+    if (msg->content_length < 0 && bytes_read > 0
+        && g_buffered_input_stream_get_available(bistream) >= BUFFER_SIZE)
+    {
+        if (g_buffered_input_stream_get_available(bistream) > BUFFER_SIZE)
+        {
+            g_set_error(&err, GT_HTTP_ERROR, GT_HTTP_ERROR_UNKNOWN,
+                "Response from '%s' greater than buffer size, not downloading response", msg->uri);
+            WARNING("%s", err->message);
+
+            end_request(self, msg);
+
+            CALL_ERROR_CB(msg, err);
+
+            send_next_message(self);
+
+            return;
+        }
+
+        g_buffered_input_stream_set_buffer_size(bistream, BUFFER_SIZE + 1);
+    }
+
+    if ((msg->content_length < 0 && bytes_read > 0) || msg->bytes_read < msg->content_length)
     {
         g_buffered_input_stream_fill_async(bistream, msg->content_length,
-            G_PRIORITY_DEFAULT, msg->cancel, download_stream_fill_cb, msg);
+            G_PRIORITY_DEFAULT, msg->body_cancel, download_stream_fill_cb, msg);
         g_steal_pointer(&msg);
     }
     else
@@ -236,6 +420,13 @@ download_stream_fill_cb(GObject* source,
         gsize length;
         gconstpointer data = g_buffered_input_stream_peek_buffer(bistream, &length);
 
+        end_request(self, msg);
+
+        if (priv->record_directory)
+            record_response(self, msg, data, length);
+
+        record_finished(self, msg, NULL);
+
         if (msg->flags & GT_HTTP_FLAG_CACHE_RESPONSE)
         {
             const gchar* last_modified = soup_message_headers_get_one(msg->soup_message->response_headers, "Last-Modified");
@@ -254,7 +445,45 @@ download_stream_fill_cb(GObject* source,
             msg->cb_data(GT_HTTP(self), data, length, NULL, msg->udata);
         else
             RETURN_IF_REACHED();
+
+        send_next_message(self);
+    }
+}
+
+static void
+cancel_body_cb(GCancellable* cancel, gpointer udata)
+{
+    g_cancellable_cancel(udata);
+}
+
+/* NOTE: Returns FALSE without calling back if the cached copy can't
+ * be read */
+static gboolean
+respond_from_cache(GtHTTPSoup* self, SoupCallbackData* msg, GError** error)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    g_autoptr(GError) err = NULL;
+    g_autoptr(GInputStream) fistream = gt_cache_get_data_stream(priv->cache, msg->uri, &err);
+
+    if (err)
+    {
+        g_propagate_prefixed_error(error, g_steal_pointer(&err),
+            "Couldn't get data stream for cached file because: ");
+
+        return FALSE;
     }
+
+    record_finished(self, msg, NULL);
+
+    /* NOTE: Like network streams the callback only borrows it */
+    if (msg->flags & GT_HTTP_FLAG_RETURN_STREAM)
+        msg->cb_stream(GT_HTTP(self), fistream, NULL, msg->udata);
+    /* TODO: Implement returning data here */
+    else
+        RETURN_VAL_IF_REACHED(TRUE);
+
+    return TRUE;
 }
 
 static void
@@ -271,12 +500,16 @@ download_response(GtHTTPSoup* self, GInputStream* istream, SoupCallbackData* msg
     if (!utils_str_empty(last_modified))
         last_updated = parse_http_time(last_modified);
 
-    if (!last_updated || gt_cache_is_data_stale(priv->cache, msg->uri, last_updated, etag))
+    /* NOTE: When recording we always want the body from the network */
+    if (priv->record_directory || !last_updated
+        || gt_cache_is_data_stale(priv->cache, msg->uri, last_updated, etag))
     {
         g_autoptr(GBufferedInputStream) bistream = G_BUFFERED_INPUT_STREAM(g_buffered_input_stream_new_sized(istream, BUFFER_SIZE));
 
         DEBUG("Cache miss for '%s'", msg->uri);
 
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_CACHE_MISSES, 1);
+
         if (msg->content_length > BUFFER_SIZE)
         {
             g_autoptr(GError) err = NULL;
@@ -285,37 +518,42 @@ download_response(GtHTTPSoup* self, GInputStream* istream, SoupCallbackData* msg
                 "Content length '%ld' greater than buffer size, not downloading response", msg->content_length);
             WARNING("%s", err->message);
 
+            end_request(self, msg);
+
             CALL_ERROR_CB(msg, err);
 
+            soup_callback_data_unref(msg);
+
             return;
         }
 
+        /* NOTE: The caller's cancellable isn't ours to cancel when the
+         * deadline runs out while reading */
+        msg->body_cancel = g_cancellable_new();
+        msg->body_cancel_id = g_cancellable_connect(msg->cancel,
+            G_CALLBACK(cancel_body_cb), msg->body_cancel, NULL);
+
         g_buffered_input_stream_fill_async(bistream, msg->content_length,
-            G_PRIORITY_DEFAULT, msg->cancel, download_stream_fill_cb, msg);
+            G_PRIORITY_DEFAULT, msg->body_cancel, download_stream_fill_cb, msg);
     }
     else
     {
         g_autoptr(GError) err = NULL;
-        g_autoptr(GInputStream) fistream = gt_cache_get_data_stream(priv->cache, msg->uri, &err);
 
         DEBUG("Cache hit for '%s'", msg->uri);
 
-        if (err)
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_CACHE_HITS, 1);
+
+        end_request(self, msg);
+
+        if (!respond_from_cache(self, msg, &err))
         {
-            g_prefix_error(&err, "Couldn't get data stream for cached file because: ");
             WARNING("%s", err->message);
 
             CALL_ERROR_CB(msg, err);
         }
-        else
-        {
-            if (msg->flags & GT_HTTP_FLAG_RETURN_STREAM)
-                msg->cb_stream(GT_HTTP(self), g_steal_pointer(&fistream), NULL, msg->udata);
-            /* TODO: Implement returning data here */
-            else
-                RETURN_IF_REACHED();
-            soup_callback_data_free(msg);
-        }
+
+        soup_callback_data_unref(msg);
     }
 }
 
@@ -334,7 +572,325 @@ msg_cancelled_cb(GCancellable* cancel, gpointer udata)
 
     GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
 
-    g_queue_remove(priv->message_queue, data);
+    if (g_queue_remove(priv->message_queue, data))
+    {
+        gt_http_stats_add(priv->stats, data->category, GT_HTTP_STATS_CANCELLED, 1);
+        soup_callback_data_unref(data);
+    }
+}
+
+static void
+get_policy(GtHTTPSoup* self, const gchar* category, CategoryPolicy* policy)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+    CategoryPolicy* lookup = g_hash_table_lookup(priv->policy_table, category);
+
+    if (lookup)
+        *policy = *lookup;
+    else
+    {
+        policy->timeout = priv->timeout;
+        policy->max_retries = priv->max_retries;
+        policy->hedge = FALSE;
+    }
+}
+
+static void
+release_slot(GtHTTPSoup* self, SoupCallbackData* msg)
+{
+    if (!msg->holds_slot)
+        return;
+
+    decrement_inflight_for_category(self, msg->category);
+    msg->holds_slot = FALSE;
+}
+
+static void
+clear_timers(SoupCallbackData* msg)
+{
+    if (msg->timeout_source_id > 0)
+    {
+        g_source_remove(msg->timeout_source_id);
+        msg->timeout_source_id = 0;
+    }
+
+    if (msg->hedge_source_id > 0)
+    {
+        g_source_remove(msg->hedge_source_id);
+        msg->hedge_source_id = 0;
+    }
+}
+
+/* NOTE: The deadline and the slot last until the body has been read,
+ * or until the response is handed to a caller that reads it itself */
+static void
+end_request(GtHTTPSoup* self, SoupCallbackData* msg)
+{
+    clear_timers(msg);
+    release_slot(self, msg);
+}
+
+/* NOTE: Takes ownership of err */
+static void
+finish_with_error(GtHTTPSoup* self, SoupCallbackData* msg, GError* err)
+{
+    msg->finished = TRUE;
+
+    end_request(self, msg);
+
+    CALL_ERROR_CB(msg, err);
+}
+
+static void
+copy_header_cb(const gchar* name, const gchar* value, gpointer udata)
+{
+    soup_message_headers_append(udata, name, value);
+}
+
+static void soup_message_cb(GObject* source, GAsyncResult* res, gpointer udata);
+
+static void
+start_attempt(GtHTTPSoup* self, SoupCallbackData* msg)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+    SoupAttemptData* attempt = g_slice_new0(SoupAttemptData);
+
+    attempt->msg = soup_callback_data_ref(msg);
+    attempt->generation = msg->generation;
+    attempt->sent_time = g_get_monotonic_time();
+    attempt->soup_message = soup_message_new_from_uri(msg->request->method,
+        soup_message_get_uri(msg->request));
+    soup_message_headers_foreach(msg->request->request_headers,
+        copy_header_cb, attempt->soup_message->request_headers);
+
+    /* NOTE: Every attempt on the wire takes a slot, hedges included.
+     * Attempts can't be cancelled (see below), one that loses or times
+     * out keeps its slot until SoupSession is done with it. */
+    increment_inflight_for_category(self, msg->category);
+
+    msg->attempts_inflight++;
+
+    /* NOTE: Cancelling a async request will cause SoupSession to
+     * segfault so we don't allow cancelling here. Instead we will
+     * handle it manually
+     *
+     * See: https://bugzilla.gnome.org/show_bug.cgi?id=771912 */
+
+    soup_session_send_async(priv->soup, attempt->soup_message,
+        /* msg->cancel */NULL, soup_message_cb, attempt); /* NOTE: Assumes ownership of attempt */
+}
+
+static gboolean
+retry_cb(gpointer udata)
+{
+    SoupCallbackData* msg = udata;
+    g_autoptr(GtHTTPSoup) self = g_weak_ref_get(msg->self);
+
+    if (!self) {TRACE("Unreffed while waiting"); return G_SOURCE_REMOVE;}
+
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    if (g_cancellable_is_cancelled(msg->cancel))
+    {
+        g_autoptr(GError) err = NULL;
+
+        g_set_error(&err, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Cancelled");
+
+        finish_with_error(self, msg, g_steal_pointer(&err));
+
+        return G_SOURCE_REMOVE;
+    }
+
+    msg->cancel_cb_id = g_cancellable_connect(msg->cancel, G_CALLBACK(msg_cancelled_cb), msg, NULL);
+
+    /* NOTE: It has already waited its turn once */
+    g_queue_push_head(priv->message_queue, soup_callback_data_ref(msg));
+
+    send_next_message(self);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* NOTE: All our requests are GETs so they are safe to retry */
+static gboolean
+try_retry(GtHTTPSoup* self, SoupCallbackData* msg, const gchar* reason)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+    CategoryPolicy policy;
+    guint delay;
+
+    get_policy(self, msg->category, &policy);
+
+    if (msg->retries >= policy.max_retries || g_cancellable_is_cancelled(msg->cancel))
+        return FALSE;
+
+    msg->retries++;
+
+    /* NOTE: Any attempts still running belong to an older generation
+     * and will be ignored when they come back */
+    msg->generation++;
+    msg->attempts_inflight = 0;
+
+    end_request(self, msg);
+
+    delay = MIN(RETRY_BASE_DELAY << (msg->retries - 1), RETRY_MAX_DELAY);
+    delay = delay/2 + g_random_int_range(0, delay/2 + 1);
+
+    gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_RETRIES, 1);
+
+    INFO("Retrying request to '%s' in '%u' ms because: %s", msg->uri, delay, reason);
+
+    g_timeout_add_full(G_PRIORITY_DEFAULT, delay, retry_cb,
+        soup_callback_data_ref(msg), (GDestroyNotify) soup_callback_data_unref);
+
+    return TRUE;
+}
+
+static gboolean
+timeout_cb(gpointer udata)
+{
+    SoupCallbackData* msg = udata;
+    g_autoptr(GtHTTPSoup) self = g_weak_ref_get(msg->self);
+    g_autoptr(GError) err = NULL;
+
+    msg->timeout_source_id = 0;
+
+    if (!self) {TRACE("Unreffed while waiting"); return G_SOURCE_REMOVE;}
+
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    /* NOTE: Still reading the body, download_stream_fill_cb reports it */
+    if (msg->finished)
+    {
+        if (msg->body_cancel)
+        {
+            gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_TIMEOUTS, 1);
+
+            msg->timed_out = TRUE;
+            g_cancellable_cancel(msg->body_cancel);
+        }
+
+        return G_SOURCE_REMOVE;
+    }
+
+    if (g_cancellable_is_cancelled(msg->cancel))
+    {
+        g_set_error(&err, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Cancelled");
+
+        finish_with_error(self, msg, g_steal_pointer(&err));
+    }
+    else
+    {
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_TIMEOUTS, 1);
+
+        if (!try_retry(self, msg, "Timed out waiting for response"))
+        {
+            g_set_error(&err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+                "Timed out waiting for response from uri '%s'", msg->uri);
+
+            WARNING("%s", err->message);
+
+            finish_with_error(self, msg, g_steal_pointer(&err));
+        }
+    }
+
+    send_next_message(self);
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+hedge_cb(gpointer udata)
+{
+    SoupCallbackData* msg = udata;
+    g_autoptr(GtHTTPSoup) self = g_weak_ref_get(msg->self);
+
+    msg->hedge_source_id = 0;
+
+    if (!self) {TRACE("Unreffed while waiting"); return G_SOURCE_REMOVE;}
+
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    if (msg->finished || msg->attempts_inflight != 1 || g_cancellable_is_cancelled(msg->cancel))
+        return G_SOURCE_REMOVE;
+
+    DEBUG("Hedging slow request to '%s'", msg->uri);
+
+    gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_HEDGES, 1);
+
+    start_attempt(self, msg);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+send_message(GtHTTPSoup* self, SoupCallbackData* msg)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+    CategoryPolicy policy;
+
+    get_policy(self, msg->category, &policy);
+
+    msg->sent_time = g_get_monotonic_time();
+    gt_http_stats_add_timing(priv->stats, msg->category, GT_HTTP_STATS_QUEUE_WAIT,
+        msg->sent_time - msg->queued_time);
+
+    /* NOTE: The timeout covers reading the body too when we read it,
+     * a stream handed to the caller is theirs to time */
+    if (policy.timeout > 0)
+    {
+        msg->timeout_source_id = g_timeout_add_full(G_PRIORITY_DEFAULT, policy.timeout, timeout_cb,
+            soup_callback_data_ref(msg), (GDestroyNotify) soup_callback_data_unref);
+    }
+
+    /* NOTE: Send a second request if this one takes longer than most
+     * requests in the category do, whichever answers first wins */
+    if (policy.hedge)
+    {
+        gint64 p95 = gt_http_stats_get_percentile(priv->stats, msg->category,
+            GT_HTTP_STATS_TIME_TO_FIRST_BYTE, 0.95, HEDGE_MIN_SAMPLES);
+
+        if (p95 > 0 && (policy.timeout == 0 || p95 / 1000 < policy.timeout))
+        {
+            msg->hedge_source_id = g_timeout_add_full(G_PRIORITY_DEFAULT, MAX(p95 / 1000, HEDGE_MIN_DELAY), hedge_cb,
+                soup_callback_data_ref(msg), (GDestroyNotify) soup_callback_data_unref);
+        }
+    }
+
+    start_attempt(self, msg);
+}
+
+/* NOTE: For a 304 whose cached copy was evicted after the validators
+ * were sent. Puts the request back at the front of the queue without
+ * them, returns FALSE if it wasn't conditional to begin with. */
+static gboolean
+resend_unconditionally(GtHTTPSoup* self, SoupCallbackData* msg)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+    SoupMessageHeaders* headers = msg->request->request_headers;
+
+    if (!soup_message_headers_get_one(headers, "If-None-Match")
+        && !soup_message_headers_get_one(headers, "If-Modified-Since"))
+    {
+        return FALSE;
+    }
+
+    soup_message_headers_remove(headers, "If-None-Match");
+    soup_message_headers_remove(headers, "If-Modified-Since");
+
+    msg->generation++;
+    msg->attempts_inflight = 0;
+    msg->finished = FALSE;
+
+    end_request(self, msg);
+
+    DEBUG("Cached response for '%s' is gone, requesting it again", msg->uri);
+
+    msg->cancel_cb_id = g_cancellable_connect(msg->cancel, G_CALLBACK(msg_cancelled_cb), msg, NULL);
+
+    g_queue_push_head(priv->message_queue, soup_callback_data_ref(msg));
+
+    return TRUE;
 }
 
 static void
@@ -345,7 +901,8 @@ soup_message_cb(GObject* source,
     RETURN_IF_FAIL(G_IS_ASYNC_RESULT(res));
     RETURN_IF_FAIL(udata != NULL);
 
-    g_autoptr(SoupCallbackData) msg = udata;
+    g_autoptr(SoupAttemptData) attempt = udata;
+    SoupCallbackData* msg = attempt->msg;
     g_autoptr(GtHTTPSoup) self = g_weak_ref_get(msg->self);
 
     if (!self) { TRACE("Unreffed while waiting"); return; }
@@ -354,26 +911,76 @@ soup_message_cb(GObject* source,
     g_autoptr(GInputStream) istream = NULL;
     g_autoptr(GError) err = NULL;
 
-    decrement_inflight_for_category(self, msg->category);
-
     istream = soup_session_send_finish(priv->soup, res, &err);
 
+    /* NOTE: Another attempt already answered or this one timed out */
+    if (msg->finished || attempt->generation != msg->generation)
+    {
+        TRACE("Dropping response from abandoned attempt to '%s'", msg->uri);
+
+        decrement_inflight_for_category(self, msg->category);
+
+        goto send_next_message;
+    }
+
+    msg->attempts_inflight--;
+
+    /* NOTE: The request takes over this attempt's slot, it's kept
+     * until the body is read if this attempt wins */
+    msg->holds_slot = TRUE;
+
     /* NOTE: Manually handle cancelled request here */
     if (g_cancellable_is_cancelled(msg->cancel))
     {
+        g_clear_error(&err);
         g_set_error(&err, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Cancelled");
 
-        CALL_ERROR_CB(msg, err);
+        finish_with_error(self, msg, g_steal_pointer(&err));
 
         goto send_next_message;
     }
 
+    if (err || SOUP_STATUS_IS_SERVER_ERROR(attempt->soup_message->status_code))
+    {
+        g_autofree gchar* reason = err ? g_strdup(err->message) :
+            g_strdup_printf("Received response '%d'", attempt->soup_message->status_code);
+
+        /* NOTE: Wait for the hedged attempt before giving up */
+        if (msg->attempts_inflight > 0)
+        {
+            release_slot(self, msg);
+
+            goto send_next_message;
+        }
+
+        if (try_retry(self, msg, reason))
+            goto send_next_message;
+    }
+
+    msg->finished = TRUE;
+
+    /* NOTE: Only the attempt that's used counts, timed from when it
+     * was sent rather than the latest retry or hedge */
+    gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_REQUESTS, 1);
+    gt_http_stats_add_timing(priv->stats, msg->category, GT_HTTP_STATS_TIME_TO_FIRST_BYTE,
+        g_get_monotonic_time() - attempt->sent_time);
+
+    if (msg->hedge_source_id > 0)
+    {
+        g_source_remove(msg->hedge_source_id);
+        msg->hedge_source_id = 0;
+    }
+
+    g_set_object(&msg->soup_message, attempt->soup_message);
+
     if (err)
     {
+        end_request(self, msg);
+
         if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
         {
-            g_prefix_error(&err, "Unable to send message to '%s' with category '%s' because: %s",
-                msg->uri, msg->category, err->message);
+            g_prefix_error(&err, "Unable to send message to '%s' with category '%s' because: ",
+                msg->uri, msg->category);
 
             WARNING("%s", err->message);
         }
@@ -383,6 +990,34 @@ soup_message_cb(GObject* source,
         goto send_next_message;
     }
 
+    if (msg->soup_message->status_code == SOUP_STATUS_NOT_MODIFIED)
+    {
+        gt_http_stats_add(priv->stats, msg->category, GT_HTTP_STATS_NOT_MODIFIED, 1);
+
+        /* NOTE: Answer to the validators added in get_with_category,
+         * the body we have is still good */
+        if (msg->flags & GT_HTTP_FLAG_CACHE_RESPONSE && msg->flags & GT_HTTP_FLAG_RETURN_STREAM)
+        {
+            const gchar* expires = soup_message_headers_get_one(msg->soup_message->response_headers, "Expires");
+            g_autoptr(GDateTime) expiry = parse_http_time(expires);
+
+            DEBUG("Revalidated cached response for '%s'", msg->uri);
+
+            gt_cache_mark_data_fresh(priv->cache, msg->uri, expiry);
+
+            end_request(self, msg);
+
+            if (!respond_from_cache(self, msg, &err) && !resend_unconditionally(self, msg))
+            {
+                WARNING("%s", err->message);
+
+                CALL_ERROR_CB(msg, err);
+            }
+
+            goto send_next_message;
+        }
+    }
+
     if (!SOUP_STATUS_IS_SUCCESSFUL(msg->soup_message->status_code))
     {
         gint code = -1;
@@ -400,29 +1035,71 @@ soup_message_cb(GObject* source,
 
         WARNING("%s", err->message);
 
+        end_request(self, msg);
+
+        if (priv->record_directory)
+            record_response(self, msg, NULL, 0);
+
         CALL_ERROR_CB(msg, err);
 
         goto send_next_message;
     }
 
+    if (soup_message_headers_get_encoding(msg->soup_message->response_headers) == SOUP_ENCODING_CONTENT_LENGTH)
+        msg->content_length = soup_message_headers_get_content_length(msg->soup_message->response_headers);
+    else
+        msg->content_length = -1;
+
     if ((msg->flags & GT_HTTP_FLAG_CACHE_RESPONSE && can_cache_response(msg->soup_message))
-        || msg->flags & GT_HTTP_FLAG_RETURN_DATA)
+        || msg->flags & GT_HTTP_FLAG_RETURN_DATA || priv->record_directory)
     {
-        msg->content_length = soup_message_headers_get_content_length(msg->soup_message->response_headers);
-        download_response(self, istream, g_steal_pointer(&msg));
+        download_response(self, istream, soup_callback_data_ref(msg));
     }
     else if (msg->flags & GT_HTTP_FLAG_RETURN_STREAM)
+    {
+        /* NOTE: The caller reads the stream so this is the best guess
+         * we have of the bytes transferred */
+        msg->bytes_read = MAX(msg->content_length, 0);
+
+        end_request(self, msg);
+
+        record_finished(self, msg, NULL);
+
         msg->cb_stream(GT_HTTP(self), istream, NULL, msg->udata);
+    }
 
 send_next_message:
     send_next_message(self);
 }
 
-static inline void
+/* NOTE: While something is playing the player backend fetches HLS
+ * segments outside of us, so we hold back background categories to
+ * leave it headroom */
+static guint
+get_max_inflight(GtHTTPSoup* self, const gchar* category)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    if (!priv->playback_active)
+        return priv->max_inflight_per_category;
+
+    switch (GPOINTER_TO_INT(g_hash_table_lookup(priv->priority_table, category)))
+    {
+        case GT_HTTP_SOUP_PRIORITY_LOW:
+            return MIN(priv->playback_max_inflight, priv->max_inflight_per_category);
+        case GT_HTTP_SOUP_PRIORITY_IDLE:
+            return 0;
+        default:
+            return priv->max_inflight_per_category;
+    }
+}
+
+static inline gboolean
 send_next_message(GtHTTPSoup* self)
 {
     GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
     guint inflight = 0;
+    guint max_inflight = 0;
     guint i = 0;
     SoupCallbackData* next_msg = NULL; /* NOTE: Doesn't need free */
 
@@ -431,28 +1108,53 @@ send_next_message(GtHTTPSoup* self)
         next_msg = g_queue_peek_nth(priv->message_queue, i);
 
         inflight = GPOINTER_TO_UINT(g_hash_table_lookup(priv->inflight_table, next_msg->category));
+        max_inflight = get_max_inflight(self, next_msg->category);
 
-        if (inflight < priv->max_inflight_per_category)
+        if (inflight < max_inflight)
             break;
+
+        if (max_inflight < priv->max_inflight_per_category && !next_msg->throttled)
+        {
+            next_msg->throttled = TRUE;
+            gt_http_stats_add(priv->stats, next_msg->category, GT_HTTP_STATS_THROTTLED, 1);
+        }
     }
 
     next_msg = g_queue_pop_nth(priv->message_queue, i);
 
     if (next_msg)
     {
-        g_cancellable_disconnect(next_msg->cancel, next_msg->cancel_cb_id);
+        g_autoptr(SoupCallbackData) msg = next_msg; /* NOTE: Drop the queue's reference when done */
 
-        increment_inflight_for_category(self, next_msg->category);
+        g_cancellable_disconnect(msg->cancel, msg->cancel_cb_id);
+        msg->cancel_cb_id = 0;
 
-        /* NOTE: Cancelling a async request will cause SoupSession to
-         * segfault so we don't allow cancelling here. Instead we will
-         * handle it manually
-         *
-         * See: https://bugzilla.gnome.org/show_bug.cgi?id=771912 */
+        send_message(self, msg);
 
-        soup_session_send_async(priv->soup, next_msg->soup_message,
-            /* next_msg->cancel */NULL, soup_message_cb, next_msg); /* NOTE: Assumes ownership of next_msg */
+        return TRUE;
     }
+
+    return FALSE;
+}
+
+static void
+set_playback_active(GtHTTPSoup* self, gboolean playback_active)
+{
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    if (priv->playback_active == playback_active)
+        return;
+
+    priv->playback_active = playback_active;
+
+    INFO("Playback %s, %s background categories", playback_active ? "started" : "stopped",
+        playback_active ? "throttling" : "resuming");
+
+    /* NOTE: Fill up any slots that were held back */
+    if (!playback_active)
+        while (send_next_message(self));
+
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PLAYBACK_ACTIVE]);
 }
 
 static void
@@ -483,9 +1185,33 @@ get_with_category(GtHTTP* http, const gchar* uri, const gchar* category, gchar**
         soup_message_headers_append(soup_msg->request_headers, key, val);
     }
 
+    /* NOTE: Make the request conditional if we have a copy, an
+     * unchanged resource then costs a 304 instead of the body. Only
+     * streams can be answered from the cache, see respond_from_cache */
+    if (flags & GT_HTTP_FLAG_CACHE_RESPONSE && flags & GT_HTTP_FLAG_RETURN_STREAM && !priv->record_directory)
+    {
+        g_autoptr(GDateTime) last_updated = NULL;
+        g_autofree gchar* etag = NULL;
+
+        if (gt_cache_get_validators(priv->cache, uri, &last_updated, &etag))
+        {
+            if (!utils_str_empty(etag))
+                soup_message_headers_replace(soup_msg->request_headers, "If-None-Match", etag);
+
+            if (last_updated)
+            {
+                g_autoptr(SoupDate) soup_date = soup_date_new_from_time_t(g_date_time_to_unix(last_updated));
+                g_autofree gchar* date = soup_date_to_string(soup_date, SOUP_DATE_HTTP);
+
+                soup_message_headers_replace(soup_msg->request_headers, "If-Modified-Since", date);
+            }
+        }
+    }
+
     data = soup_callback_data_new(self, soup_msg,
         category, cancel, cb, udata, flags);
 
+    data->queued_time = g_get_monotonic_time();
     data->cancel_cb_id = g_cancellable_connect(cancel, G_CALLBACK(msg_cancelled_cb), data, NULL);
 
     g_queue_push_tail(priv->message_queue, g_steal_pointer(&data));
@@ -500,6 +1226,98 @@ get(GtHTTP* http, const gchar* uri, gchar** headers,
     get_with_category(http, uri, NO_CATEGORY, headers, cancel, cb, udata, flags);
 }
 
+static GVariant*
+get_stats(GtHTTP* http)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_HTTP_SOUP(http), NULL);
+
+    GtHTTPSoup* self = GT_HTTP_SOUP(http);
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    g_autoptr(GVariant) snapshot = g_variant_ref_sink(gt_http_stats_snapshot(priv->stats));
+    GVariantBuilder builder;
+    GVariantBuilder governor_builder;
+    GVariantBuilder throttled_builder;
+    GHashTableIter iter;
+    gpointer key;
+    gpointer value;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sa{sv}}"));
+    g_variant_builder_init(&governor_builder, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_init(&throttled_builder, G_VARIANT_TYPE_STRING_ARRAY);
+
+    for (gsize i = 0; i < g_variant_n_children(snapshot); i++)
+    {
+        g_autoptr(GVariant) child = g_variant_get_child_value(snapshot, i);
+
+        g_variant_builder_add_value(&builder, child);
+    }
+
+    g_hash_table_iter_init(&iter, priv->priority_table);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        if (get_max_inflight(self, key) < priv->max_inflight_per_category)
+            g_variant_builder_add(&throttled_builder, "s", key);
+    }
+
+    g_variant_builder_add(&governor_builder, "{sv}", "playback-active", g_variant_new_boolean(priv->playback_active));
+    g_variant_builder_add(&governor_builder, "{sv}", "throttled-categories", g_variant_builder_end(&throttled_builder));
+
+    g_variant_builder_add(&builder, "{s@a{sv}}", "_governor", g_variant_builder_end(&governor_builder));
+
+    if (GT_IS_CACHE_FILE(priv->cache))
+        g_variant_builder_add(&builder, "{s@a{sv}}", "_cache", gt_cache_file_get_stats(GT_CACHE_FILE(priv->cache)));
+
+    return g_variant_builder_end(&builder);
+}
+
+static void
+prewarm_cb(SoupSession* session,
+    SoupMessage* msg, gpointer udata)
+{
+    g_autofree gchar* uri = soup_uri_to_string(soup_message_get_uri(msg), FALSE);
+    gint64 start_time = GPOINTER_TO_SIZE(udata);
+
+    DEBUG("Prewarmed connection to '%s' in '%.2f' ms with status '%u'", uri,
+        (g_get_monotonic_time() - start_time) / 1000.0, msg->status_code);
+}
+
+static void
+prewarm(GtHTTP* http, const gchar* uri)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP_SOUP(http));
+
+    GtHTTPSoup* self = GT_HTTP_SOUP(http);
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+    g_autoptr(SoupURI) soup_uri = soup_uri_new(uri);
+    gint64 now = g_get_monotonic_time();
+    gint64 last_prewarmed;
+    g_autofree gchar* key = NULL;
+    SoupMessage* msg = NULL;
+
+    RETURN_IF_FAIL(soup_uri != NULL);
+
+    key = g_strdup_printf("%s://%s:%u", soup_uri_get_scheme(soup_uri),
+        soup_uri_get_host(soup_uri), soup_uri_get_port(soup_uri));
+
+    last_prewarmed = GPOINTER_TO_SIZE(g_hash_table_lookup(priv->prewarm_table, key));
+
+    if (last_prewarmed > 0 && now - last_prewarmed < PREWARM_INTERVAL)
+        return;
+
+    g_hash_table_insert(priv->prewarm_table, g_steal_pointer(&key), GSIZE_TO_POINTER(now));
+
+    soup_session_prefetch_dns(priv->soup, soup_uri_get_host(soup_uri), NULL, NULL, NULL);
+
+    /* NOTE: A HEAD request leaves a keep-alive connection in the pool
+     * with the TLS handshake already done */
+    soup_uri_set_path(soup_uri, "/");
+    soup_uri_set_query(soup_uri, NULL);
+    msg = soup_message_new_from_uri(SOUP_METHOD_HEAD, soup_uri);
+
+    soup_session_queue_message(priv->soup, msg, prewarm_cb, GSIZE_TO_POINTER(now)); /* NOTE: Assumes ownership of msg */
+}
+
 static void
 dispose(GObject* obj)
 {
@@ -510,7 +1328,10 @@ dispose(GObject* obj)
 
     g_object_unref(priv->soup);
     g_hash_table_unref(priv->inflight_table);
-    g_object_unref(priv->cache);
+    g_hash_table_unref(priv->policy_table);
+    g_hash_table_unref(priv->prewarm_table);
+    g_hash_table_unref(priv->priority_table);
+    g_clear_object(&priv->cache);
 
     G_OBJECT_CLASS(gt_http_soup_parent_class)->dispose(obj);
 }
@@ -523,8 +1344,10 @@ finalize(GObject* obj)
     GtHTTPSoup* self = GT_HTTP_SOUP(obj);
     GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
 
-    g_queue_free_full(priv->message_queue, (GDestroyNotify) soup_callback_data_free);
+    g_queue_free_full(priv->message_queue, (GDestroyNotify) soup_callback_data_unref);
     g_free(priv->cache_directory);
+    g_free(priv->record_directory);
+    gt_http_stats_free(priv->stats);
 
     G_OBJECT_CLASS(gt_http_soup_parent_class)->finalize(obj);
 }
@@ -548,6 +1371,24 @@ get_property(GObject* obj,
         case PROP_CACHE_DIRECTORY:
             g_value_set_string(val, priv->cache_directory);
             break;
+        case PROP_RECORD_DIRECTORY:
+            g_value_set_string(val, priv->record_directory);
+            break;
+        case PROP_TIMEOUT:
+            g_value_set_uint(val, priv->timeout);
+            break;
+        case PROP_MAX_RETRIES:
+            g_value_set_uint(val, priv->max_retries);
+            break;
+        case PROP_PLAYBACK_ACTIVE:
+            g_value_set_boolean(val, priv->playback_active);
+            break;
+        case PROP_PLAYBACK_MAX_INFLIGHT:
+            g_value_set_uint(val, priv->playback_max_inflight);
+            break;
+        case PROP_CACHE:
+            g_value_set_object(val, priv->cache);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
     }
@@ -573,16 +1414,53 @@ set_property(GObject* obj,
             g_free(priv->cache_directory);
             priv->cache_directory = g_value_dup_string(val);
             break;
+        case PROP_RECORD_DIRECTORY:
+            g_free(priv->record_directory);
+            priv->record_directory = g_value_dup_string(val);
+            break;
+        case PROP_TIMEOUT:
+            priv->timeout = g_value_get_uint(val);
+            break;
+        case PROP_MAX_RETRIES:
+            priv->max_retries = g_value_get_uint(val);
+            break;
+        case PROP_PLAYBACK_ACTIVE:
+            set_playback_active(self, g_value_get_boolean(val));
+            break;
+        case PROP_PLAYBACK_MAX_INFLIGHT:
+            priv->playback_max_inflight = g_value_get_uint(val);
+            break;
+        case PROP_CACHE:
+            g_clear_object(&priv->cache);
+            priv->cache = g_value_dup_object(val);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
     }
 }
 
+static void
+constructed(GObject* obj)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP_SOUP(obj));
+
+    GtHTTPSoup* self = GT_HTTP_SOUP(obj);
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    /* NOTE: Share a cache when given one so other downloaders hit the same store */
+    if (!priv->cache)
+        priv->cache = GT_CACHE(gt_cache_file_new()); /* TODO: Use libpeas to load this dynamically */
+
+    G_OBJECT_CLASS(gt_http_soup_parent_class)->constructed(obj);
+}
+
 static void
 gt_http_iface_init(GtHTTPInterface* iface)
 {
     iface->get = get;
     iface->get_with_category = get_with_category;
+    iface->get_stats = get_stats;
+    iface->prewarm = prewarm;
 }
 
 static void
@@ -594,6 +1472,7 @@ gt_http_soup_class_init(GtHTTPSoupClass* klass)
     obj_class->set_property = set_property;
     obj_class->finalize = finalize;
     obj_class->dispose = dispose;
+    obj_class->constructed = constructed;
 
     g_autofree gchar* default_cache_directory = g_build_filename(g_get_user_cache_dir(),
         "gnome-twitch", "http-cache", NULL);
@@ -606,8 +1485,37 @@ gt_http_soup_class_init(GtHTTPSoupClass* klass)
         "Cache directory", "Directory where cached files should be placed",
         default_cache_directory, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
 
+    props[PROP_RECORD_DIRECTORY] = g_param_spec_string("record-directory",
+        "Record directory", "Directory where responses are recorded for replaying, NULL to disable",
+        NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
     g_object_class_override_property(obj_class, PROP_MAX_INFLIGHT_PER_CATEGORY, "max-inflight-per-category");
     g_object_class_override_property(obj_class, PROP_CACHE_DIRECTORY, "cache-directory");
+
+    props[PROP_TIMEOUT] = g_param_spec_uint("timeout",
+        "Timeout", "Milliseconds to wait for a response before retrying or giving up, 0 to wait forever",
+        0, G_MAXUINT, 15000, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    props[PROP_MAX_RETRIES] = g_param_spec_uint("max-retries",
+        "Max retries", "Maximum times a failed or timed out request is retried",
+        0, G_MAXUINT, 2, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    props[PROP_PLAYBACK_MAX_INFLIGHT] = g_param_spec_uint("playback-max-inflight",
+        "Playback max inflight", "Maximum inflight messages for low priority categories while playback is active",
+        0, G_MAXUINT, 1, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    props[PROP_CACHE] = g_param_spec_object("cache",
+        "Cache", "Cache responses are stored in, a GtCacheFile is created if not set",
+        GT_TYPE_CACHE, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+
+    g_object_class_override_property(obj_class, PROP_PLAYBACK_ACTIVE, "playback-active");
+    props[PROP_PLAYBACK_ACTIVE] = g_object_class_find_property(obj_class, "playback-active");
+
+    g_object_class_install_property(obj_class, PROP_RECORD_DIRECTORY, props[PROP_RECORD_DIRECTORY]);
+    g_object_class_install_property(obj_class, PROP_PLAYBACK_MAX_INFLIGHT, props[PROP_PLAYBACK_MAX_INFLIGHT]);
+    g_object_class_install_property(obj_class, PROP_TIMEOUT, props[PROP_TIMEOUT]);
+    g_object_class_install_property(obj_class, PROP_MAX_RETRIES, props[PROP_MAX_RETRIES]);
+    g_object_class_install_property(obj_class, PROP_CACHE, props[PROP_CACHE]);
 }
 
 static void
@@ -618,7 +1526,10 @@ gt_http_soup_init(GtHTTPSoup* self)
     priv->soup = soup_session_new();
     priv->message_queue = g_queue_new();
     priv->inflight_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
-    priv->cache = GT_CACHE(gt_cache_file_new()); /* TODO: Use libpeas to load this dynamically */
+    priv->stats = gt_http_stats_new();
+    priv->policy_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    priv->prewarm_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    priv->priority_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 }
 
 GtHTTPSoup*
@@ -626,3 +1537,34 @@ gt_http_soup_new()
 {
     return g_object_new(GT_TYPE_HTTP_SOUP, NULL);
 }
+
+/* NOTE: Overrides the 'timeout' and 'max-retries' properties for a
+ * category. Hedging sends a second request once the first has taken
+ * longer than 95% of the requests seen so far in the category */
+void
+gt_http_soup_set_category_policy(GtHTTPSoup* self, const gchar* category,
+    guint timeout, guint max_retries, gboolean hedge)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP_SOUP(self));
+    RETURN_IF_FAIL(!utils_str_empty(category));
+
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+    CategoryPolicy* policy = g_new(CategoryPolicy, 1);
+
+    policy->timeout = timeout;
+    policy->max_retries = max_retries;
+    policy->hedge = hedge;
+
+    g_hash_table_insert(priv->policy_table, g_strdup(category), policy);
+}
+
+void
+gt_http_soup_set_category_priority(GtHTTPSoup* self, const gchar* category, GtHTTPSoupPriority priority)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP_SOUP(self));
+    RETURN_IF_FAIL(!utils_str_empty(category));
+
+    GtHTTPSoupPrivate* priv = gt_http_soup_get_instance_private(self);
+
+    g_hash_table_insert(priv->priority_table, g_strdup(category), GINT_TO_POINTER(priority));
+}
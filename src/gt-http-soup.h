@@ -27,12 +27,22 @@ G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE(GtHTTPSoup, gt_http_soup, GT, HTTP_SOUP, GObject);
 
+/* NOTE: How a category is treated while 'playback-active' is set */
+typedef enum
+{
+    GT_HTTP_SOUP_PRIORITY_NORMAL, /* NOTE: Not affected */
+    GT_HTTP_SOUP_PRIORITY_LOW,    /* NOTE: Limited to 'playback-max-inflight' */
+    GT_HTTP_SOUP_PRIORITY_IDLE,   /* NOTE: Paused until playback stops */
+} GtHTTPSoupPriority;
+
 struct _GtHTTPSoup
 {
     GObject parent_instance;
 };
 
 GtHTTPSoup* gt_http_soup_new();
+void        gt_http_soup_set_category_priority(GtHTTPSoup* self, const gchar* category, GtHTTPSoupPriority priority);
+void        gt_http_soup_set_category_policy(GtHTTPSoup* self, const gchar* category, guint timeout, guint max_retries, gboolean hedge);
 
 G_END_DECLS
 
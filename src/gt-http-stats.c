@@ -0,0 +1,283 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-http-stats.h"
+#include "utils.h"
+
+#define TAG "GtHTTPStats"
+#include "gnome-twitch/gt-log.h"
+
+typedef struct
+{
+    guint64 counters[GT_HTTP_STATS_NUM_COUNTERS];
+    guint64 histograms[GT_HTTP_STATS_NUM_TIMINGS][GT_HTTP_STATS_NUM_BUCKETS];
+} GtHTTPCategoryStats;
+
+struct _GtHTTPStats
+{
+    GHashTable* categories;
+};
+
+static const gchar* COUNTER_NAMES[] =
+{
+    "requests",
+    "cache-hits",
+    "not-modified",
+    "cache-misses",
+    "cancelled",
+    "errors",
+    "bytes",
+    "retries",
+    "timeouts",
+    "hedges",
+    "throttled",
+};
+
+static const gchar* TIMING_NAMES[] =
+{
+    "queue-wait",
+    "time-to-first-byte",
+    "total-time",
+};
+
+G_STATIC_ASSERT(G_N_ELEMENTS(COUNTER_NAMES) == GT_HTTP_STATS_NUM_COUNTERS);
+G_STATIC_ASSERT(G_N_ELEMENTS(TIMING_NAMES) == GT_HTTP_STATS_NUM_TIMINGS);
+
+static GtHTTPCategoryStats*
+get_category(GtHTTPStats* stats, const gchar* category)
+{
+    GtHTTPCategoryStats* ret = g_hash_table_lookup(stats->categories, category);
+
+    if (!ret)
+    {
+        ret = g_slice_new0(GtHTTPCategoryStats);
+        g_hash_table_insert(stats->categories, g_strdup(category), ret);
+    }
+
+    return ret;
+}
+
+static void
+category_stats_free(GtHTTPCategoryStats* stats)
+{
+    g_slice_free(GtHTTPCategoryStats, stats);
+}
+
+/* NOTE: Returns the upper bound of the bucket the percentile falls
+ * in, in microseconds, or -1 if there aren't enough samples */
+static gint64
+histogram_percentile(const guint64* buckets, gdouble percentile, guint64 min_samples)
+{
+    guint64 total = 0;
+    guint64 target;
+    guint64 seen = 0;
+
+    for (gint i = 0; i < GT_HTTP_STATS_NUM_BUCKETS; i++)
+        total += buckets[i];
+
+    if (total == 0 || total < min_samples)
+        return -1;
+
+    target = (guint64) (total * percentile + 0.5);
+    target = CLAMP(target, 1, total);
+
+    for (gint i = 0; i < GT_HTTP_STATS_NUM_BUCKETS; i++)
+    {
+        seen += buckets[i];
+
+        if (seen >= target)
+            return ((gint64) 1 << i) * 1000;
+    }
+
+    RETURN_VAL_IF_REACHED(-1);
+}
+
+GtHTTPStats*
+gt_http_stats_new()
+{
+    GtHTTPStats* stats = g_slice_new0(GtHTTPStats);
+
+    stats->categories = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) category_stats_free);
+
+    return stats;
+}
+
+void
+gt_http_stats_free(GtHTTPStats* stats)
+{
+    if (!stats) return;
+
+    g_hash_table_unref(stats->categories);
+
+    g_slice_free(GtHTTPStats, stats);
+}
+
+void
+gt_http_stats_add(GtHTTPStats* stats, const gchar* category, GtHTTPStatsCounter counter, guint64 amount)
+{
+    RETURN_IF_FAIL(stats != NULL);
+    RETURN_IF_FAIL(!utils_str_empty(category));
+    RETURN_IF_FAIL(counter < GT_HTTP_STATS_NUM_COUNTERS);
+
+    get_category(stats, category)->counters[counter] += amount;
+}
+
+void
+gt_http_stats_add_timing(GtHTTPStats* stats, const gchar* category, GtHTTPStatsTiming timing, gint64 usecs)
+{
+    RETURN_IF_FAIL(stats != NULL);
+    RETURN_IF_FAIL(!utils_str_empty(category));
+    RETURN_IF_FAIL(timing < GT_HTTP_STATS_NUM_TIMINGS);
+
+    guint64 msecs = MAX(usecs, 0) / 1000;
+    guint bucket = msecs == 0 ? 0 : g_bit_storage(msecs);
+
+    bucket = MIN(bucket, GT_HTTP_STATS_NUM_BUCKETS - 1);
+
+    get_category(stats, category)->histograms[timing][bucket]++;
+}
+
+gint64
+gt_http_stats_get_percentile(GtHTTPStats* stats, const gchar* category,
+    GtHTTPStatsTiming timing, gdouble percentile, guint64 min_samples)
+{
+    RETURN_VAL_IF_FAIL(stats != NULL, -1);
+    RETURN_VAL_IF_FAIL(!utils_str_empty(category), -1);
+    RETURN_VAL_IF_FAIL(timing < GT_HTTP_STATS_NUM_TIMINGS, -1);
+
+    GtHTTPCategoryStats* cat = g_hash_table_lookup(stats->categories, category);
+
+    if (!cat) return -1;
+
+    return histogram_percentile(cat->histograms[timing], percentile, min_samples);
+}
+
+/* NOTE: The snapshot has the type a{sa{sv}}, mapping each category to
+ * its counters as 't' and its histograms as 'at' */
+GVariant*
+gt_http_stats_snapshot(GtHTTPStats* stats)
+{
+    RETURN_VAL_IF_FAIL(stats != NULL, NULL);
+
+    GVariantBuilder builder;
+    GHashTableIter iter;
+    gpointer key;
+    gpointer value;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sa{sv}}"));
+
+    g_hash_table_iter_init(&iter, stats->categories);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        GtHTTPCategoryStats* cat = value;
+        GVariantBuilder cat_builder;
+
+        g_variant_builder_init(&cat_builder, G_VARIANT_TYPE_VARDICT);
+
+        for (gint i = 0; i < GT_HTTP_STATS_NUM_COUNTERS; i++)
+            g_variant_builder_add(&cat_builder, "{sv}", COUNTER_NAMES[i], g_variant_new_uint64(cat->counters[i]));
+
+        for (gint i = 0; i < GT_HTTP_STATS_NUM_TIMINGS; i++)
+        {
+            g_variant_builder_add(&cat_builder, "{sv}", TIMING_NAMES[i],
+                g_variant_new_fixed_array(G_VARIANT_TYPE_UINT64, cat->histograms[i],
+                    GT_HTTP_STATS_NUM_BUCKETS, sizeof(guint64)));
+        }
+
+        g_variant_builder_add(&builder, "{s@a{sv}}", key, g_variant_builder_end(&cat_builder));
+    }
+
+    return g_variant_builder_end(&builder);
+}
+
+/* NOTE: Turns a snapshot into a human readable report. Unknown keys
+ * are printed as is so implementations can add their own */
+gchar*
+gt_http_stats_format_snapshot(GVariant* snapshot)
+{
+    RETURN_VAL_IF_FAIL(snapshot != NULL, NULL);
+    RETURN_VAL_IF_FAIL(g_variant_is_of_type(snapshot, G_VARIANT_TYPE("a{sa{sv}}")), NULL);
+
+    GString* ret = g_string_new(NULL);
+    GVariantIter iter;
+    const gchar* category;
+    GVariant* cat_dict;
+
+    g_variant_iter_init(&iter, snapshot);
+    while (g_variant_iter_loop(&iter, "{&s@a{sv}}", &category, &cat_dict))
+    {
+        GVariantIter cat_iter;
+        const gchar* name;
+        GVariant* value;
+        guint64 hits = 0;
+        guint64 lookups = 0;
+
+        g_string_append_printf(ret, "%s:\n", category);
+
+        g_variant_iter_init(&cat_iter, cat_dict);
+        while (g_variant_iter_loop(&cat_iter, "{&sv}", &name, &value))
+        {
+            if (g_variant_is_of_type(value, G_VARIANT_TYPE_UINT64))
+            {
+                guint64 count = g_variant_get_uint64(value);
+
+                if (g_strcmp0(name, "cache-hits") == 0 || g_strcmp0(name, "not-modified") == 0)
+                {
+                    hits += count;
+                    lookups += count;
+                }
+                else if (g_strcmp0(name, "cache-misses") == 0)
+                    lookups += count;
+
+                g_string_append_printf(ret, "  %-20s %" G_GUINT64_FORMAT "\n", name, count);
+            }
+            else if (g_variant_is_of_type(value, G_VARIANT_TYPE("at")))
+            {
+                gsize n_buckets;
+                const guint64* buckets = g_variant_get_fixed_array(value, &n_buckets, sizeof(guint64));
+
+                if (n_buckets != GT_HTTP_STATS_NUM_BUCKETS)
+                    continue;
+
+                if (histogram_percentile(buckets, 0.50, 1) < 0)
+                {
+                    g_string_append_printf(ret, "  %-20s no samples\n", name);
+                    continue;
+                }
+
+                g_string_append_printf(ret, "  %-20s p50 <%" G_GINT64_FORMAT "ms p95 <%" G_GINT64_FORMAT "ms p99 <%" G_GINT64_FORMAT "ms\n",
+                    name,
+                    histogram_percentile(buckets, 0.50, 1) / 1000,
+                    histogram_percentile(buckets, 0.95, 1) / 1000,
+                    histogram_percentile(buckets, 0.99, 1) / 1000);
+            }
+            else
+            {
+                g_autofree gchar* printed = g_variant_print(value, FALSE);
+
+                g_string_append_printf(ret, "  %-20s %s\n", name, printed);
+            }
+        }
+
+        if (lookups > 0)
+            g_string_append_printf(ret, "  %-20s %.1f%%\n", "cache-hit-ratio", 100.0 * hits / lookups);
+    }
+
+    return g_string_free(ret, FALSE);
+}
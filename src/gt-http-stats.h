@@ -0,0 +1,69 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GT_HTTP_STATS_H
+#define GT_HTTP_STATS_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* NOTE: Timings are kept in log2 histograms of milliseconds. Bucket
+ * 0 holds everything under 1ms and bucket N everything under 2^N ms,
+ * the last bucket catches the rest */
+#define GT_HTTP_STATS_NUM_BUCKETS 20
+
+typedef enum
+{
+    GT_HTTP_STATS_REQUESTS,
+    GT_HTTP_STATS_CACHE_HITS,
+    GT_HTTP_STATS_NOT_MODIFIED,
+    GT_HTTP_STATS_CACHE_MISSES,
+    GT_HTTP_STATS_CANCELLED,
+    GT_HTTP_STATS_ERRORS,
+    GT_HTTP_STATS_BYTES,
+    GT_HTTP_STATS_RETRIES,
+    GT_HTTP_STATS_TIMEOUTS,
+    GT_HTTP_STATS_HEDGES,
+    GT_HTTP_STATS_THROTTLED,
+    GT_HTTP_STATS_NUM_COUNTERS,
+} GtHTTPStatsCounter;
+
+typedef enum
+{
+    GT_HTTP_STATS_QUEUE_WAIT,
+    GT_HTTP_STATS_TIME_TO_FIRST_BYTE,
+    GT_HTTP_STATS_TOTAL_TIME,
+    GT_HTTP_STATS_NUM_TIMINGS,
+} GtHTTPStatsTiming;
+
+typedef struct _GtHTTPStats GtHTTPStats;
+
+GtHTTPStats* gt_http_stats_new();
+void         gt_http_stats_free(GtHTTPStats* stats);
+void         gt_http_stats_add(GtHTTPStats* stats, const gchar* category, GtHTTPStatsCounter counter, guint64 amount);
+void         gt_http_stats_add_timing(GtHTTPStats* stats, const gchar* category, GtHTTPStatsTiming timing, gint64 usecs);
+gint64       gt_http_stats_get_percentile(GtHTTPStats* stats, const gchar* category, GtHTTPStatsTiming timing, gdouble percentile, guint64 min_samples);
+GVariant*    gt_http_stats_snapshot(GtHTTPStats* stats);
+gchar*       gt_http_stats_format_snapshot(GVariant* snapshot);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtHTTPStats, gt_http_stats_free);
+
+G_END_DECLS
+
+#endif
@@ -36,6 +36,10 @@ gt_http_default_init(GtHTTPInterface* iface)
     g_object_interface_install_property(iface, g_param_spec_string("cache-directory",
             "Cache directory", "Directory where cached files should be placed",
             default_cache_directory, G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+    g_object_interface_install_property(iface, g_param_spec_boolean("playback-active",
+            "Playback active", "Whether a stream or VOD is playing and needs the bandwidth",
+            FALSE, G_PARAM_READWRITE));
 }
 
 void
@@ -57,3 +61,31 @@ gt_http_get_with_category(GtHTTP* http, const gchar* uri, const gchar* category,
 
     return GT_HTTP_GET_IFACE(http)->get_with_category(http, uri, category, headers, cancel, cb, udata, flags);
 }
+
+/* NOTE: Returns a snapshot in the format of gt_http_stats_snapshot or
+ * NULL if the implementation doesn't keep any stats */
+GVariant*
+gt_http_get_stats(GtHTTP* http)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_HTTP(http), NULL);
+
+    if (!GT_HTTP_GET_IFACE(http)->get_stats)
+        return NULL;
+
+    return GT_HTTP_GET_IFACE(http)->get_stats(http);
+}
+
+/* NOTE: Resolves the host of uri and opens a connection to it so a
+ * request made soon after doesn't have to wait for it. Does nothing if
+ * the implementation doesn't support it */
+void
+gt_http_prewarm(GtHTTP* http, const gchar* uri)
+{
+    RETURN_IF_FAIL(GT_IS_HTTP(http));
+    RETURN_IF_FAIL(uri != NULL);
+
+    if (!GT_HTTP_GET_IFACE(http)->prewarm)
+        return;
+
+    GT_HTTP_GET_IFACE(http)->prewarm(http, uri);
+}
@@ -73,6 +73,8 @@ struct _GtHTTPInterface
         GCancellable* cancel, GCallback cb, gpointer udata, gint flags);
     void (*get_with_category) (GtHTTP* http, const gchar* uri, const gchar* category, gchar** headers,
         GCancellable* cancel, GCallback cb, gpointer udata, gint flags);
+    GVariant* (*get_stats) (GtHTTP* http);
+    void (*prewarm) (GtHTTP* http, const gchar* uri);
 };
 
 /* TODO: Add docs */
@@ -80,6 +82,8 @@ void gt_http_get(GtHTTP* http, const gchar* uri, gchar** headers,
         GCancellable* cancel, GCallback cb, gpointer udata, gint flags);
 void gt_http_get_with_category(GtHTTP* http, const gchar* uri, const gchar* category, gchar** headers,
     GCancellable* cancel, GCallback cb, gpointer udata, gint flags);
+GVariant* gt_http_get_stats(GtHTTP* http);
+void gt_http_prewarm(GtHTTP* http, const gchar* uri);
 
 G_END_DECLS
 
@@ -0,0 +1,285 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-hydration-queue.h"
+#include "utils.h"
+
+#define TAG "GtHydrationQueue"
+#include "gnome-twitch/gt-log.h"
+
+/* NOTE: Items out of view are hydrated at most this many per interval,
+ * in view ones this many per main loop iteration */
+#define BACKGROUND_BATCH_SIZE 2
+#define BACKGROUND_INTERVAL 250 /* NOTE: Milliseconds */
+#define URGENT_BATCH_SIZE 16
+
+typedef struct
+{
+    GtHydrationQueue* queue;
+    GObject* item; /* NOTE: Weak */
+    GtHydrateFunc func;
+    GQueue* pending; /* NOTE: The queue the link is in */
+    GList link;
+} GtHydrationEntry;
+
+typedef struct
+{
+    GQueue urgent;
+    GQueue background;
+    GHashTable* entries; /* NOTE: Maps items to entries */
+
+    guint urgent_id;
+    guint background_id;
+} GtHydrationQueuePrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE(GtHydrationQueue, gt_hydration_queue, G_TYPE_OBJECT);
+
+static void
+item_finalized_cb(gpointer udata, GObject* where_the_object_was);
+
+static gboolean
+run_urgent_cb(gpointer udata);
+
+static gboolean
+run_background_cb(gpointer udata);
+
+static void
+entry_free(GtHydrationEntry* entry)
+{
+    g_slice_free(GtHydrationEntry, entry);
+}
+
+static void
+entry_unlink(GtHydrationEntry* entry)
+{
+    GtHydrationQueuePrivate* priv = gt_hydration_queue_get_instance_private(entry->queue);
+
+    g_queue_unlink(entry->pending, &entry->link);
+    g_hash_table_remove(priv->entries, entry->item);
+}
+
+static void
+schedule(GtHydrationQueue* self)
+{
+    GtHydrationQueuePrivate* priv = gt_hydration_queue_get_instance_private(self);
+
+    if (priv->urgent.length > 0 && priv->urgent_id == 0)
+        priv->urgent_id = g_idle_add(run_urgent_cb, self);
+
+    if (priv->background.length > 0 && priv->background_id == 0)
+    {
+        priv->background_id = g_timeout_add_full(G_PRIORITY_LOW, BACKGROUND_INTERVAL,
+            run_background_cb, self, NULL);
+    }
+}
+
+static guint
+run(GtHydrationQueue* self, GQueue* pending, guint max)
+{
+    guint ran = 0;
+
+    for (; ran < max && pending->length > 0; ran++)
+    {
+        GtHydrationEntry* entry = g_queue_peek_head_link(pending)->data;
+        GObject* item = entry->item;
+        GtHydrateFunc func = entry->func;
+
+        g_object_weak_unref(item, item_finalized_cb, entry);
+        entry_unlink(entry);
+        entry_free(entry);
+
+        /* NOTE: Hold a ref in case hydrating drops the last one */
+        g_object_ref(item);
+        func(item);
+        g_object_unref(item);
+    }
+
+    return ran;
+}
+
+static gboolean
+run_urgent_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_HYDRATION_QUEUE(udata), G_SOURCE_REMOVE);
+
+    GtHydrationQueue* self = GT_HYDRATION_QUEUE(udata);
+    GtHydrationQueuePrivate* priv = gt_hydration_queue_get_instance_private(self);
+
+    guint ran = run(self, &priv->urgent, URGENT_BATCH_SIZE);
+
+    TRACE("Hydrated '%d' items in view", ran);
+
+    if (priv->urgent.length > 0)
+        return G_SOURCE_CONTINUE;
+
+    priv->urgent_id = 0;
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+run_background_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_HYDRATION_QUEUE(udata), G_SOURCE_REMOVE);
+
+    GtHydrationQueue* self = GT_HYDRATION_QUEUE(udata);
+    GtHydrationQueuePrivate* priv = gt_hydration_queue_get_instance_private(self);
+
+    /* NOTE: Stay out of the way of the items in view */
+    if (priv->urgent.length == 0)
+    {
+        guint ran = run(self, &priv->background, BACKGROUND_BATCH_SIZE);
+
+        TRACE("Hydrated '%d' items out of view", ran);
+    }
+
+    if (priv->background.length > 0)
+        return G_SOURCE_CONTINUE;
+
+    priv->background_id = 0;
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+item_finalized_cb(gpointer udata, GObject* where_the_object_was)
+{
+    GtHydrationEntry* entry = udata;
+
+    entry_unlink(entry);
+    entry_free(entry);
+}
+
+static void
+finalize(GObject* obj)
+{
+    GtHydrationQueue* self = GT_HYDRATION_QUEUE(obj);
+    GtHydrationQueuePrivate* priv = gt_hydration_queue_get_instance_private(self);
+    GQueue* queues[] = {&priv->urgent, &priv->background};
+
+    if (priv->urgent_id > 0)
+        g_source_remove(priv->urgent_id);
+
+    if (priv->background_id > 0)
+        g_source_remove(priv->background_id);
+
+    for (guint i = 0; i < G_N_ELEMENTS(queues); i++)
+    {
+        while (queues[i]->length > 0)
+        {
+            GtHydrationEntry* entry = g_queue_peek_head_link(queues[i])->data;
+
+            g_object_weak_unref(entry->item, item_finalized_cb, entry);
+            entry_unlink(entry);
+            entry_free(entry);
+        }
+    }
+
+    g_hash_table_unref(priv->entries);
+
+    G_OBJECT_CLASS(gt_hydration_queue_parent_class)->finalize(obj);
+}
+
+static void
+gt_hydration_queue_class_init(GtHydrationQueueClass* klass)
+{
+    G_OBJECT_CLASS(klass)->finalize = finalize;
+}
+
+static void
+gt_hydration_queue_init(GtHydrationQueue* self)
+{
+    GtHydrationQueuePrivate* priv = gt_hydration_queue_get_instance_private(self);
+
+    g_queue_init(&priv->urgent);
+    g_queue_init(&priv->background);
+
+    priv->entries = g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
+GtHydrationQueue*
+gt_hydration_queue_new(void)
+{
+    return g_object_new(GT_TYPE_HYDRATION_QUEUE, NULL);
+}
+
+void
+gt_hydration_queue_add(GtHydrationQueue* self, GObject* item, GtHydrateFunc func)
+{
+    RETURN_IF_FAIL(GT_IS_HYDRATION_QUEUE(self));
+    RETURN_IF_FAIL(G_IS_OBJECT(item));
+    RETURN_IF_FAIL(func != NULL);
+
+    GtHydrationQueuePrivate* priv = gt_hydration_queue_get_instance_private(self);
+    GtHydrationEntry* entry = NULL;
+
+    if ((entry = g_hash_table_lookup(priv->entries, item)) != NULL)
+    {
+        entry->func = func;
+        return;
+    }
+
+    entry = g_slice_new0(GtHydrationEntry);
+    entry->queue = self;
+    entry->item = item;
+    entry->func = func;
+    entry->link.data = entry;
+    entry->pending = &priv->background;
+
+    g_object_weak_ref(item, item_finalized_cb, entry);
+    g_hash_table_insert(priv->entries, item, entry);
+    g_queue_push_tail_link(entry->pending, &entry->link);
+
+    schedule(self);
+}
+
+void
+gt_hydration_queue_promote(GtHydrationQueue* self, GObject* item)
+{
+    RETURN_IF_FAIL(GT_IS_HYDRATION_QUEUE(self));
+    RETURN_IF_FAIL(G_IS_OBJECT(item));
+
+    GtHydrationQueuePrivate* priv = gt_hydration_queue_get_instance_private(self);
+    GtHydrationEntry* entry = g_hash_table_lookup(priv->entries, item);
+
+    if (!entry || entry->pending == &priv->urgent)
+        return;
+
+    g_queue_unlink(entry->pending, &entry->link);
+    entry->pending = &priv->urgent;
+    g_queue_push_tail_link(entry->pending, &entry->link);
+
+    schedule(self);
+}
+
+void
+gt_hydration_queue_remove(GtHydrationQueue* self, GObject* item)
+{
+    RETURN_IF_FAIL(GT_IS_HYDRATION_QUEUE(self));
+    RETURN_IF_FAIL(G_IS_OBJECT(item));
+
+    GtHydrationQueuePrivate* priv = gt_hydration_queue_get_instance_private(self);
+    GtHydrationEntry* entry = g_hash_table_lookup(priv->entries, item);
+
+    if (!entry)
+        return;
+
+    g_object_weak_unref(item, item_finalized_cb, entry);
+    entry_unlink(entry);
+    entry_free(entry);
+}
@@ -0,0 +1,49 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GT_HYDRATION_QUEUE_H
+#define GT_HYDRATION_QUEUE_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define GT_TYPE_HYDRATION_QUEUE gt_hydration_queue_get_type()
+
+G_DECLARE_FINAL_TYPE(GtHydrationQueue, gt_hydration_queue, GT, HYDRATION_QUEUE, GObject);
+
+struct _GtHydrationQueue
+{
+    GObject parent_instance;
+};
+
+typedef void (*GtHydrateFunc) (GObject* item);
+
+/* NOTE: Spreads out filling in items that were created without their
+ * data, so that loading a lot of them doesn't send every request at
+ * once. Items that are in view are hydrated straight away, the rest a
+ * few at a time. An item is queued at most once and is dropped from
+ * the queue if it's finalized before its turn. */
+GtHydrationQueue* gt_hydration_queue_new(void);
+void              gt_hydration_queue_add(GtHydrationQueue* self, GObject* item, GtHydrateFunc func);
+void              gt_hydration_queue_promote(GtHydrationQueue* self, GObject* item);
+void              gt_hydration_queue_remove(GtHydrationQueue* self, GObject* item);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,312 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-image-cache.h"
+#include "utils.h"
+
+#define TAG "GtImageCache"
+#include "gnome-twitch/gt-log.h"
+
+typedef struct
+{
+    gchar* key;
+    GdkPixbuf* pixbuf;
+    gsize size;
+    gint64 expiry; /* NOTE: Monotonic, 0 if it doesn't expire */
+} GtImageCacheEntry;
+
+typedef struct
+{
+    GHashTable* table; /* NOTE: Maps keys to links in the lru queue */
+    GQueue* lru; /* NOTE: Most recently used first */
+
+    guint64 max_size;
+    guint64 size;
+
+    guint64 hits;
+    guint64 misses;
+    guint64 evictions;
+
+    /* NOTE: Guards everything above, channels are created and look up
+     * their preview on GtTwitch's worker threads too */
+    GMutex mutex;
+} GtImageCachePrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE(GtImageCache, gt_image_cache, G_TYPE_OBJECT);
+
+enum
+{
+    PROP_0,
+    PROP_MAX_SIZE,
+    PROP_SIZE,
+    NUM_PROPS,
+};
+
+static GParamSpec* props[NUM_PROPS];
+
+static gchar*
+make_key(const gchar* uri, gint width, gint height)
+{
+    return g_strdup_printf("%s@%dx%d", uri, width, height);
+}
+
+static void
+entry_free(GtImageCacheEntry* entry)
+{
+    g_free(entry->key);
+    g_object_unref(entry->pixbuf);
+    g_slice_free(GtImageCacheEntry, entry);
+}
+
+static void
+remove_link(GtImageCache* self, GList* link)
+{
+    GtImageCachePrivate* priv = gt_image_cache_get_instance_private(self);
+
+    GtImageCacheEntry* entry = link->data;
+
+    priv->size -= entry->size;
+
+    g_hash_table_remove(priv->table, entry->key);
+    g_queue_delete_link(priv->lru, link);
+
+    entry_free(entry);
+}
+
+static void
+evict(GtImageCache* self)
+{
+    GtImageCachePrivate* priv = gt_image_cache_get_instance_private(self);
+
+    while (priv->size > priv->max_size && !g_queue_is_empty(priv->lru))
+    {
+        remove_link(self, g_queue_peek_tail_link(priv->lru));
+        priv->evictions++;
+    }
+}
+
+GdkPixbuf*
+gt_image_cache_lookup(GtImageCache* self, const gchar* uri, gint width, gint height)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_IMAGE_CACHE(self), NULL);
+
+    GtImageCachePrivate* priv = gt_image_cache_get_instance_private(self);
+
+    g_autofree gchar* key = NULL;
+    g_autoptr(GMutexLocker) locker = NULL;
+    GtImageCacheEntry* entry;
+    GList* link;
+
+    if (utils_str_empty(uri))
+        return NULL;
+
+    key = make_key(uri, width, height);
+
+    locker = g_mutex_locker_new(&priv->mutex);
+
+    if ((link = g_hash_table_lookup(priv->table, key)) == NULL)
+    {
+        priv->misses++;
+        return NULL;
+    }
+
+    entry = link->data;
+
+    if (entry->expiry > 0 && g_get_monotonic_time() > entry->expiry)
+    {
+        TRACE("Expired image for '%s'", key);
+
+        remove_link(self, link);
+        priv->misses++;
+
+        return NULL;
+    }
+
+    g_queue_unlink(priv->lru, link);
+    g_queue_push_head_link(priv->lru, link);
+
+    priv->hits++;
+
+    return g_object_ref(entry->pixbuf);
+}
+
+/* NOTE: A ttl of 0 means the image never expires, it's only dropped
+ * when it's the least recently used and we're over budget */
+void
+gt_image_cache_insert(GtImageCache* self, const gchar* uri, gint width, gint height, GdkPixbuf* pixbuf, guint ttl)
+{
+    RETURN_IF_FAIL(GT_IS_IMAGE_CACHE(self));
+    RETURN_IF_FAIL(!utils_str_empty(uri));
+    RETURN_IF_FAIL(GDK_IS_PIXBUF(pixbuf));
+
+    GtImageCachePrivate* priv = gt_image_cache_get_instance_private(self);
+
+    GtImageCacheEntry* entry = g_slice_new0(GtImageCacheEntry);
+    g_autoptr(GMutexLocker) locker = NULL;
+    GList* link;
+
+    entry->key = make_key(uri, width, height);
+    entry->pixbuf = g_object_ref(pixbuf);
+    entry->size = gdk_pixbuf_get_byte_length(pixbuf);
+    entry->expiry = ttl > 0 ? g_get_monotonic_time() + ttl*G_USEC_PER_SEC : 0;
+
+    locker = g_mutex_locker_new(&priv->mutex);
+
+    if ((link = g_hash_table_lookup(priv->table, entry->key)) != NULL)
+        remove_link(self, link);
+
+    /* NOTE: Don't let one huge image flush everything else */
+    if (entry->size > priv->max_size)
+    {
+        entry_free(entry);
+        return;
+    }
+
+    g_queue_push_head(priv->lru, entry);
+    g_hash_table_insert(priv->table, entry->key, g_queue_peek_head_link(priv->lru));
+
+    priv->size += entry->size;
+
+    evict(self);
+}
+
+/* NOTE: Returns a floating a{sv} */
+GVariant*
+gt_image_cache_get_stats(GtImageCache* self)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_IMAGE_CACHE(self), NULL);
+
+    GtImageCachePrivate* priv = gt_image_cache_get_instance_private(self);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+    GVariantBuilder builder;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+
+    g_variant_builder_add(&builder, "{sv}", "entries", g_variant_new_uint64(g_queue_get_length(priv->lru)));
+    g_variant_builder_add(&builder, "{sv}", "size", g_variant_new_uint64(priv->size));
+    g_variant_builder_add(&builder, "{sv}", "max-size", g_variant_new_uint64(priv->max_size));
+    g_variant_builder_add(&builder, "{sv}", "hits", g_variant_new_uint64(priv->hits));
+    g_variant_builder_add(&builder, "{sv}", "misses", g_variant_new_uint64(priv->misses));
+    g_variant_builder_add(&builder, "{sv}", "evictions", g_variant_new_uint64(priv->evictions));
+
+    return g_variant_builder_end(&builder);
+}
+
+static void
+finalize(GObject* obj)
+{
+    RETURN_IF_FAIL(GT_IS_IMAGE_CACHE(obj));
+
+    GtImageCache* self = GT_IMAGE_CACHE(obj);
+    GtImageCachePrivate* priv = gt_image_cache_get_instance_private(self);
+
+    MESSAGE("Image cache had '%" G_GUINT64_FORMAT "' hits, '%" G_GUINT64_FORMAT "' misses and '%" G_GUINT64_FORMAT "' evictions",
+        priv->hits, priv->misses, priv->evictions);
+
+    g_hash_table_unref(priv->table);
+    g_queue_free_full(priv->lru, (GDestroyNotify) entry_free);
+    g_mutex_clear(&priv->mutex);
+
+    G_OBJECT_CLASS(gt_image_cache_parent_class)->finalize(obj);
+}
+
+static void
+get_property(GObject* obj,
+    guint prop, GValue* val, GParamSpec* pspec)
+{
+    RETURN_IF_FAIL(GT_IS_IMAGE_CACHE(obj));
+
+    GtImageCache* self = GT_IMAGE_CACHE(obj);
+    GtImageCachePrivate* priv = gt_image_cache_get_instance_private(self);
+
+    switch (prop)
+    {
+        case PROP_MAX_SIZE:
+            g_value_set_uint64(val, priv->max_size);
+            break;
+        case PROP_SIZE:
+            g_mutex_lock(&priv->mutex);
+            g_value_set_uint64(val, priv->size);
+            g_mutex_unlock(&priv->mutex);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
+    }
+}
+
+static void
+set_property(GObject* obj,
+    guint prop, const GValue* val, GParamSpec* pspec)
+{
+    RETURN_IF_FAIL(GT_IS_IMAGE_CACHE(obj));
+
+    GtImageCache* self = GT_IMAGE_CACHE(obj);
+    GtImageCachePrivate* priv = gt_image_cache_get_instance_private(self);
+
+    switch (prop)
+    {
+        case PROP_MAX_SIZE:
+            g_mutex_lock(&priv->mutex);
+            priv->max_size = g_value_get_uint64(val);
+            evict(self);
+            g_mutex_unlock(&priv->mutex);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
+    }
+}
+
+static void
+gt_image_cache_class_init(GtImageCacheClass* klass)
+{
+    GObjectClass* obj_class = G_OBJECT_CLASS(klass);
+
+    obj_class->finalize = finalize;
+    obj_class->get_property = get_property;
+    obj_class->set_property = set_property;
+
+    props[PROP_MAX_SIZE] = g_param_spec_uint64("max-size",
+        "Max size", "Maximum number of pixel bytes to keep",
+        0, G_MAXUINT64, 64*1024*1024, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+
+    props[PROP_SIZE] = g_param_spec_uint64("size",
+        "Size", "Number of pixel bytes kept",
+        0, G_MAXUINT64, 0, G_PARAM_READABLE);
+
+    g_object_class_install_properties(obj_class, NUM_PROPS, props);
+}
+
+static void
+gt_image_cache_init(GtImageCache* self)
+{
+    GtImageCachePrivate* priv = gt_image_cache_get_instance_private(self);
+
+    priv->table = g_hash_table_new(g_str_hash, g_str_equal);
+    priv->lru = g_queue_new();
+
+    g_mutex_init(&priv->mutex);
+}
+
+GtImageCache*
+gt_image_cache_new(guint64 max_size)
+{
+    return g_object_new(GT_TYPE_IMAGE_CACHE,
+        "max-size", max_size,
+        NULL);
+}
@@ -0,0 +1,46 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GT_IMAGE_CACHE_H
+#define GT_IMAGE_CACHE_H
+
+#include <glib-object.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+G_BEGIN_DECLS
+
+#define GT_TYPE_IMAGE_CACHE gt_image_cache_get_type()
+
+G_DECLARE_FINAL_TYPE(GtImageCache, gt_image_cache, GT, IMAGE_CACHE, GObject);
+
+struct _GtImageCache
+{
+    GObject parent_instance;
+};
+
+/* NOTE: In memory LRU of decoded images, keyed by uri and the size
+ * they were decoded at and bounded by pixel bytes. It sits in front
+ * of the HTTP cache so going back to a view doesn't decode again. */
+GtImageCache* gt_image_cache_new(guint64 max_size);
+GdkPixbuf*    gt_image_cache_lookup(GtImageCache* self, const gchar* uri, gint width, gint height);
+void          gt_image_cache_insert(GtImageCache* self, const gchar* uri, gint width, gint height, GdkPixbuf* pixbuf, guint ttl);
+GVariant*     gt_image_cache_get_stats(GtImageCache* self);
+
+G_END_DECLS
+
+#endif
@@ -19,15 +19,33 @@
 #include "gt-item-container.h"
 #include "utils.h"
 #include "gt-win.h"
+#include "gt-app.h"
+#include "gt-http-replay.h"
 #include <glib/gi18n.h>
 
 #define TAG "GtItemContainer"
 #include "gnome-twitch/gt-log.h"
 
+/* NOTE: How many rows outside the viewport still count as in view, so
+ * previews are there by the time they're scrolled to */
+#define IN_VIEW_MARGIN_ROWS 1
+
+/* NOTE: How many rows outside the viewport before an item is taken out
+ * of view again, which cancels its preview download and drops its
+ * pixbuf. Well clear of the margin above so small scrolls back and
+ * forth don't thrash */
+#define OUT_OF_VIEW_MARGIN_ROWS 6
+
+/* NOTE: How many rows of children are kept above and below the
+ * viewport, so there is something to show while they're rebound */
+#define OVERSCAN_ROWS 2
+
 typedef struct
 {
     GtkWidget* item_scroll;
     GtkWidget* item_flow;
+    GtkWidget* top_spacer;
+    GtkWidget* bottom_spacer;
     GtkWidget* fetching_label;
     GtkWidget* empty_label;
     GtkWidget* empty_sub_label;
@@ -48,9 +66,34 @@ typedef struct
 
     GtItemContainerProperties props;
 
-    GHashTable* items;
+    /* NOTE: Only the children needed to fill the viewport and the
+     * overscan rows exist, the spacers stand in for the rest. They
+     * are rebound to other items as the view is scrolled. */
+    GPtrArray* items; /* NOTE: Owns the items, in the order they were added */
+    GPtrArray* shown_items; /* NOTE: Filtered and sorted */
+    GHashTable* item_index; /* NOTE: Maps every item to its position in shown_items plus one, or NULL if filtered out */
+    gboolean shown_dirty;
+    GPtrArray* children; /* NOTE: Bound to shown_items from first_shown onwards */
+    guint first_shown;
+    guint columns;
+    gint row_height;
+    gint child_min_width;
+    GHashTable* in_view_items;
+
+    GtItemContainerFilterFunc filter_func;
+    gpointer filter_udata;
+    GCompareDataFunc sort_func;
+    gpointer sort_udata;
+
     gboolean fetching_items;
 
+    /* NOTE: Used to time how long it takes to fill the container */
+    gint64 fetch_start_time;
+    gboolean first_item_shown;
+    GHashTable* pending_previews;
+
+    guint layout_id;
+
     GdkRectangle* alloc;
 } GtItemContainerPrivate;
 
@@ -65,6 +108,360 @@ enum
 
 static GParamSpec* props[NUM_PROPS];
 
+static void
+log_previews_shown(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    if (priv->fetch_start_time == 0 || !priv->first_item_shown
+        || g_hash_table_size(priv->pending_previews) > 0)
+    {
+        return;
+    }
+
+    MESSAGE("All previews shown for '%s' after '%.2f' ms", G_OBJECT_TYPE_NAME(self),
+        (g_get_monotonic_time() - priv->fetch_start_time) / 1000.0);
+
+    if (GT_IS_HTTP_REPLAY(main_app->http))
+    {
+        guint64 requests;
+        guint64 bytes;
+
+        g_object_get(main_app->http, "requests", &requests, "bytes", &bytes, NULL);
+
+        MESSAGE("Replayed '%" G_GUINT64_FORMAT "' requests with '%" G_GUINT64_FORMAT "' bytes so far",
+            requests, bytes);
+    }
+
+    priv->fetch_start_time = 0;
+}
+
+static void
+item_updating_cb(GObject* item,
+    GParamSpec* pspec, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(udata));
+
+    GtItemContainer* self = GT_ITEM_CONTAINER(udata);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    gboolean updating;
+
+    g_object_get(item, "updating", &updating, NULL);
+
+    if (updating)
+        return;
+
+    g_signal_handlers_disconnect_by_func(item, item_updating_cb, self);
+    g_hash_table_remove(priv->pending_previews, item);
+
+    log_previews_shown(self);
+}
+
+static void
+track_item(GtItemContainer* self, gpointer item)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    gboolean updating = FALSE;
+
+    if (priv->fetch_start_time == 0)
+        return;
+
+    if (!priv->first_item_shown)
+    {
+        MESSAGE("First item shown for '%s' after '%.2f' ms", G_OBJECT_TYPE_NAME(self),
+            (g_get_monotonic_time() - priv->fetch_start_time) / 1000.0);
+
+        priv->first_item_shown = TRUE;
+    }
+
+    /* NOTE: Not every item has a preview, only wait for those that do */
+    if (!G_IS_OBJECT(item) || !g_object_class_find_property(G_OBJECT_GET_CLASS(item), "updating"))
+        return;
+
+    g_object_get(item, "updating", &updating, NULL);
+
+    if (!updating)
+        return;
+
+    g_signal_connect(item, "notify::updating", G_CALLBACK(item_updating_cb), self);
+    g_hash_table_add(priv->pending_previews, item);
+}
+
+static void
+untrack_items(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GHashTableIter iter;
+    gpointer item;
+
+    g_hash_table_iter_init(&iter, priv->pending_previews);
+    while (g_hash_table_iter_next(&iter, &item, NULL))
+        g_signal_handlers_disconnect_by_func(item, item_updating_cb, self);
+
+    g_hash_table_remove_all(priv->pending_previews);
+}
+
+static gint
+get_child_width(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    return GT_ITEM_CONTAINER_GET_CLASS(self)->get_container_properties ?
+        priv->props.child_width : priv->child_width;
+}
+
+static gint
+get_row_height(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    /* NOTE: Guess until the first child has been allocated */
+    if (priv->row_height > 0)
+        return priv->row_height;
+
+    return MAX(GT_ITEM_CONTAINER_GET_CLASS(self)->get_container_properties ?
+        priv->props.child_height : priv->child_height, 1);
+}
+
+static gint
+compare_items_cb(gconstpointer a, gconstpointer b, gpointer udata)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(udata);
+
+    return priv->sort_func(*((gpointer*) a), *((gpointer*) b), priv->sort_udata);
+}
+
+static void
+rebuild_shown_items(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GHashTableIter iter;
+
+    g_ptr_array_set_size(priv->shown_items, 0);
+
+    for (guint i = 0; i < priv->items->len; i++)
+    {
+        gpointer item = g_ptr_array_index(priv->items, i);
+
+        if (!priv->filter_func || priv->filter_func(item, priv->filter_udata))
+            g_ptr_array_add(priv->shown_items, item);
+    }
+
+    if (priv->sort_func)
+        g_ptr_array_sort_with_data(priv->shown_items, compare_items_cb, self);
+
+    g_hash_table_iter_init(&iter, priv->item_index);
+    while (g_hash_table_iter_next(&iter, NULL, NULL))
+        g_hash_table_iter_replace(&iter, NULL);
+
+    for (guint i = 0; i < priv->shown_items->len; i++)
+        g_hash_table_insert(priv->item_index, g_ptr_array_index(priv->shown_items, i), GUINT_TO_POINTER(i + 1));
+
+    priv->shown_dirty = FALSE;
+}
+
+/* NOTE: Items that want to know whether they're shown have an
+ * 'in-view' property, e.g. to hold off on downloading previews and to
+ * let go of them again once scrolled far away */
+static void
+update_items_in_view(GtItemContainer* self, guint first_row, guint last_row)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    guint near_first = (first_row > IN_VIEW_MARGIN_ROWS ? first_row - IN_VIEW_MARGIN_ROWS : 0)*priv->columns;
+    guint near_last = MIN((last_row + IN_VIEW_MARGIN_ROWS)*priv->columns, priv->shown_items->len);
+    guint far_first = (first_row > OUT_OF_VIEW_MARGIN_ROWS ? first_row - OUT_OF_VIEW_MARGIN_ROWS : 0)*priv->columns;
+    guint far_last = (last_row + OUT_OF_VIEW_MARGIN_ROWS)*priv->columns;
+    GHashTableIter iter;
+    gpointer item;
+
+    for (guint i = near_first; i < near_last; i++)
+    {
+        item = g_ptr_array_index(priv->shown_items, i);
+
+        if (!G_IS_OBJECT(item) || !g_object_class_find_property(G_OBJECT_GET_CLASS(item), "in-view"))
+            continue;
+
+        g_object_set(item, "in-view", TRUE, NULL);
+        g_hash_table_add(priv->in_view_items, item);
+    }
+
+    /* NOTE: In between the margins they're left as they are */
+    g_hash_table_iter_init(&iter, priv->in_view_items);
+    while (g_hash_table_iter_next(&iter, &item, NULL))
+    {
+        guint pos = GPOINTER_TO_UINT(g_hash_table_lookup(priv->item_index, item));
+
+        /* NOTE: Zero means it's been filtered out */
+        if (pos > 0 && pos - 1 >= far_first && pos - 1 < far_last)
+            continue;
+
+        g_object_set(item, "in-view", FALSE, NULL);
+        g_hash_table_iter_remove(&iter);
+    }
+}
+
+static void
+release_items_in_view(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GHashTableIter iter;
+    gpointer item;
+
+    g_hash_table_iter_init(&iter, priv->in_view_items);
+    while (g_hash_table_iter_next(&iter, &item, NULL))
+        g_object_set(item, "in-view", FALSE, NULL);
+
+    g_hash_table_remove_all(priv->in_view_items);
+}
+
+static void
+bind_child(GtItemContainer* self, guint pos, gpointer item)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GtItemContainerClass* klass = GT_ITEM_CONTAINER_GET_CLASS(self);
+    GtkWidget* child = pos < priv->children->len ? g_ptr_array_index(priv->children, pos) : NULL;
+
+    if (child && g_object_get_data(G_OBJECT(child), "item") == item)
+        return;
+
+    if (child && klass->bind_child)
+        klass->bind_child(self, child, item);
+    else
+    {
+        /* NOTE: Can't be rebound, so replace it */
+        if (child)
+            gtk_container_remove(GTK_CONTAINER(priv->item_flow), child);
+
+        child = klass->create_child(self, item);
+
+        gtk_flow_box_insert(GTK_FLOW_BOX(priv->item_flow), child, pos);
+
+        if (pos < priv->children->len)
+            g_ptr_array_index(priv->children, pos) = child;
+        else
+            g_ptr_array_add(priv->children, child);
+
+        if (priv->child_min_width == 0)
+            gtk_widget_get_preferred_width(child, &priv->child_min_width, NULL);
+    }
+
+    g_object_set_data(G_OBJECT(child), "item", item);
+}
+
+static void
+update_layout(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(priv->item_scroll));
+    gint width = gtk_widget_get_allocated_width(priv->item_scroll);
+    gint row_height = get_row_height(self);
+    gdouble value = gtk_adjustment_get_value(vadj);
+    gdouble page_size = gtk_adjustment_get_page_size(vadj);
+    guint columns = MAX(width / MAX(get_child_width(self), priv->child_min_width), 1);
+    guint rows;
+    guint first_row;
+    guint last_row;
+    guint visible_first_row;
+    guint visible_last_row;
+    guint first;
+    guint count;
+
+    if (priv->shown_dirty)
+        rebuild_shown_items(self);
+
+    rows = (priv->shown_items->len + columns - 1) / columns;
+
+    if (page_size < 1)
+        page_size = gtk_widget_get_allocated_height(GTK_WIDGET(self));
+
+    visible_first_row = MIN((guint) (value / row_height), rows);
+    visible_last_row = MIN((guint) ((value + page_size) / row_height) + 1, rows);
+
+    first_row = visible_first_row > OVERSCAN_ROWS ? visible_first_row - OVERSCAN_ROWS : 0;
+    last_row = MIN(visible_last_row + OVERSCAN_ROWS, rows);
+
+    first = MIN(first_row*columns, priv->shown_items->len);
+    count = MIN(last_row*columns, priv->shown_items->len) - first;
+
+    /* NOTE: The spacers are sized in whole rows, so every row of
+     * children has to be full, except for the last one */
+    if (columns != priv->columns)
+    {
+        gtk_flow_box_set_max_children_per_line(GTK_FLOW_BOX(priv->item_flow), columns);
+        gtk_flow_box_set_min_children_per_line(GTK_FLOW_BOX(priv->item_flow), columns);
+
+        priv->columns = columns;
+    }
+
+    gtk_widget_set_size_request(priv->top_spacer, -1, first_row*row_height);
+    gtk_widget_set_size_request(priv->bottom_spacer, -1, (rows - last_row)*row_height);
+
+    while (priv->children->len > count)
+    {
+        GtkWidget* child = g_ptr_array_index(priv->children, priv->children->len - 1);
+
+        g_ptr_array_remove_index(priv->children, priv->children->len - 1);
+        gtk_container_remove(GTK_CONTAINER(priv->item_flow), child);
+    }
+
+    for (guint i = 0; i < count; i++)
+        bind_child(self, i, g_ptr_array_index(priv->shown_items, first + i));
+
+    priv->first_shown = first;
+
+    update_items_in_view(self, visible_first_row, visible_last_row);
+}
+
+static gboolean
+update_layout_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_ITEM_CONTAINER(udata), G_SOURCE_REMOVE);
+
+    GtItemContainer* self = GT_ITEM_CONTAINER(udata);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    priv->layout_id = 0;
+
+    /* NOTE: Done again once mapped, the allocation is stale until then */
+    if (!gtk_widget_get_mapped(GTK_WIDGET(self)))
+        return G_SOURCE_REMOVE;
+
+    update_layout(self);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* NOTE: Runs before the next frame is drawn, so scrolling doesn't
+ * show the spacers */
+static void
+queue_update_layout(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    if (priv->layout_id == 0)
+    {
+        priv->layout_id = g_idle_add_full(G_PRIORITY_HIGH_IDLE, update_layout_cb,
+            g_object_ref(self), g_object_unref);
+    }
+}
+
+static void
+item_flow_allocated_cb(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    if (priv->children->len > 0)
+    {
+        gint row_height = gtk_widget_get_allocated_height(g_ptr_array_index(priv->children, 0)) +
+            gtk_flow_box_get_row_spacing(GTK_FLOW_BOX(priv->item_flow));
+
+        if (row_height > 1)
+            priv->row_height = row_height;
+    }
+
+    queue_update_layout(self);
+}
+
 static void
 fetch_items(GtItemContainer* self)
 {
@@ -74,7 +471,7 @@ fetch_items(GtItemContainer* self)
 
     GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(
         GTK_SCROLLED_WINDOW(priv->item_scroll));
-    gint num_items = g_hash_table_size(priv->items);
+    gint num_items = priv->items->len;
 
     guint height = num_items == 0 ?
         gtk_widget_get_allocated_height(GTK_WIDGET(self)) :
@@ -93,6 +490,12 @@ fetch_items(GtItemContainer* self)
     priv->fetching_items = TRUE;
     g_object_notify_by_pspec(G_OBJECT(self), props[PROP_FETCHING_ITEMS]);
 
+    if (num_items == 0)
+    {
+        priv->fetch_start_time = g_get_monotonic_time();
+        priv->first_item_shown = FALSE;
+    }
+
     gtk_stack_set_visible_child(GTK_STACK(self), priv->item_scroll);
 
     guint columns = width / (GT_ITEM_CONTAINER_GET_CLASS(self)->get_container_properties ? priv->props.child_width : priv->child_width);
@@ -260,9 +663,50 @@ constructed(GObject* obj)
 
 }
 
+static void
+dispose(GObject* obj)
+{
+    GtItemContainer* self = GT_ITEM_CONTAINER(obj);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    if (priv->pending_previews)
+    {
+        untrack_items(self);
+        g_clear_pointer(&priv->pending_previews, g_hash_table_unref);
+    }
+
+    if (priv->layout_id > 0)
+    {
+        g_source_remove(priv->layout_id);
+        priv->layout_id = 0;
+    }
+
+    if (priv->in_view_items)
+        release_items_in_view(self);
+
+    G_OBJECT_CLASS(gt_item_container_parent_class)->dispose(obj);
+}
+
+static void
+finalize(GObject* obj)
+{
+    GtItemContainer* self = GT_ITEM_CONTAINER(obj);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    g_ptr_array_unref(priv->children);
+    g_ptr_array_unref(priv->shown_items);
+    g_hash_table_unref(priv->item_index);
+    g_hash_table_unref(priv->in_view_items);
+    g_ptr_array_unref(priv->items);
+
+    G_OBJECT_CLASS(gt_item_container_parent_class)->finalize(obj);
+}
+
 static void
 gt_item_container_class_init(GtItemContainerClass* klass)
 {
+    G_OBJECT_CLASS(klass)->dispose = dispose;
+    G_OBJECT_CLASS(klass)->finalize = finalize;
     G_OBJECT_CLASS(klass)->set_property = set_property;
     G_OBJECT_CLASS(klass)->get_property = get_property;
     G_OBJECT_CLASS(klass)->constructed = constructed;
@@ -278,6 +722,8 @@ gt_item_container_class_init(GtItemContainerClass* klass)
 
     gtk_widget_class_bind_template_child_private(GTK_WIDGET_CLASS(klass), GtItemContainer, item_flow);
     gtk_widget_class_bind_template_child_private(GTK_WIDGET_CLASS(klass), GtItemContainer, item_scroll);
+    gtk_widget_class_bind_template_child_private(GTK_WIDGET_CLASS(klass), GtItemContainer, top_spacer);
+    gtk_widget_class_bind_template_child_private(GTK_WIDGET_CLASS(klass), GtItemContainer, bottom_spacer);
     gtk_widget_class_bind_template_child_private(GTK_WIDGET_CLASS(klass), GtItemContainer, empty_label);
     gtk_widget_class_bind_template_child_private(GTK_WIDGET_CLASS(klass), GtItemContainer, empty_sub_label);
     gtk_widget_class_bind_template_child_private(GTK_WIDGET_CLASS(klass), GtItemContainer, empty_image);
@@ -292,8 +738,14 @@ static void
 gt_item_container_init(GtItemContainer* self)
 {
     GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
-
-    priv->items = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GtkAdjustment* vadj = NULL;
+
+    priv->items = g_ptr_array_new_with_free_func(g_object_unref);
+    priv->shown_items = g_ptr_array_new();
+    priv->item_index = g_hash_table_new(g_direct_hash, g_direct_equal);
+    priv->children = g_ptr_array_new();
+    priv->in_view_items = g_hash_table_new(g_direct_hash, g_direct_equal);
+    priv->pending_previews = g_hash_table_new(g_direct_hash, g_direct_equal);
     priv->alloc = g_new(GdkRectangle, 1);
     priv->alloc->width = 0;
     priv->alloc->height = 0;
@@ -302,16 +754,71 @@ gt_item_container_init(GtItemContainer* self)
 
     g_signal_connect_swapped(priv->reload_button, "clicked",
         G_CALLBACK(gt_item_container_refresh), self);
+
+    vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(priv->item_scroll));
+
+    g_signal_connect_object(vadj, "value-changed", G_CALLBACK(queue_update_layout), self, G_CONNECT_SWAPPED);
+    g_signal_connect_object(vadj, "changed", G_CALLBACK(queue_update_layout), self, G_CONNECT_SWAPPED);
+    g_signal_connect_object(priv->item_flow, "size-allocate", G_CALLBACK(item_flow_allocated_cb), self, G_CONNECT_SWAPPED);
+    g_signal_connect_swapped(self, "map", G_CALLBACK(queue_update_layout), self);
 }
 
-GtkWidget*
-gt_item_container_get_flow_box(GtItemContainer* self)
+/* NOTE: Channels are shared between views, so the same item can show
+ * up twice in one listing when the pages shift under us. Only the
+ * first one is kept, the reference passed for the other one is
+ * dropped like it would have been. */
+static void
+add_item(GtItemContainer* self, gpointer item)
 {
-    RETURN_VAL_IF_FAIL(GT_IS_ITEM_CONTAINER(self), NULL);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    if (g_hash_table_contains(priv->item_index, item))
+    {
+        TRACE("Skipping duplicate item");
+
+        g_object_unref(g_object_ref_sink(item));
+
+        return;
+    }
+
+    g_ptr_array_add(priv->items, g_object_ref_sink(item));
 
+    /* NOTE: Nothing to filter or sort, it just goes on the end */
+    if (!priv->filter_func && !priv->sort_func && !priv->shown_dirty)
+    {
+        g_ptr_array_add(priv->shown_items, item);
+        g_hash_table_insert(priv->item_index, item, GUINT_TO_POINTER(priv->shown_items->len));
+    }
+    else
+    {
+        g_hash_table_insert(priv->item_index, item, NULL);
+        priv->shown_dirty = TRUE;
+    }
+
+    track_item(self, item);
+
+    queue_update_layout(self);
+}
+
+static void
+clear_items(GtItemContainer* self)
+{
     GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
 
-    return priv->item_flow;
+    untrack_items(self);
+    release_items_in_view(self);
+
+    utils_container_clear(GTK_CONTAINER(priv->item_flow));
+    g_ptr_array_set_size(priv->children, 0);
+
+    g_hash_table_remove_all(priv->item_index);
+    g_ptr_array_set_size(priv->shown_items, 0);
+    g_ptr_array_set_size(priv->items, 0);
+
+    priv->shown_dirty = FALSE;
+    priv->first_shown = 0;
+
+    queue_update_layout(self);
 }
 
 void
@@ -323,10 +830,10 @@ gt_item_container_append_item(GtItemContainer* self, gpointer item)
     DEBUG("Appending item");
 
     GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
-    GtkWidget* child = GT_ITEM_CONTAINER_GET_CLASS(self)->create_child(self, item);
 
-    g_hash_table_insert(priv->items, item, child);
-    gtk_container_add(GTK_CONTAINER(priv->item_flow), child);
+    add_item(self, item);
+
+    log_previews_shown(self);
 
     gtk_stack_set_visible_child(GTK_STACK(self), priv->item_scroll);
 }
@@ -338,15 +845,13 @@ gt_item_container_append_items(GtItemContainer* self, GList* items)
 
     DEBUG("Appending items with list length '%d'", g_list_length(items));
 
-    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
-
     for (GList* l = items; l != NULL; l = l->next)
     {
-        GtkWidget* child = GT_ITEM_CONTAINER_GET_CLASS(self)->create_child(self, l->data);
-
-        g_hash_table_insert(priv->items, l->data, child);
-        gtk_container_add(GTK_CONTAINER(priv->item_flow), child);
+        add_item(self, l->data);
     }
+
+    /* NOTE: None of them might have had a preview to wait for */
+    log_previews_shown(self);
 }
 
 void
@@ -356,21 +861,14 @@ gt_item_container_set_items(GtItemContainer* self, GList* items)
 
     DEBUG("Settings items with list length '%d'", g_list_length(items));
 
-    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
-
-    utils_container_clear(GTK_CONTAINER(priv->item_flow));
-
-    /* NOTE: We don't call any free funcs here because all data is
-     * owned by the children */
-    g_hash_table_steal_all(priv->items);
+    clear_items(self);
 
     for (GList* l = items; l != NULL; l = l->next)
     {
-        GtkWidget* child = GT_ITEM_CONTAINER_GET_CLASS(self)->create_child(self, l->data);
-
-        g_hash_table_insert(priv->items, l->data, child);
-        gtk_container_add(GTK_CONTAINER(priv->item_flow), child);
+        add_item(self, l->data);
     }
+
+    log_previews_shown(self);
 }
 
 void
@@ -383,18 +881,85 @@ gt_item_container_remove_item(GtItemContainer* self, gpointer item)
 
     GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
 
-    GtkWidget* child = g_hash_table_lookup(priv->items, item);
+    RETURN_IF_FAIL(g_hash_table_contains(priv->item_index, item));
 
-    RETURN_IF_FAIL(GTK_IS_WIDGET(child));
+    if (g_hash_table_remove(priv->pending_previews, item))
+        g_signal_handlers_disconnect_by_func(item, item_updating_cb, self);
 
-    g_hash_table_steal(priv->items, item);
+    if (g_hash_table_remove(priv->in_view_items, item))
+        g_object_set(item, "in-view", FALSE, NULL);
 
-    gtk_container_remove(GTK_CONTAINER(priv->item_flow), child);
+    /* NOTE: The positions after it are fixed up with the next layout,
+     * its child keeps it alive until then */
+    if (g_hash_table_lookup(priv->item_index, item))
+    {
+        g_ptr_array_remove(priv->shown_items, item);
+        priv->shown_dirty = TRUE;
+    }
+
+    g_hash_table_remove(priv->item_index, item);
+    g_ptr_array_remove(priv->items, item);
+
+    queue_update_layout(self);
 
-    if (g_hash_table_size(priv->items) == 0)
+    if (priv->items->len == 0)
         gtk_stack_set_visible_child(GTK_STACK(self), priv->empty_box);
 }
 
+void
+gt_item_container_set_filter_func(GtItemContainer* self,
+    GtItemContainerFilterFunc func, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(self));
+
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    priv->filter_func = func;
+    priv->filter_udata = udata;
+
+    gt_item_container_invalidate_filter(self);
+}
+
+void
+gt_item_container_set_sort_func(GtItemContainer* self,
+    GCompareDataFunc func, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(self));
+
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    priv->sort_func = func;
+    priv->sort_udata = udata;
+
+    gt_item_container_invalidate_sort(self);
+}
+
+/* NOTE: Items are filtered and sorted with the next layout, so
+ * invalidating a lot at once is cheap */
+void
+gt_item_container_invalidate_filter(GtItemContainer* self)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(self));
+
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    priv->shown_dirty = TRUE;
+
+    queue_update_layout(self);
+}
+
+void
+gt_item_container_invalidate_sort(GtItemContainer* self)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(self));
+
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    priv->shown_dirty = TRUE;
+
+    queue_update_layout(self);
+}
+
 void
 gt_item_container_set_fetching_items(GtItemContainer* self, gboolean fetching_items)
 {
@@ -406,7 +971,7 @@ gt_item_container_set_fetching_items(GtItemContainer* self, gboolean fetching_it
 
     if (!fetching_items)
     {
-        if (g_hash_table_size(priv->items) == 0)
+        if (priv->items->len == 0)
             gtk_stack_set_visible_child(GTK_STACK(self), priv->empty_box);
         else
             gtk_stack_set_visible_child(GTK_STACK(self), priv->item_scroll);
@@ -425,10 +990,7 @@ gt_item_container_refresh(GtItemContainer* self)
 
     DEBUG("Refreshing");
 
-    utils_container_clear(GTK_CONTAINER(priv->item_flow));
-
-    /* NOTE: No need to free items as they are owned by the children */
-    g_hash_table_steal_all(priv->items);
+    clear_items(self);
 
     fetch_items(self);
 }
@@ -39,6 +39,8 @@ typedef struct
     gchar* fetching_label_text;
 } GtItemContainerProperties;
 
+typedef gboolean (*GtItemContainerFilterFunc) (gpointer item, gpointer udata);
+
 struct _GtItemContainerClass
 {
     GtkStackClass parent_class;
@@ -49,13 +51,15 @@ struct _GtItemContainerClass
         gchar** error_label_text, gchar** fetching_label_text);
     void (*get_container_properties) (GtItemContainer* item_container, GtItemContainerProperties* props);
     GtkWidget* (*create_child) (GtItemContainer* item_container, gpointer data);
+    /* NOTE: Children are recycled as the view is scrolled. If this isn't implemented they
+     are recreated with create_child instead. */
+    void (*bind_child) (GtItemContainer* item_container, GtkWidget* child, gpointer data);
     void (*activate_child) (GtItemContainer* item_container, gpointer child);
     /* NOTE: This will be called before the container is cleared. This can be useful if you need
      to do something like disconnect signals from each child. */
     void (*request_extra_items) (GtItemContainer* item_container, gint amount, gint offset);
 };
 
-GtkWidget* gt_item_container_get_flow_box(GtItemContainer* self); /* NOTE: Should only be used by children*/
 void gt_item_container_refresh(GtItemContainer* self);
 void gt_item_container_append_item(GtItemContainer* self, gpointer item);
 void gt_item_container_append_items(GtItemContainer* self, GList* items);
@@ -63,6 +67,10 @@ void gt_item_container_set_items(GtItemContainer* self, GList* items);
 void gt_item_container_set_fetching_items(GtItemContainer* self, gboolean fetching_items);
 void gt_item_container_remove_item(GtItemContainer* self, gpointer item);
 void gt_item_container_show_error(GtItemContainer* self, const GError* error);
+void gt_item_container_set_filter_func(GtItemContainer* self, GtItemContainerFilterFunc func, gpointer udata);
+void gt_item_container_set_sort_func(GtItemContainer* self, GCompareDataFunc func, gpointer udata);
+void gt_item_container_invalidate_filter(GtItemContainer* self);
+void gt_item_container_invalidate_sort(GtItemContainer* self);
 
 G_END_DECLS;
 
@@ -111,6 +111,8 @@ typedef struct
     guint mouse_moved_handler_id;
 
     guint mouse_source;
+
+    gint64 open_time; /* NOTE: Used to time how long it takes until the first frame */
 } GtPlayerPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GtPlayer, gt_player, GTK_TYPE_STACK)
@@ -477,12 +479,23 @@ player_backend_state_cb(GObject* source,
     GtPlayerPrivate* priv = gt_player_get_instance_private(self);
     GtPlayerBackendState state = gt_player_backend_get_state(priv->backend);
 
+    /* NOTE: Let the HTTP layer hold back background downloads while
+     * the backend is fetching segments */
+    g_object_set(main_app->http, "playback-active",
+        state != GT_PLAYER_BACKEND_STATE_STOPPED && state != GT_PLAYER_BACKEND_STATE_PAUSED, NULL);
+
     switch (state)
     {
         /* TODO: Update play/pause button state */
         case GT_PLAYER_BACKEND_STATE_PLAYING:
             gtk_revealer_set_reveal_child(GTK_REVEALER(priv->buffer_revealer), FALSE);
 
+            if (priv->open_time > 0)
+            {
+                MESSAGE("First frame after '%.2f' ms", (g_get_monotonic_time() - priv->open_time) / 1000.0);
+                priv->open_time = 0;
+            }
+
             priv->paused = FALSE;
             gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(priv->toggle_paused_button), !priv->paused);
             break;
@@ -890,8 +903,12 @@ set_property(GObject* obj,
             update_muted(self);
             break;
         case PROP_CHANNEL:
+            if (priv->channel)
+                g_object_set(priv->channel, "watching", FALSE, NULL);
             g_clear_object(&priv->channel);
             priv->channel = g_value_dup_object(val);
+            if (priv->channel)
+                g_object_set(priv->channel, "watching", TRUE, NULL);
             break;
         case PROP_VOD:
             g_clear_object(&priv->vod);
@@ -1199,6 +1216,8 @@ plugin_unloaded_cb(PeasEngine* engine,
 
         g_clear_object(&priv->backend);
 
+        g_object_set(main_app->http, "playback-active", FALSE, NULL);
+
         g_boxed_free(PEAS_TYPE_PLUGIN_INFO, priv->backend_info);
         priv->backend_info = NULL;
     }
@@ -1661,6 +1680,8 @@ gt_player_open_channel(GtPlayer* self, GtChannel* chan)
     const gchar* id = gt_channel_get_id(chan);
     g_autofree gchar* uri = NULL;
 
+    priv->open_time = g_get_monotonic_time();
+
     utils_refresh_cancellable(&priv->cancel);
 
     g_object_set(self, "channel", chan, NULL);
@@ -1716,6 +1737,8 @@ gt_player_open_vod(GtPlayer* self, GtVOD* vod)
     g_autofree gchar* uri = NULL;
     const gchar* vod_id = NULL;
 
+    priv->open_time = g_get_monotonic_time();
+
     g_clear_object(&priv->vod);
     priv->vod = g_object_ref(vod);
     g_object_notify_by_pspec(G_OBJECT(self), props[PROP_VOD]);
@@ -9,24 +9,70 @@
 
 typedef struct
 {
-    gchar* filepath;
-    gchar* image_filetype;
+    GtCache* cache;
     SoupSession* soup;
     GMutex mutex;
+    gint decode_width;
+    gint decode_height;
 } GtResourceDownloaderPrivate;
 
 typedef struct
 {
     gchar* uri;
-    gchar* name;
     ResourceDownloaderFunc cb;
     gpointer udata;
     GtResourceDownloader* self;
     SoupMessage* msg;
     GInputStream* istream;
+    GBytes* bytes;
+    gchar* etag;
+    GDateTime* last_updated;
+    GDateTime* expiry;
+    gboolean returned_cached; /* NOTE: The caller already has the cached image */
 } ResourceData; /* FIXME: Better name? */
 
-static GThreadPool* dl_pool;
+typedef struct
+{
+    GtCache* cache;
+    gchar* uri;
+    GBytes* bytes;
+    gchar* etag;
+    GDateTime* last_updated;
+    GDateTime* expiry;
+} WriteData;
+
+/* NOTE: Images go through three stages. Responses are read
+ * asynchronously on the main context, decoded on decode_pool, which is
+ * bounded to the number of cores, and stored in the cache on
+ * write_pool, so a slow stage doesn't occupy the threads of another */
+typedef enum
+{
+    STAGE_READ,
+    STAGE_DECODE,
+    STAGE_WRITE,
+    NUM_STAGES,
+} Stage;
+
+typedef struct
+{
+    gint depth; /* NOTE: Queued or in progress */
+    gint max_depth;
+    gint processed;
+} StageStats;
+
+static const gchar* STAGE_NAMES[] =
+{
+    "downloader-read",
+    "downloader-decode",
+    "downloader-write",
+};
+
+G_STATIC_ASSERT(G_N_ELEMENTS(STAGE_NAMES) == NUM_STAGES);
+
+static StageStats stage_stats[NUM_STAGES];
+
+static GThreadPool* decode_pool;
+static GThreadPool* write_pool;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GtResourceDownloader, gt_resource_downloader, G_TYPE_OBJECT);
 
@@ -42,141 +88,318 @@ resource_data_free(ResourceData* data)
     if (!data) return;
 
     g_free(data->uri);
-    g_free(data->name);
     g_object_unref(data->self);
     g_object_unref(data->msg);
-    g_object_unref(data->istream);
+    g_clear_object(&data->istream);
+    g_clear_pointer(&data->bytes, g_bytes_unref);
+    g_free(data->etag);
+    g_clear_pointer(&data->last_updated, g_date_time_unref);
+    g_clear_pointer(&data->expiry, g_date_time_unref);
 
     g_slice_free(ResourceData, data);
 }
 
-/* FIXME: Throw error */
-static GdkPixbuf*
-download_image(GtResourceDownloader* self,
-    const gchar* uri, const gchar* name,
-    SoupMessage* msg, GInputStream* istream,
-    gboolean* from_file, GError** error)
+static void
+write_data_free(WriteData* data)
 {
-    RETURN_VAL_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self), NULL);
-    RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
-    RETURN_VAL_IF_FAIL(SOUP_IS_MESSAGE(msg), NULL);
-    RETURN_VAL_IF_FAIL(G_IS_INPUT_STREAM(istream), NULL);
+    if (!data) return;
+
+    g_object_unref(data->cache);
+    g_free(data->uri);
+    g_bytes_unref(data->bytes);
+    g_free(data->etag);
+    g_clear_pointer(&data->last_updated, g_date_time_unref);
+    g_clear_pointer(&data->expiry, g_date_time_unref);
 
+    g_slice_free(WriteData, data);
+}
+
+static void
+stage_enter(Stage stage)
+{
+    gint depth = g_atomic_int_add(&stage_stats[stage].depth, 1) + 1;
+    gint max_depth = g_atomic_int_get(&stage_stats[stage].max_depth);
+
+    while (depth > max_depth &&
+        !g_atomic_int_compare_and_exchange(&stage_stats[stage].max_depth, max_depth, depth))
+    {
+        max_depth = g_atomic_int_get(&stage_stats[stage].max_depth);
+    }
+}
+
+static void
+stage_leave(Stage stage)
+{
+    g_atomic_int_add(&stage_stats[stage].depth, -1);
+    g_atomic_int_inc(&stage_stats[stage].processed);
+}
+
+static GDateTime*
+parse_http_time(const gchar* time)
+{
+    g_autoptr(SoupDate) soup_date = NULL;
+
+    if (utils_str_empty(time))
+        return NULL;
+
+    if (!(soup_date = soup_date_new_from_string(time)))
+        return NULL;
+
+    return g_date_time_new_from_unix_utc(soup_date_to_time_t(soup_date));
+}
+
+static GBytes*
+read_all(GInputStream* istream, GError** error)
+{
+    g_autoptr(GOutputStream) ostream = g_memory_output_stream_new_resizable();
+
+    if (g_output_stream_splice(ostream, istream, G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET, NULL, error) < 0)
+        return NULL;
+
+    return g_memory_output_stream_steal_as_bytes(G_MEMORY_OUTPUT_STREAM(ostream));
+}
+
+static GBytes*
+read_cached_image(GtResourceDownloader* self, const gchar* uri)
+{
     GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
-    g_autofree gchar* filename = NULL;
-    gint64 file_timestamp = 0;
-    gboolean file_exists = FALSE;
-    g_autoptr(GdkPixbuf) ret = NULL;
+    g_autoptr(GInputStream) istream = NULL;
     g_autoptr(GError) err = NULL;
+    GBytes* ret = NULL;
 
-        /* NOTE: If we aren't supplied a filename, we'll just create one by hashing the uri */
-    if (utils_str_empty(name))
-    {
-        gchar hash_str[15];
-        guint hash = 0;
+    istream = gt_cache_get_data_stream(priv->cache, uri, &err);
 
-        hash = g_str_hash(uri); /* TODO: Replace this with murmur3 hash */
+    if (!err)
+        ret = read_all(istream, &err);
 
-        g_sprintf(hash_str, "%ud", hash);
+    if (err)
+        DEBUG("Unable to load cached image for uri '%s' because: %s", uri, err->message);
 
-        filename = g_build_filename(priv->filepath, hash_str, NULL);
-    }
+    return ret;
+}
+
+/* NOTE: Only ever scales down, an image that already fits is
+ * decoded as is */
+static void
+size_prepared_cb(GdkPixbufLoader* loader,
+    gint width, gint height, gpointer udata)
+{
+    GtResourceDownloaderPrivate* priv = udata;
+    gdouble scale = 1.0;
+
+    if (priv->decode_width > 0 && width > priv->decode_width)
+        scale = MIN(scale, (gdouble) priv->decode_width / width);
+
+    if (priv->decode_height > 0 && height > priv->decode_height)
+        scale = MIN(scale, (gdouble) priv->decode_height / height);
+
+    if (scale < 1.0)
+        gdk_pixbuf_loader_set_size(loader, MAX(width*scale, 1), MAX(height*scale, 1));
+}
+
+/* NOTE: Images larger than the size set with set_decode_size are
+ * scaled down while decoding so they are never held at full size */
+static GdkPixbuf*
+decode_image(GtResourceDownloader* self, const gchar* uri, GBytes* bytes, GError** error)
+{
+    GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
+    g_autoptr(GdkPixbufLoader) loader = gdk_pixbuf_loader_new();
+    g_autoptr(GdkPixbuf) ret = NULL;
+    g_autoptr(GError) err = NULL;
+
+    stage_enter(STAGE_DECODE);
+
+    g_signal_connect(loader, "size-prepared", G_CALLBACK(size_prepared_cb), priv);
+
+    /* NOTE: The loader has to be closed even if writing failed */
+    if (gdk_pixbuf_loader_write_bytes(loader, bytes, &err))
+        gdk_pixbuf_loader_close(loader, &err);
     else
-        filename = g_build_filename(priv->filepath, name, NULL);
+        gdk_pixbuf_loader_close(loader, NULL);
 
-    if (priv->filepath && (file_exists = g_file_test(filename, G_FILE_TEST_EXISTS)))
+    if (!err && gdk_pixbuf_loader_get_pixbuf(loader))
+        ret = g_object_ref(gdk_pixbuf_loader_get_pixbuf(loader));
+    else if (!err)
+        err = g_error_new(GDK_PIXBUF_ERROR, GDK_PIXBUF_ERROR_CORRUPT_IMAGE, "No image in data");
+
+    stage_leave(STAGE_DECODE);
+
+    if (err)
     {
-        file_timestamp = utils_timestamp_filename(filename, NULL);
+        WARNING("Unable to decode image from uri '%s' because: %s",
+            uri, err->message);
+
+        g_propagate_prefixed_error(error, g_steal_pointer(&err),
+            "Unable to decode image from uri '%s' because: ", uri);
+
+        return NULL;
     }
 
-    if (SOUP_STATUS_IS_SUCCESSFUL(msg->status_code))
+    return g_steal_pointer(&ret);
+}
+
+static void
+write_cb(WriteData* data,
+    gpointer udata)
+{
+    RETURN_IF_FAIL(data != NULL);
+
+    gt_cache_save_data(data->cache, data->uri, g_bytes_get_data(data->bytes, NULL),
+        g_bytes_get_size(data->bytes), data->last_updated, data->expiry, data->etag);
+
+    stage_leave(STAGE_WRITE);
+
+    write_data_free(data);
+}
+
+/* NOTE: Stores the response as is, it's only worth it if it can be
+ * validated later */
+static void
+queue_write(GtResourceDownloader* self, const gchar* uri, GBytes* bytes,
+    GDateTime* last_updated, GDateTime* expiry, const gchar* etag)
+{
+    GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
+    WriteData* data;
+
+    if (!priv->cache || (!last_updated && !etag) || g_bytes_get_size(bytes) == 0)
+        return;
+
+    data = g_slice_new0(WriteData);
+    data->cache = g_object_ref(priv->cache);
+    data->uri = g_strdup(uri);
+    data->bytes = g_bytes_ref(bytes);
+    data->etag = g_strdup(etag);
+    data->last_updated = last_updated ? g_date_time_ref(last_updated) : NULL;
+    data->expiry = expiry ? g_date_time_ref(expiry) : NULL;
+
+    stage_enter(STAGE_WRITE);
+
+    g_thread_pool_push(write_pool, data, NULL);
+}
+
+/* NOTE: Returns the image's bytes without decoding them. If the
+ * server says the cached copy is current those are returned and
+ * 'from_cache' is set, otherwise the response is read into memory and
+ * the same buffer is stored in the cache as is. */
+static GBytes*
+fetch_image(GtResourceDownloader* self,
+    const gchar* uri, SoupMessage* msg, GInputStream* istream,
+    gboolean* from_cache, GError** error)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self), NULL);
+    RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
+    RETURN_VAL_IF_FAIL(SOUP_IS_MESSAGE(msg), NULL);
+    RETURN_VAL_IF_FAIL(G_IS_INPUT_STREAM(istream), NULL);
+
+    GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
+    const gchar* etag = NULL;
+    g_autoptr(GDateTime) last_updated = NULL;
+    g_autoptr(GDateTime) expiry = NULL;
+    g_autoptr(GBytes) ret = NULL;
+    g_autoptr(GError) err = NULL;
+
+    if (from_cache) *from_cache = FALSE;
+
+    if (!SOUP_STATUS_IS_SUCCESSFUL(msg->status_code))
     {
-        const gchar* last_modified_str = NULL;
+        DEBUG("Unsuccessful return code '%d' from uri '%s'", msg->status_code, uri);
+
+        return NULL;
+    }
+
+    DEBUG("Successful return code from uri '%s'", uri);
 
-        DEBUG("Successful return code from uri '%s'", uri);
+    etag = soup_message_headers_get_one(msg->response_headers, "ETag");
+    last_updated = parse_http_time(soup_message_headers_get_one(msg->response_headers, "Last-Modified"));
+    expiry = parse_http_time(soup_message_headers_get_one(msg->response_headers, "Expires"));
 
-        last_modified_str = soup_message_headers_get_one(msg->response_headers, "Last-Modified");
+    if (!last_updated && !etag)
+        DEBUG("No 'Last-Modified' or 'ETag' header in response from uri '%s'", uri);
+    else if (priv->cache && !gt_cache_is_data_stale(priv->cache, uri, last_updated, etag))
+    {
+        DEBUG("No new image at uri '%s'", uri);
 
-        if (utils_str_empty(last_modified_str))
+        if ((ret = read_cached_image(self, uri)) != NULL)
         {
-            DEBUG("No 'Last-Modified' header in response from uri '%s'", uri);
+            if (from_cache) *from_cache = TRUE;
 
-            goto download;
+            return g_steal_pointer(&ret);
         }
-        else if (utils_http_full_date_to_timestamp(last_modified_str) < file_timestamp)
-        {
-            DEBUG("No new image at uri '%s'", uri);
+    }
 
-            if (file_exists)
-            {
-                DEBUG("Loading image from file '%s'", filename);
+    DEBUG("New image at uri '%s'", uri);
 
-                ret = gdk_pixbuf_new_from_file(filename, NULL);
+    stage_enter(STAGE_READ);
+    ret = read_all(istream, &err);
+    stage_leave(STAGE_READ);
 
-                if (from_file) *from_file = TRUE;
-            }
-            else
-            {
-                DEBUG("Image doesn't exist locally");
+    if (!ret)
+    {
+        WARNING("Unable to download image from uri '%s' because: %s",
+            uri, err->message);
 
-                goto download;
-            }
-        }
-        else
-        {
-        download:
-            DEBUG("New image at uri '%s'", uri);
-
-            ret = gdk_pixbuf_new_from_stream(istream, NULL, &err);
-
-            if (err)
-            {
-                WARNING("Unable to download image from uri '%s' because: %s",
-                    uri, err->message);
-
-                g_propagate_prefixed_error(error, g_steal_pointer(&err),
-                    "Unable to download image from uri '%s' because: ", uri);
-
-                return NULL;
-            }
-
-            if (priv->filepath && STRING_EQUALS(priv->image_filetype, GT_IMAGE_FILETYPE_JPEG))
-            {
-                gdk_pixbuf_save(ret, filename, priv->image_filetype,
-                    NULL, "quality", "100", NULL);
-            }
-            else if (priv->filepath)
-            {
-                gdk_pixbuf_save(ret, filename, priv->image_filetype,
-                    NULL, NULL);
-            }
-
-            if (from_file) *from_file = FALSE;
-        }
+        g_propagate_prefixed_error(error, g_steal_pointer(&err),
+            "Unable to download image from uri '%s' because: ", uri);
+
+        return NULL;
     }
 
+    queue_write(self, uri, ret, last_updated, expiry, etag);
+
     return g_steal_pointer(&ret);
 }
 
 static void
-download_cb(ResourceData* data,
+decode_cb(ResourceData* data,
     gpointer udata)
 {
     RETURN_IF_FAIL(data != NULL);
 
     g_autoptr(GdkPixbuf) ret = NULL;
     g_autoptr(GError) err = NULL;
-    gboolean from_file = FALSE;
 
-    ret = download_image(data->self, data->uri, data->name, data->msg,
-        data->istream, &from_file, &err);
+    ret = decode_image(data->self, data->uri, data->bytes, &err);
 
-    data->cb(from_file ? NULL : g_steal_pointer(&ret),
-        data->udata, g_steal_pointer(&err));
+    data->cb(g_steal_pointer(&ret), data->udata, g_steal_pointer(&err));
 
     resource_data_free(data);
 }
 
+static void
+read_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
+{
+    RETURN_IF_FAIL(G_IS_MEMORY_OUTPUT_STREAM(source));
+    RETURN_IF_FAIL(G_IS_ASYNC_RESULT(res));
+    RETURN_IF_FAIL(udata != NULL);
+
+    ResourceData* data = udata;
+    g_autoptr(GError) err = NULL;
+
+    g_output_stream_splice_finish(G_OUTPUT_STREAM(source), res, &err);
+
+    stage_leave(STAGE_READ);
+
+    if (err)
+    {
+        WARNING("Unable to download image from uri '%s' because: %s",
+            data->uri, err->message);
+
+        data->cb(NULL, data->udata, g_steal_pointer(&err));
+        resource_data_free(data);
+        g_object_unref(source);
+        return;
+    }
+
+    data->bytes = g_memory_output_stream_steal_as_bytes(G_MEMORY_OUTPUT_STREAM(source));
+
+    g_object_unref(source);
+
+    queue_write(data->self, data->uri, data->bytes, data->last_updated, data->expiry, data->etag);
+
+    g_thread_pool_push(decode_pool, data, NULL);
+}
+
 static void
 send_message_cb(GObject* source,
     GAsyncResult* res, gpointer udata)
@@ -186,19 +409,53 @@ send_message_cb(GObject* source,
     RETURN_IF_FAIL(udata != NULL);
 
     ResourceData* data = udata;
-    GtResourceDownloader* self = GT_RESOURCE_DOWNLOADER(data->self);
-    GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
+    GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(data->self);
+    GOutputStream* ostream = NULL;
     g_autoptr(GError) err = NULL;
 
     data->istream = soup_session_send_finish(SOUP_SESSION(source), res, &err);
 
-    if (!err)
-        g_thread_pool_push(dl_pool, data, NULL);
-    else
+    if (err)
     {
         data->cb(NULL, data->udata, g_steal_pointer(&err));
         resource_data_free(data);
+        return;
     }
+
+    if (!SOUP_STATUS_IS_SUCCESSFUL(data->msg->status_code))
+    {
+        DEBUG("Unsuccessful return code '%d' from uri '%s'", data->msg->status_code, data->uri);
+
+        data->cb(NULL, data->udata, NULL);
+        resource_data_free(data);
+        return;
+    }
+
+    data->etag = g_strdup(soup_message_headers_get_one(data->msg->response_headers, "ETag"));
+    data->last_updated = parse_http_time(soup_message_headers_get_one(data->msg->response_headers, "Last-Modified"));
+    data->expiry = parse_http_time(soup_message_headers_get_one(data->msg->response_headers, "Expires"));
+
+    /* NOTE: The caller already got the cached image, nothing to do
+     * unless it changed. If the cached copy couldn't be read or
+     * decoded the caller gets the response instead. */
+    if (data->returned_cached && priv->cache && (data->last_updated || data->etag) &&
+        !gt_cache_is_data_stale(priv->cache, data->uri, data->last_updated, data->etag))
+    {
+        DEBUG("No new image at uri '%s'", data->uri);
+
+        data->cb(NULL, data->udata, NULL);
+        resource_data_free(data);
+        return;
+    }
+
+    /* NOTE: Unref'd in callback */
+    ostream = g_memory_output_stream_new_resizable();
+
+    stage_enter(STAGE_READ);
+
+    g_output_stream_splice_async(ostream, data->istream,
+        G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE | G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
+        G_PRIORITY_DEFAULT, NULL, read_cb, data);
 }
 
 static void
@@ -209,7 +466,7 @@ finalize(GObject* obj)
     GtResourceDownloader* self = GT_RESOURCE_DOWNLOADER(obj);
     GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
 
-    g_free(priv->filepath);
+    g_mutex_clear(&priv->mutex);
 
     G_OBJECT_CLASS(gt_resource_downloader_parent_class)->finalize(obj);
 }
@@ -225,6 +482,7 @@ dispose(GObject* obj)
     MESSAGE("Finalize");
 
     g_clear_object(&priv->soup);
+    g_clear_object(&priv->cache);
 
     G_OBJECT_CLASS(gt_resource_downloader_parent_class)->dispose(obj);
 }
@@ -235,7 +493,8 @@ gt_resource_downloader_class_init(GtResourceDownloaderClass* klass)
     G_OBJECT_CLASS(klass)->finalize = finalize;
     G_OBJECT_CLASS(klass)->dispose = dispose;
 
-    dl_pool = g_thread_pool_new((GFunc) download_cb, NULL, g_get_num_processors(), FALSE, NULL);
+    decode_pool = g_thread_pool_new((GFunc) decode_cb, NULL, g_get_num_processors(), FALSE, NULL);
+    write_pool = g_thread_pool_new((GFunc) write_cb, NULL, 1, FALSE, NULL);
 }
 
 static void
@@ -258,24 +517,67 @@ gt_resource_downloader_new()
     return ret;
 }
 
-
+/* NOTE: Images are stored in the cache keyed by their uri, so
+ * downloaders sharing a cache share the stored images too */
 GtResourceDownloader*
-gt_resource_downloader_new_with_cache(const gchar* filepath)
+gt_resource_downloader_new_with_cache(GtCache* cache)
 {
-    RETURN_VAL_IF_FAIL(!utils_str_empty(filepath), NULL);
+    RETURN_VAL_IF_FAIL(GT_IS_CACHE(cache), NULL);
 
     GtResourceDownloader* ret = g_object_new(GT_TYPE_RESOURCE_DOWNLOADER, NULL);
     GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(ret);
 
-    priv->filepath = g_strdup(filepath);
-    priv->image_filetype = NULL;
+    priv->cache = g_object_ref(cache);
 
     return ret;
 }
 
+/* NOTE: The stages are shared by all downloaders. The snapshot has
+ * the same a{sa{sv}} type as gt_http_get_stats() so it can be printed
+ * with gt_http_stats_format_snapshot() */
+GVariant*
+gt_resource_downloader_get_stats()
+{
+    GVariantBuilder builder;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sa{sv}}"));
+
+    for (gint i = 0; i < NUM_STAGES; i++)
+    {
+        GVariantBuilder stage_builder;
+
+        g_variant_builder_init(&stage_builder, G_VARIANT_TYPE_VARDICT);
+
+        g_variant_builder_add(&stage_builder, "{sv}", "depth",
+            g_variant_new_uint64(g_atomic_int_get(&stage_stats[i].depth)));
+        g_variant_builder_add(&stage_builder, "{sv}", "max-depth",
+            g_variant_new_uint64(g_atomic_int_get(&stage_stats[i].max_depth)));
+        g_variant_builder_add(&stage_builder, "{sv}", "processed",
+            g_variant_new_uint64(g_atomic_int_get(&stage_stats[i].processed)));
+
+        g_variant_builder_add(&builder, "{s@a{sv}}", STAGE_NAMES[i], g_variant_builder_end(&stage_builder));
+    }
+
+    return g_variant_builder_end(&builder);
+}
+
+/* NOTE: Images bigger than the given size are scaled down to fit
+ * while decoding, keeping their aspect ratio. 0 leaves that dimension
+ * unconstrained. */
+void
+gt_resource_downloader_set_decode_size(GtResourceDownloader* self, gint width, gint height)
+{
+    RETURN_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self));
+
+    GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
+
+    priv->decode_width = width;
+    priv->decode_height = height;
+}
+
 GdkPixbuf*
 gt_resource_downloader_download_image(GtResourceDownloader* self,
-    const gchar* uri, const gchar* name, GError** error)
+    const gchar* uri, GError** error)
 {
     RETURN_VAL_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self), NULL);
     RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
@@ -283,7 +585,7 @@ gt_resource_downloader_download_image(GtResourceDownloader* self,
     GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
     g_autoptr(SoupMessage) msg = NULL;
     g_autoptr(GInputStream) istream = NULL;
-    g_autoptr(GdkPixbuf) ret = NULL;
+    g_autoptr(GBytes) bytes = NULL;
     g_autoptr(GError) err = NULL;
 
     DEBUG("Downloading image from uri '%s'", uri);
@@ -310,9 +612,10 @@ gt_resource_downloader_download_image(GtResourceDownloader* self,
         return NULL;
     }
 
-    ret = download_image(self, uri, name, msg, istream, NULL, error);
+    if (!(bytes = fetch_image(self, uri, msg, istream, NULL, error)))
+        return NULL;
 
-    return g_steal_pointer(&ret);
+    return decode_image(self, uri, bytes, error);
 }
 
 
@@ -329,7 +632,7 @@ download_image_async_cb(GTask* task, gpointer source,
     GenericTaskData* data = task_data;
 
     GdkPixbuf* ret = gt_resource_downloader_download_image(self,
-        data->str_1, data->str_2, &err);
+        data->str_1, &err);
 
     if (err)
         g_task_return_error(task, err);
@@ -339,7 +642,7 @@ download_image_async_cb(GTask* task, gpointer source,
 
 void
 gt_resource_downloader_download_image_async(GtResourceDownloader* self,
-    const gchar* uri, const gchar* name, GAsyncReadyCallback cb,
+    const gchar* uri, GAsyncReadyCallback cb,
     GCancellable* cancel, gpointer udata)
 {
     RETURN_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self));
@@ -348,7 +651,6 @@ gt_resource_downloader_download_image_async(GtResourceDownloader* self,
     GenericTaskData* data = generic_task_data_new();
 
     data->str_1 = g_strdup(uri);
-    data->str_2 = g_strdup(name);
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
@@ -367,74 +669,36 @@ gt_resource_donwloader_download_image_finish(GtResourceDownloader* self,
     return ret;
 }
 
-void
-gt_resource_downloader_set_image_filetype(GtResourceDownloader* self, const gchar* image_filetype)
-{
-    RETURN_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self));
-    RETURN_IF_FAIL(!utils_str_empty(image_filetype));
-
-    GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
-
-    priv->image_filetype = g_strdup(image_filetype);
-}
-
 /* FIXME: Make cancellable */
 GdkPixbuf*
 gt_resource_downloader_download_image_immediately(GtResourceDownloader* self,
-    const gchar* uri, const gchar* name, ResourceDownloaderFunc cb,
+    const gchar* uri, ResourceDownloaderFunc cb,
     gpointer udata, GError** error)
 {
     RETURN_VAL_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self), NULL);
     RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
 
     GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
-    g_autofree gchar* filename = NULL;
     g_autoptr(GdkPixbuf) ret = NULL;
-    g_autoptr(GError) err = NULL;
+    g_autoptr(GBytes) bytes = NULL;
     g_autoptr(SoupMessage) msg = NULL;
     ResourceData* data = NULL;
 
-    /* NOTE: If we aren't supplied a filename, we'll just create one by hashing the uri */
-    if (utils_str_empty(name))
-    {
-        gchar hash_str[15];
-        guint hash = 0;
-
-        hash = g_str_hash(uri); /* TODO: Replace this with murmur3 hash */
-
-        g_sprintf(hash_str, "%ud", hash);
-
-        filename = g_build_filename(priv->filepath, hash_str, NULL);
-    }
-    else
-        filename = g_build_filename(priv->filepath, name, NULL);
-
-    if (priv->filepath && g_file_test(filename, G_FILE_TEST_EXISTS))
-    {
-        ret = gdk_pixbuf_new_from_file(filename, &err);
-
-        if (err)
-        {
-            WARNING("Unable to download image because: %s", err->message);
-
-            g_propagate_prefixed_error(error, g_steal_pointer(&err),
-                "Unable to download image because: ");
-
-            /* NOTE: Don't return here as we still might be able to
-             * download a new image*/
-        }
-    }
+    /* NOTE: Whatever we have stored is returned straight away and the
+     * callback only gets an image if it changed */
+    if (priv->cache && (bytes = read_cached_image(self, uri)) != NULL)
+        ret = decode_image(self, uri, bytes, NULL);
 
     msg = soup_message_new(SOUP_METHOD_GET, uri);
     soup_message_headers_append(msg->request_headers, "Client-ID", CLIENT_ID);
 
     data = resource_data_new();
     data->uri = g_strdup(uri);
-    data->name = g_strdup(name);
     data->cb = cb;
     data->udata = udata;
     data->self = g_object_ref(self);
     data->msg = g_steal_pointer(&msg);
+    data->returned_cached = ret != NULL;
 
     soup_session_send_async(priv->soup, data->msg, NULL, send_message_cb, data);
 
@@ -0,0 +1,413 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-scheduler.h"
+#include "utils.h"
+
+#define TAG "GtScheduler"
+#include "gnome-twitch/gt-log.h"
+
+/* NOTE: Two levels of 64 slots, the first a second per slot and the
+ * second 64 seconds per slot. Jobs further out than that are clamped,
+ * which is fine for refresh intervals. */
+#define WHEEL_BITS 6
+#define WHEEL_SIZE (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define MAX_DELAY (WHEEL_SIZE*WHEEL_SIZE - 1)
+#define JITTER_RATIO 0.1
+
+typedef struct
+{
+    guint id;
+    guint interval;
+    guint64 expires; /* NOTE: In ticks */
+    GSourceFunc func;
+    gpointer udata;
+    GDestroyNotify notify;
+    GQueue* slot; /* NOTE: The queue the link is in, if any */
+    GList link;
+    gboolean running;
+    gboolean removed;
+} GtSchedulerJob;
+
+typedef struct
+{
+    GQueue wheels[2][WHEEL_SIZE];
+    GHashTable* jobs; /* NOTE: Maps ids to jobs */
+
+    guint64 now; /* NOTE: Ticks passed while not paused */
+    guint next_id;
+    guint tick_id;
+    gboolean paused;
+} GtSchedulerPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE(GtScheduler, gt_scheduler, G_TYPE_OBJECT);
+
+enum
+{
+    PROP_0,
+    PROP_PAUSED,
+    NUM_PROPS,
+};
+
+static GParamSpec* props[NUM_PROPS];
+
+static void
+job_free(GtSchedulerJob* job)
+{
+    if (job->notify)
+        job->notify(job->udata);
+
+    g_slice_free(GtSchedulerJob, job);
+}
+
+static guint
+jittered(guint interval)
+{
+    gint jitter = interval*JITTER_RATIO;
+
+    if (jitter == 0)
+        return MAX(interval, 1);
+
+    return MAX((gint) interval + g_random_int_range(-jitter, jitter + 1), 1);
+}
+
+static void
+insert_job(GtScheduler* self, GtSchedulerJob* job)
+{
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    guint64 delta = job->expires > priv->now ? job->expires - priv->now : 0;
+
+    if (delta < WHEEL_SIZE)
+        job->slot = &priv->wheels[0][job->expires & WHEEL_MASK];
+    else
+        job->slot = &priv->wheels[1][(job->expires >> WHEEL_BITS) & WHEEL_MASK];
+
+    g_queue_push_tail_link(job->slot, &job->link);
+}
+
+static void
+unlink_job(GtSchedulerJob* job)
+{
+    if (!job->slot)
+        return;
+
+    g_queue_unlink(job->slot, &job->link);
+    job->slot = NULL;
+}
+
+static void
+place_job(GtScheduler* self, GtSchedulerJob* job, guint delay)
+{
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    job->expires = priv->now + CLAMP(delay, 1, MAX_DELAY);
+
+    insert_job(self, job);
+}
+
+/* NOTE: Takes the jobs out of a slot so it can be refilled while
+ * we go through them */
+static void
+steal_slot(GQueue* slot, GQueue* into)
+{
+    *into = *slot;
+    g_queue_init(slot);
+
+    for (GList* l = into->head; l != NULL; l = l->next)
+        ((GtSchedulerJob*) l->data)->slot = into;
+}
+
+static void
+run_job(GtScheduler* self, GtSchedulerJob* job)
+{
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    gboolean keep;
+
+    job->running = TRUE;
+    keep = job->func(job->udata);
+    job->running = FALSE;
+
+    if (job->removed || keep == G_SOURCE_REMOVE)
+        g_hash_table_remove(priv->jobs, GUINT_TO_POINTER(job->id));
+    else
+        place_job(self, job, jittered(job->interval));
+}
+
+static gboolean tick_cb(gpointer udata);
+
+static void
+update_tick(GtScheduler* self)
+{
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    gboolean should_tick = !priv->paused && g_hash_table_size(priv->jobs) > 0;
+
+    if (should_tick && priv->tick_id == 0)
+        priv->tick_id = g_timeout_add_seconds_full(G_PRIORITY_LOW, 1, tick_cb, self, NULL);
+    else if (!should_tick && priv->tick_id > 0)
+    {
+        g_source_remove(priv->tick_id);
+        priv->tick_id = 0;
+    }
+}
+
+static gboolean
+tick_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_SCHEDULER(udata), G_SOURCE_REMOVE);
+
+    g_autoptr(GtScheduler) self = g_object_ref(udata);
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    GQueue due = G_QUEUE_INIT;
+    GList* link;
+
+    priv->now++;
+
+    /* NOTE: Move the jobs due in the next 64 seconds down a level */
+    if ((priv->now & WHEEL_MASK) == 0)
+    {
+        GQueue cascade = G_QUEUE_INIT;
+
+        steal_slot(&priv->wheels[1][(priv->now >> WHEEL_BITS) & WHEEL_MASK], &cascade);
+
+        while ((link = g_queue_pop_head_link(&cascade)) != NULL)
+        {
+            GtSchedulerJob* job = link->data;
+
+            job->slot = NULL;
+            insert_job(self, job);
+        }
+    }
+
+    steal_slot(&priv->wheels[0][priv->now & WHEEL_MASK], &due);
+
+    while ((link = g_queue_pop_head_link(&due)) != NULL)
+    {
+        GtSchedulerJob* job = link->data;
+
+        job->slot = NULL;
+        run_job(self, job);
+    }
+
+    if (priv->paused || g_hash_table_size(priv->jobs) == 0)
+    {
+        priv->tick_id = 0;
+
+        return G_SOURCE_REMOVE;
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+/* NOTE: The first run is at a random point in the interval */
+guint
+gt_scheduler_add(GtScheduler* self, guint interval, GSourceFunc func, gpointer udata, GDestroyNotify notify)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_SCHEDULER(self), 0);
+    RETURN_VAL_IF_FAIL(interval > 0, 0);
+    RETURN_VAL_IF_FAIL(func != NULL, 0);
+
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    GtSchedulerJob* job = g_slice_new0(GtSchedulerJob);
+
+    if (++priv->next_id == 0)
+        priv->next_id++;
+
+    job->id = priv->next_id;
+    job->interval = interval;
+    job->func = func;
+    job->udata = udata;
+    job->notify = notify;
+    job->link.data = job;
+
+    g_hash_table_insert(priv->jobs, GUINT_TO_POINTER(job->id), job);
+
+    place_job(self, job, g_random_int_range(1, MIN(interval, MAX_DELAY) + 1));
+
+    update_tick(self);
+
+    return job->id;
+}
+
+/* NOTE: Takes effect after the next run, unless the job is due later
+ * than the new interval in which case it's moved up */
+void
+gt_scheduler_set_interval(GtScheduler* self, guint id, guint interval)
+{
+    RETURN_IF_FAIL(GT_IS_SCHEDULER(self));
+    RETURN_IF_FAIL(interval > 0);
+
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    GtSchedulerJob* job = g_hash_table_lookup(priv->jobs, GUINT_TO_POINTER(id));
+
+    RETURN_IF_FAIL(job != NULL);
+
+    if (job->interval == interval)
+        return;
+
+    job->interval = interval;
+
+    if (!job->running && job->expires > priv->now + interval)
+    {
+        unlink_job(job);
+        place_job(self, job, g_random_int_range(1, MIN(interval, MAX_DELAY) + 1));
+    }
+}
+
+void
+gt_scheduler_remove(GtScheduler* self, guint id)
+{
+    RETURN_IF_FAIL(GT_IS_SCHEDULER(self));
+
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    GtSchedulerJob* job = g_hash_table_lookup(priv->jobs, GUINT_TO_POINTER(id));
+
+    RETURN_IF_FAIL(job != NULL);
+
+    /* NOTE: Freed once it returns, see run_job */
+    if (job->running)
+    {
+        job->removed = TRUE;
+        return;
+    }
+
+    unlink_job(job);
+    g_hash_table_remove(priv->jobs, GUINT_TO_POINTER(id));
+
+    update_tick(self);
+}
+
+void
+gt_scheduler_set_paused(GtScheduler* self, gboolean paused)
+{
+    RETURN_IF_FAIL(GT_IS_SCHEDULER(self));
+
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    if (priv->paused == paused)
+        return;
+
+    priv->paused = paused;
+
+    DEBUG("%s '%d' jobs", paused ? "Pausing" : "Resuming", g_hash_table_size(priv->jobs));
+
+    update_tick(self);
+
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PAUSED]);
+}
+
+gboolean
+gt_scheduler_is_paused(GtScheduler* self)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_SCHEDULER(self), FALSE);
+
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    return priv->paused;
+}
+
+static void
+finalize(GObject* obj)
+{
+    RETURN_IF_FAIL(GT_IS_SCHEDULER(obj));
+
+    GtScheduler* self = GT_SCHEDULER(obj);
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    if (priv->tick_id > 0)
+        g_source_remove(priv->tick_id);
+
+    g_hash_table_unref(priv->jobs);
+
+    G_OBJECT_CLASS(gt_scheduler_parent_class)->finalize(obj);
+}
+
+static void
+get_property(GObject* obj,
+    guint prop, GValue* val, GParamSpec* pspec)
+{
+    RETURN_IF_FAIL(GT_IS_SCHEDULER(obj));
+
+    GtScheduler* self = GT_SCHEDULER(obj);
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    switch (prop)
+    {
+        case PROP_PAUSED:
+            g_value_set_boolean(val, priv->paused);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
+    }
+}
+
+static void
+set_property(GObject* obj,
+    guint prop, const GValue* val, GParamSpec* pspec)
+{
+    RETURN_IF_FAIL(GT_IS_SCHEDULER(obj));
+
+    GtScheduler* self = GT_SCHEDULER(obj);
+
+    switch (prop)
+    {
+        case PROP_PAUSED:
+            gt_scheduler_set_paused(self, g_value_get_boolean(val));
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
+    }
+}
+
+static void
+gt_scheduler_class_init(GtSchedulerClass* klass)
+{
+    GObjectClass* obj_class = G_OBJECT_CLASS(klass);
+
+    obj_class->finalize = finalize;
+    obj_class->get_property = get_property;
+    obj_class->set_property = set_property;
+
+    props[PROP_PAUSED] = g_param_spec_boolean("paused",
+        "Paused", "Whether jobs are held back",
+        FALSE, G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
+    g_object_class_install_properties(obj_class, NUM_PROPS, props);
+}
+
+static void
+gt_scheduler_init(GtScheduler* self)
+{
+    GtSchedulerPrivate* priv = gt_scheduler_get_instance_private(self);
+
+    priv->jobs = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, (GDestroyNotify) job_free);
+}
+
+GtScheduler*
+gt_scheduler_new(void)
+{
+    return g_object_new(GT_TYPE_SCHEDULER, NULL);
+}
@@ -0,0 +1,49 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GT_SCHEDULER_H
+#define GT_SCHEDULER_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define GT_TYPE_SCHEDULER gt_scheduler_get_type()
+
+G_DECLARE_FINAL_TYPE(GtScheduler, gt_scheduler, GT, SCHEDULER, GObject);
+
+struct _GtScheduler
+{
+    GObject parent_instance;
+};
+
+/* NOTE: Runs periodic jobs from a timer wheel on the main context
+ * with one second resolution. Jobs start at a random point in their
+ * interval and every run is jittered, so jobs added at the same time
+ * don't fire in lockstep. While paused no time passes for the jobs.
+ * Return G_SOURCE_REMOVE from the function to stop running. */
+GtScheduler* gt_scheduler_new(void);
+guint        gt_scheduler_add(GtScheduler* self, guint interval, GSourceFunc func, gpointer udata, GDestroyNotify notify);
+void         gt_scheduler_set_interval(GtScheduler* self, guint id, guint interval);
+void         gt_scheduler_remove(GtScheduler* self, guint id);
+void         gt_scheduler_set_paused(GtScheduler* self, gboolean paused);
+gboolean     gt_scheduler_is_paused(GtScheduler* self);
+
+G_END_DECLS
+
+#endif
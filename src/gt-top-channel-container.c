@@ -123,7 +123,7 @@ process_json_cb(GObject* source,
 
     json_reader_end_member(reader);
 
-    gt_item_container_append_items(GT_ITEM_CONTAINER(self), g_steal_pointer(&items));
+    gt_item_container_append_items(GT_ITEM_CONTAINER(self), items);
     gt_item_container_set_fetching_items(GT_ITEM_CONTAINER(self), FALSE);
 }
 
@@ -191,6 +191,17 @@ create_child(GtItemContainer* item_container, gpointer data)
     return GTK_WIDGET(gt_channels_container_child_new(GT_CHANNEL(data)));
 }
 
+static void
+bind_child(GtItemContainer* item_container,
+    GtkWidget* child, gpointer data)
+{
+    g_assert(GT_IS_TOP_CHANNEL_CONTAINER(item_container));
+    g_assert(GT_IS_CHANNELS_CONTAINER_CHILD(child));
+    g_assert(GT_IS_CHANNEL(data));
+
+    g_object_set(child, "channel", data, NULL);
+}
+
 static void
 activate_child(GtItemContainer* item_container,
     gpointer child)
@@ -203,6 +214,7 @@ static void
 gt_top_channel_container_class_init(GtTopChannelContainerClass* klass)
 {
     GT_ITEM_CONTAINER_CLASS(klass)->create_child = create_child;
+    GT_ITEM_CONTAINER_CLASS(klass)->bind_child = bind_child;
     GT_ITEM_CONTAINER_CLASS(klass)->get_properties = get_properties;
     GT_ITEM_CONTAINER_CLASS(klass)->activate_child = activate_child;
     GT_ITEM_CONTAINER_CLASS(klass)->request_extra_items = request_extra_items;
@@ -212,6 +212,17 @@ create_child(GtItemContainer* item_container, gpointer data)
     return GTK_WIDGET(gt_games_container_child_new(GT_GAME(data)));
 }
 
+static void
+bind_child(GtItemContainer* item_container,
+    GtkWidget* child, gpointer data)
+{
+    g_assert(GT_IS_TOP_GAME_CONTAINER(item_container));
+    g_assert(GT_IS_GAMES_CONTAINER_CHILD(child));
+    g_assert(GT_IS_GAME(data));
+
+    g_object_set(child, "game", data, NULL);
+}
+
 static void
 activate_child(GtItemContainer* item_container,
     gpointer child)
@@ -233,6 +244,7 @@ static void
 gt_top_game_container_class_init(GtTopGameContainerClass* klass)
 {
     GT_ITEM_CONTAINER_CLASS(klass)->create_child = create_child;
+    GT_ITEM_CONTAINER_CLASS(klass)->bind_child = bind_child;
     GT_ITEM_CONTAINER_CLASS(klass)->get_properties = get_properties;
     GT_ITEM_CONTAINER_CLASS(klass)->request_extra_items = request_extra_items;
     GT_ITEM_CONTAINER_CLASS(klass)->activate_child = activate_child;
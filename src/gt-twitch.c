@@ -60,6 +60,10 @@
 
 #define STREAM_INFO "#EXT-X-STREAM-INF"
 
+/* NOTE: Heights of the 1x emote and badge images */
+#define EMOTE_SIZE 28
+#define BADGE_SIZE 18
+
 #define TWITCH_API_VERSION_3 "3"
 #define TWITCH_API_VERSION_4 "4"
 #define TWITCH_API_VERSION_5 "5"
@@ -264,17 +268,12 @@ gt_twitch_init(GtTwitch* self)
     priv->emote_table = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_object_unref);
     priv->badge_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) gt_chat_badge_free);
 
-    g_autofree gchar* emotes_filepath = g_build_filename(g_get_user_cache_dir(),
-        "gnome-twitch", "emotes", NULL);
-
-    g_autofree gchar* badges_filepath = g_build_filename(g_get_user_cache_dir(),
-        "gnome-twitch", "badges", NULL);
-
-    emote_downloader = gt_resource_downloader_new_with_cache(emotes_filepath);
-    gt_resource_downloader_set_image_filetype(emote_downloader, GT_IMAGE_FILETYPE_PNG);
+    emote_downloader = gt_resource_downloader_new_with_cache(main_app->cache);
+    badge_downloader = gt_resource_downloader_new_with_cache(main_app->cache);
 
-    badge_downloader = gt_resource_downloader_new_with_cache(badges_filepath);
-    gt_resource_downloader_set_image_filetype(badge_downloader, GT_IMAGE_FILETYPE_PNG);
+    /* NOTE: Only the 1x images are used, anything bigger is scaled down */
+    gt_resource_downloader_set_decode_size(emote_downloader, 0, EMOTE_SIZE);
+    gt_resource_downloader_set_decode_size(badge_downloader, BADGE_SIZE, BADGE_SIZE);
 
     g_signal_connect_swapped(main_app, "shutdown", G_CALLBACK(g_object_unref), emote_downloader);
     g_signal_connect_swapped(main_app, "shutdown", G_CALLBACK(g_object_unref), badge_downloader);
@@ -1327,10 +1326,6 @@ gt_twitch_fetch_channel(GtTwitch* self, const gchar* id, GError** error)
 
     channel = gt_channel_new(data);
 
-    g_assert(g_object_is_floating(channel));
-
-    g_object_ref_sink(channel);
-
     return channel;
 }
 
@@ -1420,129 +1415,6 @@ gt_twitch_fetch_channel_finish(GtTwitch* self,
 /*     } */
 /* } */
 
-GdkPixbuf*
-gt_twitch_download_picture(GtTwitch* self, const gchar* url, gint64 timestamp, GError** error)
-{
-    g_assert(GT_IS_TWITCH(self));
-    g_assert_false(utils_str_empty(url));
-
-    GtTwitchPrivate* priv = gt_twitch_get_instance_private(self);
-    g_autoptr(SoupMessage) msg = NULL;
-    GError* err = NULL;
-    GdkPixbuf* ret = NULL;
-    g_autoptr(GInputStream) input_stream = NULL;
-
-    DEBUG("Downloading picture from url '%s'", url);
-
-    if (timestamp)
-    {
-        msg = soup_message_new(SOUP_METHOD_HEAD, url);
-        soup_message_headers_append(msg->request_headers, "Client-ID", CLIENT_ID);
-        soup_session_send_message(priv->soup, msg);
-
-        if (SOUP_STATUS_IS_SUCCESSFUL(msg->status_code))
-        {
-            const gchar* last_modified;
-
-            if ((last_modified = soup_message_headers_get_one(msg->response_headers, "Last-Modified")) != NULL &&
-                utils_http_full_date_to_timestamp(last_modified) < timestamp)
-            {
-                DEBUG("No new content at url '%s'", url);
-
-                return NULL;
-            }
-        }
-        else
-        {
-            WARNING("Unable to download picture from url '%s' because received unsuccessful response with code '%d' and body '%s'",
-                url, msg->status_code, msg->response_body->data);
-
-            g_set_error(error, GT_TWITCH_ERROR, GT_TWITCH_ERROR_SOUP_GENERIC,
-                "Unable to download picture from url '%s' because received unsuccessful response with code '%d' and body '%s'",
-                url, msg->status_code, msg->response_body->data);
-
-            return NULL;
-        }
-    }
-
-#define CHECK_ERROR                                                     \
-    if (err)                                                            \
-    {                                                                   \
-        WARNINGF("Error downloading picture for url '%s' because: %s",  \
-            url, err->message);                                         \
-                                                                        \
-        g_propagate_prefixed_error(error, err, "Unable to download picture for url '%s' because: ", \
-            url);                                                       \
-                                                                        \
-        return NULL;                                                    \
-    }                                                                   \
-
-
-    msg = soup_message_new(SOUP_METHOD_GET, url);
-    soup_message_headers_append(msg->request_headers, "Client-ID", CLIENT_ID);
-    input_stream = soup_session_send(priv->soup, msg, NULL, &err);
-
-    CHECK_ERROR;
-
-    ret = gdk_pixbuf_new_from_stream(input_stream, NULL, &err);
-
-    CHECK_ERROR;
-
-    //TODO: Need to free ret if an error is encountered here
-    g_input_stream_close(input_stream, NULL, &err);
-
-    CHECK_ERROR;
-
-    return ret;
-}
-
-static void
-download_picture_async_cb(GTask* task,
-                          gpointer source,
-                          gpointer task_data,
-                          GCancellable* cancel)
-{
-    GenericTaskData* data = (GenericTaskData*) task_data;
-    GdkPixbuf* ret = NULL;
-    GError* err = NULL;
-
-    if (g_task_return_error_if_cancelled(task))
-        return;
-
-    ret = gt_twitch_download_picture(GT_TWITCH(source), data->str_1, data->int_1, &err);
-
-    if (err)
-        g_task_return_error(task, err);
-    else
-        g_task_return_pointer(task, ret, (GDestroyNotify) g_object_unref);
-}
-
-void
-gt_twitch_download_picture_async(GtTwitch* self,
-    const gchar* url, gint64 timestamp,
-    GCancellable* cancel, GAsyncReadyCallback cb,
-    gpointer udata)
-{
-    g_assert(GT_IS_TWITCH(self));
-    g_assert_false(utils_str_empty(url));
-
-    GTask* task = NULL;
-    GenericTaskData* data = NULL;
-
-    task = g_task_new(self, cancel, cb, udata);
-    g_task_set_return_on_cancel(task, FALSE);
-
-    data = generic_task_data_new();
-    data->str_1 = g_strdup(url);
-    data->int_1 = timestamp;
-
-    g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
-
-    g_task_run_in_thread(task, download_picture_async_cb);
-
-    g_object_unref(task);
-}
-
 GdkPixbuf*
 gt_twitch_download_emote(GtTwitch* self, gint id)
 {
@@ -1554,14 +1426,12 @@ gt_twitch_download_emote(GtTwitch* self, gint id)
         g_autofree gchar* uri = NULL;
         g_autoptr(GError) err = NULL;
         g_autoptr(GdkPixbuf) emote = NULL;
-        gchar id_str[15];
 
         uri = g_strdup_printf(TWITCH_EMOTE_URI, id, 1);
-        g_sprintf(id_str, "%d", id);
 
         DEBUGF("Downloading emote form url='%s'", uri);
 
-        emote = gt_resource_downloader_download_image(emote_downloader, uri, id_str, &err);
+        emote = gt_resource_downloader_download_image(emote_downloader, uri, &err);
 
         /* NOTE: If we encountered an error here we'll just insert a generic error emote */
         if (err)
@@ -1647,7 +1517,7 @@ fetch_chat_badge_set(GtTwitch* self, const gchar* set_name, GError** error)
 
             READ_JSON_VALUE("image_url_1x", uri);
             badge->pixbuf = gt_resource_downloader_download_image(badge_downloader,
-                uri, key, &err);
+                uri, &err);
 
             if (err)
             {
@@ -2153,6 +2023,7 @@ gt_twitch_fetch_all_followed_channels(GtTwitch* self,
     GList* chans = NULL;
     GList* streams = NULL;
     GList* ret = NULL;
+    GHashTable* chans_index = NULL;
     GError* err = NULL;
 
     streams = g_list_concat(streams,
@@ -2187,10 +2058,17 @@ gt_twitch_fetch_all_followed_channels(GtTwitch* self,
         }
     }
 
+    /* NOTE: Index the channels by id so that removing duplicates
+     * doesn't search the whole list for every stream */
+    chans_index = g_hash_table_new(g_str_hash, g_str_equal);
+
+    for (GList* l = chans; l != NULL; l = l->next)
+        g_hash_table_insert(chans_index, ((GtChannelData*) l->data)->id, l);
+
     //NOTE: Remove duplicates
     for (GList* l = streams; l != NULL; l = l->next)
     {
-        GList* found = g_list_find_custom(chans, l->data, (GCompareFunc) gt_channel_data_compare);
+        GList* found = g_hash_table_lookup(chans_index, ((GtChannelData*) l->data)->id);
 
         if (!found)
         {
@@ -2209,6 +2087,7 @@ gt_twitch_fetch_all_followed_channels(GtTwitch* self,
             g_assert_nonnull(found->data);
             g_assert_false(((GtChannelData*) found->data)->online);
 
+            g_hash_table_remove(chans_index, ((GtChannelData*) found->data)->id);
             gt_channel_data_free(found->data);
 
             chans = g_list_delete_link(chans, found);
@@ -2222,9 +2101,12 @@ gt_twitch_fetch_all_followed_channels(GtTwitch* self,
         GtChannelData* data = l->data;
         GtChannel* chan = gt_channel_new(data);
 
-        ret = g_list_append(ret, chan);
+        ret = g_list_prepend(ret, chan);
     }
 
+    ret = g_list_reverse(ret);
+
+    g_hash_table_unref(chans_index);
     g_list_free(chans); //NOTE: Don't need to free entire list because gt_channel_new takes ownership of the data
 
     return ret;
@@ -141,8 +141,6 @@ void                       gt_twitch_fetch_channel_async(GtTwitch* self, const g
 GtChannel*                 gt_twitch_fetch_channel_finish(GtTwitch* self, GAsyncResult* result, GError** error);
 void                       gt_twitch_channel_raw_data_async(GtTwitch* self, const gchar* name, GCancellable* cancel, GAsyncReadyCallback cb, gpointer udata);
 GtGameData*                gt_twitch_game_raw_data(GtTwitch* self, const gchar* name);
-GdkPixbuf*                 gt_twitch_download_picture(GtTwitch* self, const gchar* url, gint64 timestamp, GError** error);
-void                       gt_twitch_download_picture_async(GtTwitch* self, const gchar* url, gint64 timestamp, GCancellable* cancel, GAsyncReadyCallback cb, gpointer udata);
 GdkPixbuf*                 gt_twitch_download_emote(GtTwitch* self, gint id);
 GList*                     gt_twitch_channel_info(GtTwitch* self, const gchar* chan);
 void                       gt_twitch_channel_info_panel_free(GtTwitchChannelInfoPanel* panel);
@@ -30,6 +30,8 @@ typedef struct
     GtkWidget* title_label;
     GtkWidget* cover_stack;
     GtkWidget* loading_spinner;
+
+    GPtrArray* bindings; /* NOTE: Dropped when rebound to another VOD */
 } GtVODContainerChildPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GtVODContainerChild, gt_vod_container_child, GTK_TYPE_FLOW_BOX_CHILD);
@@ -83,6 +85,58 @@ vod_updating_cb(GObject* source,
         gtk_stack_set_visible_child(GTK_STACK(priv->cover_stack), priv->preview_overlay);
 }
 
+/* NOTE: Children are recycled by the item containers as they're
+ * scrolled, so the VOD can change at any time */
+static void
+set_vod(GtVODContainerChild* self, GtVOD* vod)
+{
+    GtVODContainerChildPrivate* priv = gt_vod_container_child_get_instance_private(self);
+
+    if (self->vod)
+    {
+        g_ptr_array_set_size(priv->bindings, 0);
+        g_signal_handlers_disconnect_by_data(self->vod, self);
+        g_clear_object(&self->vod);
+    }
+
+    if (!vod)
+        return;
+
+    gtk_revealer_set_reveal_child(GTK_REVEALER(priv->action_revealer), FALSE);
+
+    self->vod = vod;
+
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->vod, "preview",
+            priv->preview_image, "pixbuf", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->vod, "title",
+            priv->title_label, "label", G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+
+    g_signal_connect_object(self->vod, "notify::updating", G_CALLBACK(vod_updating_cb), self, 0);
+
+    vod_updating_cb(G_OBJECT(self->vod), NULL, self);
+}
+
+static void
+dispose(GObject* obj)
+{
+    GtVODContainerChild* self = GT_VOD_CONTAINER_CHILD(obj);
+
+    set_vod(self, NULL);
+
+    G_OBJECT_CLASS(gt_vod_container_child_parent_class)->dispose(obj);
+}
+
+static void
+finalize(GObject* obj)
+{
+    GtVODContainerChild* self = GT_VOD_CONTAINER_CHILD(obj);
+    GtVODContainerChildPrivate* priv = gt_vod_container_child_get_instance_private(self);
+
+    g_ptr_array_unref(priv->bindings);
+
+    G_OBJECT_CLASS(gt_vod_container_child_parent_class)->finalize(obj);
+}
+
 static void
 get_property(GObject* obj, guint prop,
     GValue* val, GParamSpec* pspec)
@@ -108,7 +162,7 @@ set_property(GObject* obj, guint prop,
     switch (prop)
     {
         case PROP_VOD:
-            self->vod = utils_value_ref_sink_object(val);
+            set_vod(self, utils_value_ref_sink_object(val));
             break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
@@ -123,13 +177,6 @@ constructed(GObject* obj)
     GtVODContainerChild* self = GT_VOD_CONTAINER_CHILD(obj);
     GtVODContainerChildPrivate* priv = gt_vod_container_child_get_instance_private(self);
 
-    g_object_bind_property(self->vod, "preview", priv->preview_image, "pixbuf",
-        G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->vod, "title", priv->title_label, "label",
-        G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-
-    g_signal_connect_object(self->vod, "notify::updating", G_CALLBACK(vod_updating_cb), obj, 0);
-
     gtk_widget_set_events(priv->preview_overlay, GDK_ENTER_NOTIFY_MASK | GDK_LEAVE_NOTIFY_MASK);
 
     g_signal_connect_object(priv->preview_overlay, "enter-notify-event",
@@ -144,12 +191,14 @@ constructed(GObject* obj)
 static void
 gt_vod_container_child_class_init(GtVODContainerChildClass* klass)
 {
+    G_OBJECT_CLASS(klass)->dispose = dispose;
+    G_OBJECT_CLASS(klass)->finalize = finalize;
     G_OBJECT_CLASS(klass)->get_property = get_property;
     G_OBJECT_CLASS(klass)->set_property = set_property;
     G_OBJECT_CLASS(klass)->constructed = constructed;
 
     props[PROP_VOD] = g_param_spec_object("vod", "VOD", "VOD",
-        GT_TYPE_VOD, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+        GT_TYPE_VOD, G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
 
     g_object_class_install_properties(G_OBJECT_CLASS(klass), NUM_PROPS, props);
 
@@ -169,6 +218,10 @@ gt_vod_container_child_init(GtVODContainerChild* self)
 {
     g_assert(GT_IS_VOD_CONTAINER_CHILD(self));
 
+    GtVODContainerChildPrivate* priv = gt_vod_container_child_get_instance_private(self);
+
+    priv->bindings = g_ptr_array_new_with_free_func((GDestroyNotify) g_binding_unbind);
+
     gtk_widget_init_template(GTK_WIDGET(self));
 }
 
@@ -36,6 +36,9 @@ typedef struct
 
     gboolean updating;
 
+    gboolean in_view;
+    gboolean preview_pending; /* NOTE: Waiting to come into view */
+
     GdkPixbuf* preview;
     GCancellable* cancel;
 } GtVODPrivate;
@@ -57,11 +60,38 @@ enum
     PROP_URL,
     PROP_TAG_LIST,
     PROP_UPDATING,
+    PROP_IN_VIEW,
     NUM_PROPS,
 };
 
 static GParamSpec* props[NUM_PROPS];
 
+static void
+notify_preview(GtVOD* self)
+{
+    GtVODPrivate* priv = gt_vod_get_instance_private(self);
+
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PREVIEW]);
+
+    priv->updating = FALSE;
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_UPDATING]);
+}
+
+static void update_preview(GtVOD* self);
+
+static void
+preview_cancelled(GtVOD* self)
+{
+    GtVODPrivate* priv = gt_vod_get_instance_private(self);
+
+    /* NOTE: Scrolled back into view before the cancelled download
+     * got back to us */
+    if (priv->preview_pending && priv->in_view)
+        update_preview(self);
+    else
+        notify_preview(self);
+}
+
 static void
 handle_preview_download_cb(GObject* source,
     GAsyncResult* res, gpointer udata)
@@ -80,11 +110,23 @@ handle_preview_download_cb(GObject* source,
 
     GtVODPrivate* priv = gt_vod_get_instance_private(self);
     g_autoptr(GError) err = NULL;
+    g_autoptr(GdkPixbuf) preview = gdk_pixbuf_new_from_stream_finish(res, &err);
 
-    priv->preview = gdk_pixbuf_new_from_stream_finish(res, &err);
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        preview_cancelled(self);
+
+        return;
+    }
 
     RETURN_IF_ERROR(err); /* FIXME: Handle error */
 
+    g_clear_object(&priv->preview);
+    priv->preview = g_steal_pointer(&preview);
+
+    gt_image_cache_insert(main_app->image_cache, priv->data->preview.large,
+        PREVIEW_WIDTH, PREVIEW_HEIGHT, priv->preview, 0);
+
     if (g_object_steal_data(G_OBJECT(self), "save-preview"))
     {
         gdk_pixbuf_save(priv->preview, priv->preview_filepath, "jpeg",
@@ -95,10 +137,7 @@ handle_preview_download_cb(GObject* source,
         RETURN_IF_ERROR(err);
     }
 
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PREVIEW]);
-
-    priv->updating = FALSE;
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_UPDATING]);
+    notify_preview(self);
 }
 
 static void
@@ -115,6 +154,13 @@ handle_preview_response_cb(GtHTTP* http,
 
     GtVODPrivate* priv = gt_vod_get_instance_private(self);
 
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        preview_cancelled(self);
+
+        return;
+    }
+
     RETURN_IF_ERROR(error); /* FIXME: Handle error */
 
     RETURN_IF_FAIL(G_IS_INPUT_STREAM(res));
@@ -129,10 +175,87 @@ update_preview(GtVOD* self)
 
     GtVODPrivate* priv = gt_vod_get_instance_private(self);
 
+    g_autoptr(GdkPixbuf) cached = NULL;
+
+    /* NOTE: Already decoded for another view */
+    if ((cached = gt_image_cache_lookup(main_app->image_cache, priv->data->preview.large, PREVIEW_WIDTH, PREVIEW_HEIGHT)) != NULL)
+    {
+        priv->preview_pending = FALSE;
+
+        g_clear_object(&priv->preview);
+        priv->preview = g_steal_pointer(&cached);
+
+        notify_preview(self);
+
+        return;
+    }
+
+    /* NOTE: Leave the download until the VOD is scrolled near */
+    if (!priv->in_view)
+    {
+        priv->preview_pending = TRUE;
+
+        notify_preview(self);
+
+        return;
+    }
+
+    priv->preview_pending = FALSE;
+
+    utils_refresh_cancellable(&priv->cancel);
+
     gt_http_get_with_category(main_app->http, priv->data->preview.large, "gt-vod", DEFAULT_TWITCH_HEADERS,
         priv->cancel, G_CALLBACK(handle_preview_response_cb), utils_weak_ref_new(self), GT_HTTP_FLAG_RETURN_STREAM | GT_HTTP_FLAG_CACHE_RESPONSE);
 }
 
+/* NOTE: The image cache keeps its own reference for as long as its
+ * budget allows, so coming back into view is usually just a lookup */
+static void
+release_preview(GtVOD* self)
+{
+    GtVODPrivate* priv = gt_vod_get_instance_private(self);
+
+    if (!priv->data)
+        return;
+
+    g_cancellable_cancel(priv->cancel);
+
+    priv->preview_pending = TRUE;
+
+    if (priv->preview)
+    {
+        g_clear_object(&priv->preview);
+        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PREVIEW]);
+    }
+}
+
+static void
+set_in_view(GtVOD* self, gboolean in_view)
+{
+    GtVODPrivate* priv = gt_vod_get_instance_private(self);
+
+    if (priv->in_view == in_view)
+        return;
+
+    priv->in_view = in_view;
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_IN_VIEW]);
+
+    if (!in_view)
+    {
+        release_preview(self);
+
+        return;
+    }
+
+    if (priv->preview_pending && !priv->updating)
+    {
+        priv->updating = TRUE;
+        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_UPDATING]);
+
+        update_preview(self);
+    }
+}
+
 static void
 update_from_data(GtVOD* self, GtVODData* data)
 {
@@ -193,6 +316,25 @@ get_property(GObject* obj,
         case PROP_UPDATING:
             g_value_set_boolean(val, priv->updating);
             break;
+        case PROP_IN_VIEW:
+            g_value_set_boolean(val, priv->in_view);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
+    }
+}
+
+static void
+set_property(GObject* obj,
+    guint prop, const GValue* val, GParamSpec* pspec)
+{
+    GtVOD* self = GT_VOD(obj);
+
+    switch (prop)
+    {
+        case PROP_IN_VIEW:
+            set_in_view(self, g_value_get_boolean(val));
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, prop, pspec);
     }
@@ -202,6 +344,7 @@ static void
 gt_vod_class_init(GtVODClass* klass)
 {
     G_OBJECT_CLASS(klass)->get_property = get_property;
+    G_OBJECT_CLASS(klass)->set_property = set_property;
 
     props[PROP_CREATED_AT] = g_param_spec_boxed("created-at", "Created at", "Date and time when VOD was created",
         G_TYPE_DATE_TIME, G_PARAM_READABLE);
@@ -239,6 +382,9 @@ gt_vod_class_init(GtVODClass* klass)
     props[PROP_UPDATING] = g_param_spec_boolean("updating", "Updating", "Whether updating",
         FALSE, G_PARAM_READABLE);
 
+    props[PROP_IN_VIEW] = g_param_spec_boolean("in-view", "In view", "Whether the VOD is shown in or near a view",
+        FALSE, G_PARAM_READWRITE);
+
     g_object_class_install_properties(G_OBJECT_CLASS(klass), NUM_PROPS, props);
 }
 
@@ -540,6 +540,10 @@ window_state_event_cb(GtkWidget* widget,
 
     g_object_notify_by_pspec(G_OBJECT(self), props[PROP_FULLSCREEN]);
 
+    /* NOTE: Nothing to refresh for while nobody is looking */
+    gt_scheduler_set_paused(main_app->scheduler,
+        (evt->new_window_state & (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN)) != 0);
+
     return GDK_EVENT_PROPAGATE;
 }
 